@@ -7,12 +7,15 @@
 // SPDX-License-Identifier: MIT
 #include "controls.hpp"
 #include <QThread>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QMetaObject>
+#include <QPointer>
 #include <QString>
 #include <QTimer>
 
 #include "../platform/integrations/vehicle-api/vapiclient.hpp"
+#include "../platform/integrations/vehicle-api/signaldispatcher.hpp"
 #include "../platform/notifications/notificationmanager.hpp"
 
 //------------------------------------------------------------------------------
@@ -33,23 +36,15 @@ namespace VehicleAPI {
 
 //------------------------------------------------------------------------------
 ControlsAsync::ControlsAsync()
-    : connectionMonitorTimer(nullptr)
-    , lastKnownConnectionState(false)
-    , reconnectionAttempts(0)
+    : lastKnownConnectionState(false)
     , subscriptionsActive(false)
-    , reconnectionTimer(nullptr)
+    , connectionListenerId(0)
+    , signalDispatcher(nullptr)
+    , currentSubscriptionId(0)
+    , targetSubscriptionId(0)
 {
     qDebug() << __func__ << __LINE__ << "  constructing ControlsAsync";
 
-    // Initialize connection monitoring
-    connectionMonitorTimer = new QTimer(this);
-    connectionMonitorTimer->setInterval(5000); // Check every 5 seconds
-    connect(connectionMonitorTimer, &QTimer::timeout, this, &ControlsAsync::checkConnectionState);
-
-    reconnectionTimer = new QTimer(this);
-    reconnectionTimer->setSingleShot(true);
-    connect(reconnectionTimer, &QTimer::timeout, this, &ControlsAsync::enableAutoReconnection);
-
     // Initialize the VAPI client instance.
     DK_VSS_VER = qgetenv("DK_VSS_VER");
 
@@ -62,185 +57,139 @@ ControlsAsync::ControlsAsync()
       VehicleAPI::V_Ca_Seat_R1_DriverSide_Position        = "Vehicle.Cabin.Seat.Row1.Pos1.Position";
     }
 
-    // 1) Build the list of signal paths we want to subscribe to:
-    std::vector<std::string> signalPaths = {
-        VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-        VehicleAPI::V_Bo_Lights_Beam_High_IsOn,
-        VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-        VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-        VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-        VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed
-    };
+    // 1) Intern the (possibly remapped) signal paths once and bind each
+    //    handle to its typed handler:
+    addSignalHandler<bool>(VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
+                           [this](bool b) { updateWidget_lightCtr_lowBeam(b); });
+    addSignalHandler<bool>(VehicleAPI::V_Bo_Lights_Beam_High_IsOn,
+                           [this](bool b) { updateWidget_lightCtr_highBeam(b); });
+    addSignalHandler<bool>(VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
+                           [this](bool b) { updateWidget_lightCtr_Hazard(b); });
+    addSignalHandler<int>(VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
+                          [this](int p) { updateWidget_seat_driverSide_position(p); });
+    addSignalHandler<int>(VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
+                          [this](int speed) { updateWidget_hvac_driverSide_FanSpeed(speed/10); });
+    addSignalHandler<int>(VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed,
+                          [this](int speed) { updateWidget_hvac_passengerSide_FanSpeed(speed/10); });
+
+    // Steppers can produce writes faster than the databroker and the CAN
+    // feeder apply them; only the newest value is sent at this rate.
+    VAPI_CLIENT.setMaxWriteRate(VehicleAPI::V_Ca_Seat_R1_DriverSide_Position, 10.0);
+    VAPI_CLIENT.setMaxWriteRate(VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed, 10.0);
+    VAPI_CLIENT.setMaxWriteRate(VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed, 10.0);
+
+    // Updates of those signals are coalesced and delivered on this thread
+    // once per frame, see SignalDispatcher.
+    signalDispatcher = new SignalDispatcher(DK_VAPI_DATABROKER, signalHandles, this);
+    connect(signalDispatcher, &SignalDispatcher::valueChanged, this,
+            [this](SignalHandle signal, int field, const SignalValue &value) {
+        Q_UNUSED(field);
+        vssSubsribeCallback(signal, value);
+    });
 
     // 2) Connect once (with those paths so the client can internally
     //    store them if it needs them for subscribeAll).
-    if (!VAPI_CLIENT.connectToServer(DK_VAPI_DATABROKER, signalPaths)) {
+    std::vector<std::string> signalPaths;
+    for (SignalHandle h : signalHandles) {
+        signalPaths.push_back(SIGNAL_REGISTRY.path(h));
+    }
+    //    The VAPIClient watcher reconnects with backoff and pushes every
+    //    connection change, including the recovery of a failed first connect;
+    //    listen first so no change is missed.
+    QPointer<ControlsAsync> self(this);
+    connectionListenerId = VAPI_CLIENT.addConnectionListener(DK_VAPI_DATABROKER, [self](bool state) {
+        // called on the VAPIClient watcher thread
+        QMetaObject::invokeMethod(self, [self, state]() {
+            if (self) self->onConnectionStateChanged(state);
+        }, Qt::QueuedConnection);
+    });
+    const bool connected = VAPI_CLIENT.connectToServer(DK_VAPI_DATABROKER, signalPaths)
+                           && VAPI_CLIENT.isConnected(DK_VAPI_DATABROKER);
+    VAPI_CLIENT.setAutoReconnect(DK_VAPI_DATABROKER, true);
+
+    // 3) Subscribe to target and current value updates of the whole path set,
+    //    connected or not: the routes exist right away (a replayed signal log
+    //    reaches the page through them). Streams that cannot be opened yet are
+    //    opened by the VAPIClient watcher once the databroker is reachable,
+    //    before it reports the connection.
+    subscribeSignals();
+
+    if (!connected) {
         qCritical() << "Could not connect to VAPI server:" << DK_VAPI_DATABROKER;
         lastKnownConnectionState = false;
         emit connectionError(QString("Failed to connect to VAPI server: %1").arg(DK_VAPI_DATABROKER));
         NOTIFY_ERROR("sdv-runtime", "Connection is not stable. User can restart via k9s (Ctrl + D > OK)");
-        // Start monitoring for reconnection
-        reconnectionTimer->start(5000); // Try to enable auto-reconnect after 5 seconds
         return;
     }
 
-    // Enable auto-reconnection on the VAPI client
-    VAPI_CLIENT.setAutoReconnect(DK_VAPI_DATABROKER, true);
     lastKnownConnectionState = true;
     emit connectionStateChanged(true);
-
-    // 3) Now subscribe to *target*‐value updates.
-    //    Our SubscribeCallback signature is:
-    //      (const std::string &path,
-    //       const std::string &value,
-    //       const int         &field)
-    //
-    //    We ignore the ‘field’ here (always target).  Because
-    //    subscribeTarget() will spawn its own thread, we must
-    //    marshal back to the Qt main thread:
-    VAPI_CLIENT.subscribeTarget(
-      DK_VAPI_DATABROKER,
-      signalPaths,
-      [this](const std::string &path,
-             const std::string &value,
-             const int         &field) {
-        Q_UNUSED(field);
-        // invoke our member function in the GUI thread:
-        QMetaObject::invokeMethod(
-          this,
-          [this, path, value]() {
-            this->vssSubsribeCallback(path, value);
-          },
-          Qt::QueuedConnection
-        );
-      }
-    );
-    VAPI_CLIENT.subscribeCurrent(
-      DK_VAPI_DATABROKER,
-      signalPaths,
-      [this](const std::string &path,
-             const std::string &value,
-             const int         &field) {
-        Q_UNUSED(field);
-        // invoke our member function in the GUI thread:
-        QMetaObject::invokeMethod(
-          this,
-          [this, path, value]() {
-            this->vssSubsribeCallback(path, value);
-          },
-          Qt::QueuedConnection
-        );
-      }
-    );
     subscriptionsActive = true;
-
-    // Start connection monitoring after subscriptions are set up
-    connectionMonitorTimer->start();
 }
 
 void ControlsAsync::init()
 {
-    // Give the subscription threads a moment to spin up.
-    QThread::msleep(300);
-
-    // Use the templated getTargetValueAs<T>() so we don't
-    // have to do manual stoi/string compares:
-    bool b     = false;
-    int  i_val = 0;
-
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-          b)) {
-      updateWidget_lightCtr_lowBeam(b);
-    }
-    
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Beam_High_IsOn,
-          b)) {
-      updateWidget_lightCtr_highBeam(b);
-    }
-
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-          b)) {
-      updateWidget_lightCtr_Hazard(b);
-    }
-
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-          i_val)) {
-      updateWidget_seat_driverSide_position(i_val);
+    // Fetch current and target state of every control off the GUI thread;
+    // the widgets are updated through the usual handlers on completion.
+    if (signalDispatcher) {
+        signalDispatcher->requestSnapshot();
     }
+}
 
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-          i_val)) {
-      int speed = (i_val)/10;
-      updateWidget_hvac_driverSide_FanSpeed(speed);
+template<typename T>
+void ControlsAsync::addSignalHandler(const std::string &path, std::function<void(T)> handler)
+{
+    SignalHandle signal = SIGNAL_REGISTRY.intern(path);
+    if (signal == INVALID_SIGNAL) {
+        qWarning() << "Cannot register signal" << QString::fromStdString(path);
+        return;
     }
 
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed,
-          i_val)) {
-      int speed = (i_val)/10;
-      updateWidget_hvac_passengerSide_FanSpeed(speed);
+    signalHandles.push_back(signal);
+    if (signalHandlers.size() <= signal) {
+        signalHandlers.resize(signal + 1);
     }
+    signalHandlers[signal] = [handler](const SignalValue &value) {
+        T typed{};
+        if (SignalCache::convert(value, typed)) {
+            handler(typed);
+        }
+    };
 }
 
-void ControlsAsync::vssSubsribeCallback(const std::string &path,
-                                        const std::string &value)
+void ControlsAsync::vssSubsribeCallback(SignalHandle signal,
+                                        const SignalValue &value)
 {
-    qDebug() << "[SubsCB]" 
-             << QString::fromStdString(path)
-             << "->" 
-             << QString::fromStdString(value);
-
-    // Mirror exactly what you had before, but now
-    // you're assured this runs on the Qt main thread:
-
-    if (path == VehicleAPI::V_Bo_Lights_Beam_Low_IsOn) {
-      bool b = (value == "true");
-      updateWidget_lightCtr_lowBeam(b);
-    }
-    if (path == VehicleAPI::V_Bo_Lights_Beam_High_IsOn) {
-      bool b = (value == "true");
-      updateWidget_lightCtr_highBeam(b);
-    }
-    else if (path == VehicleAPI::V_Bo_Lights_Hazard_IsSignaling) {
-      bool b = (value == "true");
-      updateWidget_lightCtr_Hazard(b);
-    }
-    else if (path == VehicleAPI::V_Ca_Seat_R1_DriverSide_Position) {
-      try {
-        int p = std::stoi(value);
-        updateWidget_seat_driverSide_position(p);
-      }
-      catch (...) { /* ignore parse errors */ }
-    }
-    else if (path == VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed) {
-      try {
-        int speed = std::stoi(value)/10;
-        updateWidget_hvac_driverSide_FanSpeed(speed);
-      }
-      catch (...) { }
-    }
-    else if (path == VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed) {
-      try {
-        int speed = std::stoi(value)/10;
-        updateWidget_hvac_passengerSide_FanSpeed(speed);
-      }
-      catch (...) { }
+    // Runs on the Qt main thread with the latest value of a changed
+    // signal; values superseded within the same frame never get here.
+    if (signal < signalHandlers.size() && signalHandlers[signal]) {
+        signalHandlers[signal](value);
     }
 }
 
-// QML‐invokable slots also make use of the templated get…As<T>() and
-// setCurrent/TargetValue<T>() to simplify:
+// QML‐invokable slots write current and target value as one batch on the
+// VAPIClient writer thread, so the GUI thread never blocks on gRPC. A write
+// is not read back: the target subscription confirms it through
+// vssSubsribeCallback().
+
+std::function<void(bool)> ControlsAsync::writeCompletion(const QString &what)
+{
+    // called on the VAPIClient writer thread, possibly after this page is gone:
+    // shutdown detaches a writer that is still busy
+    QPointer<ControlsAsync> self(this);
+    return [self, what](bool ok) {
+        if (ok) {
+            return;
+        }
+        QMetaObject::invokeMethod(qApp, [self, what]() {
+            if (!self) {
+                return;
+            }
+            qWarning() << "Failed to set" << what;
+            emit self->connectionError(QString("Failed to set vehicle data: %1").arg(what));
+        }, Qt::QueuedConnection);
+    };
+}
 
 void ControlsAsync::qml_setApi_lightCtr_LowBeam(bool sts)
 {
@@ -253,23 +202,9 @@ void ControlsAsync::qml_setApi_lightCtr_LowBeam(bool sts)
         return;
     }
 
-    VAPI_CLIENT.setCurrentValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-      sts);
-    VAPI_CLIENT.setTargetValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-      sts);
-
-    // verify
-    bool newSts = false;
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-          newSts)) {
-      qDebug() << "Verified LowBeam =" << newSts;
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<bool>(VehicleAPI::V_Bo_Lights_Beam_Low_IsOn, sts);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("LowBeam"));
 }
 
 void ControlsAsync::qml_setApi_lightCtr_HighBeam(bool sts)
@@ -283,20 +218,9 @@ void ControlsAsync::qml_setApi_lightCtr_HighBeam(bool sts)
         return;
     }
 
-    VAPI_CLIENT.setCurrentValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Beam_High_IsOn, sts);
-    VAPI_CLIENT.setTargetValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Beam_High_IsOn, sts);
-
-    bool newSts = false;
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Beam_High_IsOn,
-          newSts)) {
-      qDebug() << "Verified HighBeam =" << newSts;
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<bool>(VehicleAPI::V_Bo_Lights_Beam_High_IsOn, sts);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("HighBeam"));
 }
 
 void ControlsAsync::qml_setApi_lightCtr_Hazard(bool sts)
@@ -310,22 +234,9 @@ void ControlsAsync::qml_setApi_lightCtr_Hazard(bool sts)
         return;
     }
 
-    VAPI_CLIENT.setCurrentValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-      sts);
-    VAPI_CLIENT.setTargetValue<bool>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-      sts);
-
-    bool newSts = false;
-    if (VAPI_CLIENT.getTargetValueAs<bool>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-          newSts)) {
-      qDebug() << "Verified Hazard =" << newSts;
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<bool>(VehicleAPI::V_Bo_Lights_Hazard_IsSignaling, sts);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("Hazard"));
 }
 
 void ControlsAsync::qml_setApi_seat_driverSide_position(int position)
@@ -345,22 +256,9 @@ void ControlsAsync::qml_setApi_seat_driverSide_position(int position)
     qDebug() << "QML → set SeatPos =" << position;
     uint8_t p = static_cast<uint8_t>(position);
 
-    VAPI_CLIENT.setCurrentValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-      p);
-    VAPI_CLIENT.setTargetValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-      p);
-
-    int newPos = 0;
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-          newPos)) {
-      qDebug() << "Verified SeatPos =" << newPos;
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<uint8_t>(VehicleAPI::V_Ca_Seat_R1_DriverSide_Position, p);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("SeatPos"));
 }
 
 void ControlsAsync::qml_setApi_hvac_driverSide_FanSpeed(uint8_t speed)
@@ -374,22 +272,9 @@ void ControlsAsync::qml_setApi_hvac_driverSide_FanSpeed(uint8_t speed)
 
     uint8_t scaledSpeed = speed * 10;
     qDebug() << "QML → set DriverFanSpeed =" << speed << "(scaled" << scaledSpeed << ")";
-    VAPI_CLIENT.setCurrentValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-      scaledSpeed);
-    VAPI_CLIENT.setTargetValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-      scaledSpeed);
-
-    int newSpeed = 0;
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-          newSpeed)) {
-      qDebug() << "Verified DriverFanSpeed =" << (newSpeed);
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<uint8_t>(VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed, scaledSpeed);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("DriverFanSpeed"));
 }
 
 void ControlsAsync::qml_setApi_hvac_passengerSide_FanSpeed(uint8_t speed)
@@ -403,22 +288,9 @@ void ControlsAsync::qml_setApi_hvac_passengerSide_FanSpeed(uint8_t speed)
 
     uint8_t scaledSpeed = speed * 10;
     qDebug() << "QML → set PassengerFanSpeed =" << speed << "(scaled" << scaledSpeed << ")";
-    VAPI_CLIENT.setCurrentValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed,
-      scaledSpeed);
-    VAPI_CLIENT.setTargetValue<uint8_t>(
-      DK_VAPI_DATABROKER,
-      VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed,
-      scaledSpeed);
-
-    int newSpeed = 0;
-    if (VAPI_CLIENT.getTargetValueAs<int>(
-          DK_VAPI_DATABROKER,
-          VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed,
-          newSpeed)) {
-      qDebug() << "Verified PassengerFanSpeed =" << (newSpeed);
-    }
+    VAPIClient::WriteBatch batch;
+    batch.set<uint8_t>(VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed, scaledSpeed);
+    VAPI_CLIENT.setValuesAsync(DK_VAPI_DATABROKER, std::move(batch), writeCompletion("PassengerFanSpeed"));
 }
 
 ControlsAsync::~ControlsAsync()
@@ -426,12 +298,12 @@ ControlsAsync::~ControlsAsync()
     qDebug() << __func__ << __LINE__ << "  destroying ControlsAsync";
 
     // Stop connection monitoring
-    if (connectionMonitorTimer) {
-        connectionMonitorTimer->stop();
-    }
-    if (reconnectionTimer) {
-        reconnectionTimer->stop();
-    }
+    VAPI_CLIENT.removeConnectionListener(connectionListenerId);
+
+    // No new stream updates; one already in flight only reaches the
+    // dispatcher's shared state, which outlives it.
+    VAPI_CLIENT.unsubscribe(targetSubscriptionId);
+    VAPI_CLIENT.unsubscribe(currentSubscriptionId);
 
     // Use async shutdown to prevent blocking Qt application termination
     // This detaches subscription threads immediately without waiting for them to join
@@ -446,10 +318,8 @@ ControlsAsync::~ControlsAsync()
 // Connection monitoring and management methods
 //------------------------------------------------------------------------------
 
-void ControlsAsync::checkConnectionState()
+void ControlsAsync::onConnectionStateChanged(bool currentState)
 {
-    bool currentState = VAPI_CLIENT.isConnected(DK_VAPI_DATABROKER);
-
     if (currentState != lastKnownConnectionState) {
         qDebug() << "Connection state changed:" << currentState;
         lastKnownConnectionState = currentState;
@@ -467,100 +337,49 @@ void ControlsAsync::handleConnectionLost()
 {
     qWarning() << "Connection to VAPI server lost";
     subscriptionsActive = false;
-    reconnectionAttempts = 0;
     emit connectionError("Connection to VAPI server lost");
     NOTIFY_WARNING("sdv-runtime", "Connection is not stable. User can restart via k9s (Ctrl + D > OK)");
 
-    // Start attempting reconnection
-    enableAutoReconnection();
+    // The VAPIClient watcher is already retrying with backoff
 }
 
 void ControlsAsync::handleConnectionRestored()
 {
-    qInfo() << "Connection to VAPI server restored";
-    reconnectionAttempts = 0;
+    VAPIClient::ConnectionStats stats = VAPI_CLIENT.connectionStats(DK_VAPI_DATABROKER);
+    qInfo() << "Connection to VAPI server restored after" << stats.lastRecoveryMs << "ms";
 
-    // Re-establish subscriptions after a short delay to ensure connection is stable
-    QTimer::singleShot(1000, this, &ControlsAsync::reestablishSubscriptions);
+    reestablishSubscriptions();
 }
 
 void ControlsAsync::reestablishSubscriptions()
 {
     qInfo() << "Re-establishing subscriptions";
 
-    // Build the list of signal paths we want to subscribe to
-    std::vector<std::string> signalPaths = {
-        VehicleAPI::V_Bo_Lights_Beam_Low_IsOn,
-        VehicleAPI::V_Bo_Lights_Beam_High_IsOn,
-        VehicleAPI::V_Bo_Lights_Hazard_IsSignaling,
-        VehicleAPI::V_Ca_Seat_R1_DriverSide_Position,
-        VehicleAPI::V_Ca_HVAC_Station_R1_Driver_FanSpeed,
-        VehicleAPI::V_Ca_HVAC_Station_R1_Passenger_FanSpeed
-    };
-
-    // Re-subscribe to target values
-    VAPI_CLIENT.subscribeTarget(
-      DK_VAPI_DATABROKER,
-      signalPaths,
-      [this](const std::string &path,
-             const std::string &value,
-             const int         &field) {
-        Q_UNUSED(field);
-        // invoke our member function in the GUI thread:
-        QMetaObject::invokeMethod(
-          this,
-          [this, path, value]() {
-            this->vssSubsribeCallback(path, value);
-          },
-          Qt::QueuedConnection
-        );
-      }
-    );
-
-    // Re-subscribe to current values
-    VAPI_CLIENT.subscribeCurrent(
-      DK_VAPI_DATABROKER,
-      signalPaths,
-      [this](const std::string &path,
-             const std::string &value,
-             const int         &field) {
-        Q_UNUSED(field);
-        // invoke our member function in the GUI thread:
-        QMetaObject::invokeMethod(
-          this,
-          [this, path, value]() {
-            this->vssSubsribeCallback(path, value);
-          },
-          Qt::QueuedConnection
-        );
-      }
-    );
+    // KuksaClient restores its streams after a reconnect and the VAPIClient
+    // watcher has opened those that failed before, so this only subscribes
+    // what was never subscribed (e.g. no client could be created).
+    subscribeSignals();
 
     subscriptionsActive = true;
     emit subscriptionsRestored();
 
-    // Refresh current values after re-subscription
-    QTimer::singleShot(500, this, &ControlsAsync::init);
+    // Refresh all controls with one snapshot
+    init();
 }
 
-void ControlsAsync::enableAutoReconnection()
+void ControlsAsync::subscribeSignals()
 {
-    if (!VAPI_CLIENT.isConnected(DK_VAPI_DATABROKER)) {
-        reconnectionAttempts++;
-        qInfo() << "Attempting reconnection #" << reconnectionAttempts;
-        emit reconnectionAttempt(reconnectionAttempts);
-
-        // Enable auto-reconnection on the VAPI client
-        VAPI_CLIENT.setAutoReconnect(DK_VAPI_DATABROKER, true);
-
-        // Try forcing a reconnection
-        bool reconnected = VAPI_CLIENT.forceReconnect(DK_VAPI_DATABROKER);
-        if (!reconnected) {
-            // If reconnection failed, try again after exponential backoff
-            int delay = std::min(1000 * (1 << std::min(reconnectionAttempts - 1, 6)), 30000); // Max 30 seconds
-            qDebug() << "Reconnection failed, retrying in" << delay << "ms";
-            reconnectionTimer->start(delay);
-        }
+    // Stream updates only mark the signal dirty in the dispatcher; the
+    // value itself is read from the VAPIClient cache on the Qt main thread.
+    if (!targetSubscriptionId) {
+        targetSubscriptionId = VAPI_CLIENT.subscribe(
+          DK_VAPI_DATABROKER, signalHandles, KuksaClient::FT_ACTUATOR_TARGET,
+          signalDispatcher->callback());
+    }
+    if (!currentSubscriptionId) {
+        currentSubscriptionId = VAPI_CLIENT.subscribe(
+          DK_VAPI_DATABROKER, signalHandles, KuksaClient::FT_VALUE,
+          signalDispatcher->callback());
     }
 }
 
@@ -576,11 +395,14 @@ bool ControlsAsync::isConnected() const
 void ControlsAsync::forceReconnect()
 {
     qInfo() << "QML requested force reconnection";
-    reconnectionAttempts = 0;
-    enableAutoReconnection();
+    if (VAPI_CLIENT.isConnected(DK_VAPI_DATABROKER)) {
+        return;
+    }
+    emit reconnectionAttempt(getReconnectionAttempts() + 1);
+    VAPI_CLIENT.requestReconnect(DK_VAPI_DATABROKER);
 }
 
 int ControlsAsync::getReconnectionAttempts() const
 {
-    return reconnectionAttempts;
+    return static_cast<int>(VAPI_CLIENT.connectionStats(DK_VAPI_DATABROKER).pendingAttempts);
 }
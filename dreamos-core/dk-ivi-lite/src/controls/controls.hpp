@@ -18,6 +18,13 @@
 #include <QTimer>
 #include <QMap>
 #include "QVariant"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../platform/integrations/vehicle-api/signalcache.hpp"
+
+class SignalDispatcher;
 
 class ControlsAsync: public QObject
 {
@@ -42,7 +49,7 @@ public:
     Q_INVOKABLE void forceReconnect();
     Q_INVOKABLE int getReconnectionAttempts() const;
 
-    void vssSubsribeCallback(const std::string &updatePath, const std::string &updateValue); 
+    void vssSubsribeCallback(SignalHandle signal, const SignalValue &value);
 
 Q_SIGNALS:
     // Lighting signals
@@ -62,19 +69,26 @@ Q_SIGNALS:
     void subscriptionsRestored();
 
 private:
-    // Connection monitoring members
-    QTimer *connectionMonitorTimer;
+    // Connection state, pushed by the VAPIClient connection watcher
     bool lastKnownConnectionState;
-    int reconnectionAttempts;
     bool subscriptionsActive;
-    QTimer *reconnectionTimer;
+    std::uint64_t connectionListenerId;
+    SignalDispatcher *signalDispatcher;
+    // subscribed signals and their handlers, indexed by signal handle
+    std::vector<SignalHandle> signalHandles;
+    std::vector<std::function<void(const SignalValue &)>> signalHandlers;
+    std::uint64_t currentSubscriptionId;
+    std::uint64_t targetSubscriptionId;
 
     // Internal methods for connection management
-    void checkConnectionState();
+    void onConnectionStateChanged(bool connected);
     void handleConnectionLost();
     void handleConnectionRestored();
     void reestablishSubscriptions();
-    void enableAutoReconnection();
+    void subscribeSignals();
+    std::function<void(bool)> writeCompletion(const QString &what);
+    template<typename T>
+    void addSignalHandler(const std::string &path, std::function<void(T)> handler);
 };
 
 #endif // CONTROLPAGE_H
\ No newline at end of file
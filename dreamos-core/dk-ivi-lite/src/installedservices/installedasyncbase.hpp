@@ -12,12 +12,15 @@
 #include <QEventLoop>
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QPointer>
 #include <QMutex>
 #include <QStandardPaths>
 
 #include "../platform/async/asyncjob.hpp"
+#include "../platform/async/coro.hpp"
 #include "../platform/data/datamanager.hpp"
 #include "../platform/notifications/notificationmanager.hpp"
+#include "../platform/integrations/kubernetes/informer.hpp"
 #include "../platform/integrations/kubernetes/jobmanager.hpp"
 #include "../platform/monitoring/wlanmonitor.hpp"
 #include "../platform/monitoring/autorestartmanager.hpp"
@@ -129,7 +132,9 @@ private:
     
     // Enhanced status caching system
     void initializeStatusCaching();
-    void updateDeploymentStatusCache();
+    Async::Task<> updateDeploymentStatusCache();
+    void onDeploymentStatusChanged(const QString &id, bool available);
+    void onNodeReadinessChanged(bool ready);
     void applyStatusUpdatesToUI();
     void invalidateStatusCache();
     void triggerStatusUpdateIfNeeded();
@@ -206,6 +211,10 @@ InstalledAsyncBase<TI,TD>::InstalledAsyncBase(QObject *parent)
             this, &InstalledAsyncBase::onJobFinished);
     connect(m_jobManager, &K3s::JobManager::stateChanged,
             this, &InstalledAsyncBase::onJobManagerStateChanged);
+    connect(m_jobManager, &K3s::JobManager::deploymentStatusChanged,
+            this, [this](const QString &id, bool available) {
+        onDeploymentStatusChanged(id, available);
+    });
 
     // Initialize optimized file monitoring timer
     m_fileHashTimer = new QTimer(this);
@@ -275,7 +284,19 @@ void InstalledAsyncBase<TI,TD>::initializeMonitoring()
         auto *nodeTimer = new QTimer(this);
         nodeTimer->setSingleShot(false);
         
+        // Pushed by the node watch; the timer only polls while it is down
+        connect(m_jobManager, &K3s::JobManager::nodeStatusChanged,
+                this, [this](const QString &nodeName, bool ready) {
+            if (nodeName == "vip") {
+                onNodeReadinessChanged(ready);
+            }
+        });
+        
         connect(nodeTimer, &QTimer::timeout, this, [this]() {
+            if (K3s::Informer::instance()->isSynced(K3s::Kind::Node)) {
+                return;
+            }
+            
             // Skip if a check is already in progress or JobManager is busy
             if (m_nodeCheckInProgress || m_jobManager->isBusy()) {
                 return;
@@ -293,19 +314,7 @@ void InstalledAsyncBase<TI,TD>::initializeMonitoring()
             auto *job = m_jobManager->checkNodeReady("vip", 3);
             
             connect(job, &Async::JobBase::finished, this, [this, job](bool success) {
-                bool ready = success ? job->result() : false;
-                
-                if (ready != m_nodeOnline) {
-                    qDebug() << "[InstalledAsyncBase] Node status changed:" << m_nodeOnline << "->" << ready;
-                    m_nodeOnline = ready;
-                    onNodeStatusChanged(ready);
-                    
-                    // Only trigger status update if node comes online
-                    if (ready) {
-                        QTimer::singleShot(2000, this, &InstalledAsyncBase::performCachedStatusUpdate);
-                    }
-                }
-                
+                onNodeReadinessChanged(success ? job->result() : false);
                 m_nodeCheckInProgress = false;
                 job->deleteLater();
             });
@@ -539,7 +548,7 @@ void InstalledAsyncBase<TI,TD>::onFileHashChanged()
                 QThread::msleep(200);
                 DataManager dm; 
                 return dm.load(dbKey());
-            }, this);
+            }, Async::RunOptions{ Async::Pool::Cpu, Async::Priority::Interactive }, this);
             
             connect(job, &Async::JobBase::finished, this, [this, job](bool success) {
                 if (success) {
@@ -602,87 +611,150 @@ void InstalledAsyncBase<TI,TD>::performCachedStatusUpdate()
     m_statusUpdateInProgress = true;
     
     // Use JobManager for deployment status checks
-    auto *job = new Async::Job<void>([this]() -> bool {
-        this->updateDeploymentStatusCache();
-        return true;
-    }, this);
-    
-    connect(job, &Async::JobBase::finished, this, [this, job](bool success) {
+    updateDeploymentStatusCache().then(this, [this](bool success) {
         if (success) {
             applyStatusUpdatesToUI();
             NOTIFY_SUCCESS("Service Status", "Vehical App/Service page reloaded successfully");
         }
         m_statusUpdateInProgress = false;
-        job->deleteLater();
     });
 }
 
 /* ------------ Update deployment status cache ----------------- */
+/*  A coroutine on the GUI thread: all checks are queued on the pool
+ *  at once and awaited in turn. The cache lock is never held across
+ *  a co_await.                                                       */
 template<class TI,class TD>
-void InstalledAsyncBase<TI,TD>::updateDeploymentStatusCache()
+Async::Task<> InstalledAsyncBase<TI,TD>::updateDeploymentStatusCache()
 {
-    QMutexLocker locker(&m_cacheMutex);
-    QDateTime now = QDateTime::currentDateTime();
-    
-    for (const auto &item : m_items) {
-        if (!m_deploymentStatusCache.contains(item.id)) {
-            m_deploymentStatusCache[item.id] = DeploymentStatus(item.id);
-        }
-        
-        DeploymentStatus &status = m_deploymentStatusCache[item.id];
-        
-        // Skip if cache is still valid
-        if (status.isCacheValid(CACHE_VALIDITY_DURATION)) {
-            continue;
+    // The informer's copy is current: read it instead of asking the API
+    K3s::Informer *informer = K3s::Informer::instance();
+    if (informer->isSynced(K3s::Kind::Deployment)) {
+        QMutexLocker locker(&m_cacheMutex);
+        const QDateTime now = QDateTime::currentDateTime();
+        for (const auto &item : m_items) {
+            const auto deployment = informer->get(K3s::Kind::Deployment, item.id);
+            DeploymentStatus &status = m_deploymentStatusCache[item.id];
+            status.id = item.id;
+            status.isRunning = deployment && K3s::KubeClient::deploymentAvailable(*deployment);
+            status.lastChecked = now;
+            status.hasValidCache = true;
+            status.consecutiveFailures = 0;
         }
+        co_return;
+    }
+    
+    QPointer<QObject> self(this);
+    QList<QPair<QString, Async::Job<bool>*>> checks;
+    
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        QDateTime now = QDateTime::currentDateTime();
         
-        // Skip if we've had too many consecutive failures
-        if (status.consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
-            if (status.lastChecked.isValid() && 
-                status.lastChecked.msecsTo(now) < 60000) {
-                continue;
+        for (const auto &item : m_items) {
+            if (!m_deploymentStatusCache.contains(item.id)) {
+                m_deploymentStatusCache[item.id] = DeploymentStatus(item.id);
             }
-        }
-        
-        // Use JobManager for status check (lightweight operation)
-        bool isRunning = false;
-        try {
-            // Create temporary event loop for synchronous check
-            auto *checkJob = m_jobManager->checkDeploymentAvailable(item.id, 5);
-            QEventLoop loop;
-            
-            connect(checkJob, &Async::JobBase::finished, &loop, [&](bool success) {
-                if (success) {
-                    isRunning = checkJob->result();
-                }
-                loop.quit();
-            });
             
-            loop.exec();
-            checkJob->deleteLater();
+            const DeploymentStatus &status = m_deploymentStatusCache[item.id];
             
-            // Update cache
-            bool statusChanged = (status.isRunning != isRunning);
-            if (statusChanged) {
-                status.lastStatusChange = now;
-                qDebug() << "[InstalledAsyncBase] Status changed for" << item.id 
-                         << ":" << status.isRunning << "->" << isRunning;
+            // Skip if cache is still valid
+            if (status.isCacheValid(CACHE_VALIDITY_DURATION)) {
+                continue;
             }
             
-            status.isRunning = isRunning;
-            status.lastChecked = now;
-            status.hasValidCache = true;
-            status.consecutiveFailures = 0;
+            // Skip if we've had too many consecutive failures
+            if (status.consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
+                if (status.lastChecked.isValid() && 
+                    status.lastChecked.msecsTo(now) < 60000) {
+                    continue;
+                }
+            }
             
-        } catch (const std::exception &e) {
-            qWarning() << "[InstalledAsyncBase] Exception checking status for" 
-                       << item.id << ":" << e.what();
+            // Use JobManager for status check (lightweight operation)
+            checks << qMakePair(item.id, m_jobManager->checkDeploymentAvailable(item.id, 5));
+        }
+    }
+    
+    for (const auto &check : checks) {
+        const std::optional<bool> available = co_await Async::finished(check.second);
+        check.second->deleteLater();
+        if (!self) {
+            continue;       // page is gone, only clean up the jobs
+        }
+        
+        QMutexLocker locker(&m_cacheMutex);
+        DeploymentStatus &status = m_deploymentStatusCache[check.first];
+        status.id = check.first;
+        const QDateTime now = QDateTime::currentDateTime();
+        
+        if (!available) {
+            qWarning() << "[InstalledAsyncBase] Status check failed for" << check.first;
             status.consecutiveFailures++;
             status.lastChecked = now;
             status.hasValidCache = false;
+            continue;
         }
         
-        QThread::msleep(100); // Brief pause between checks
+        // Update cache
+        const bool isRunning = *available;
+        bool statusChanged = (status.isRunning != isRunning);
+        if (statusChanged) {
+            status.lastStatusChange = now;
+            qDebug() << "[InstalledAsyncBase] Status changed for" << check.first 
+                     << ":" << status.isRunning << "->" << isRunning;
+        }
+        
+        status.isRunning = isRunning;
+        status.lastChecked = now;
+        status.hasValidCache = true;
+        status.consecutiveFailures = 0;
+    }
+}
+
+/* ------------ Deltas from the informer ------------------------ */
+/*  Only the changed item is updated, no reload of the whole page.  */
+template<class TI,class TD>
+void InstalledAsyncBase<TI,TD>::onDeploymentStatusChanged(const QString &id, bool available)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (m_items[i].id != id) {
+            continue;
+        }
+        
+        DeploymentStatus &status = m_deploymentStatusCache[id];
+        const QDateTime now = QDateTime::currentDateTime();
+        if (status.isRunning != available) {
+            status.lastStatusChange = now;
+            qDebug() << "[InstalledAsyncBase] Status changed for" << id
+                     << ":" << status.isRunning << "->" << available;
+        }
+        status.id = id;
+        status.isRunning = available;
+        status.lastChecked = now;
+        status.hasValidCache = true;
+        status.consecutiveFailures = 0;
+        
+        static_cast<TD*>(this)->updateServicesRunningSts(id, available, i);
+        return;
+    }
+}
+
+template<class TI,class TD>
+void InstalledAsyncBase<TI,TD>::onNodeReadinessChanged(bool ready)
+{
+    if (ready == m_nodeOnline) {
+        return;
+    }
+    
+    qDebug() << "[InstalledAsyncBase] Node status changed:" << m_nodeOnline << "->" << ready;
+    m_nodeOnline = ready;
+    onNodeStatusChanged(ready);
+    
+    // Only trigger status update if node comes online
+    if (ready) {
+        QTimer::singleShot(2000, this, &InstalledAsyncBase::performCachedStatusUpdate);
     }
 }
 
@@ -740,13 +812,7 @@ bool InstalledAsyncBase<TI,TD>::canPerformOperation(const QString &operation) co
         }
     }
     
-    // Then check JobManager state
-    if (m_jobManager->isBusy()) {
-        QString reason = QString("System busy: %1").arg(m_jobManager->currentOperation());
-        NOTIFY_WARNING("Service Status", reason);
-        return false;
-    }
-    
+    // JobManager queues deploy/remove behind whatever else it is running
     return true;
 }
 
@@ -993,7 +1059,7 @@ void InstalledAsyncBase<TI,TD>::removeServices(int idx)
                         qWarning() << "[InstalledAsyncBase] DB update failed:" << e.what();
                         return false;
                     }
-                }, this);
+                }, Async::RunOptions{ Async::Pool::Cpu, Async::Priority::Normal }, this);
                 
                 connect(dbUpdateJob, &Async::JobBase::finished, this, [this, id, dbUpdateJob, operation](bool dbSuccess) {
                     if (dbSuccess) {
@@ -15,7 +15,9 @@
 #include "../installedvapps/installedvapps.hpp"
 #include "../controls/controls.hpp"
 #include "../platform/integrations/vehicle-api/vapiclient.hpp"
+#include "../platform/integrations/vehicle-api/vsssignalmodel.hpp"
 #include "../platform/notifications/notificationmanager.hpp"
+#include "../platform/integrations/kubernetes/jobmanager.hpp"
 
 #include <QCoreApplication>
 #include <QDateTime>
@@ -55,6 +57,12 @@ int main(int argc, char *argv[])
 
     // VAPI Client Initialization
     VAPI_CLIENT.connectToServer(DK_VAPI_DATABROKER);
+
+    // DK_VAPI_RECORD=<file> records the signal traffic of the session
+    const QString recordFile = qEnvironmentVariable("DK_VAPI_RECORD");
+    if (!recordFile.isEmpty()) {
+        VAPI_CLIENT.startRecording(recordFile.toStdString());
+    }
     
     // Register the notification manager BEFORE creating the engine
     qmlRegisterSingletonType<NotificationManager>("NotificationManager", 1, 0, "NotificationManager",
@@ -64,6 +72,16 @@ int main(int argc, char *argv[])
             return &NotificationManager::instance();
         });
 
+    // Operation queue (positions, ETAs) for the install and service pages
+    qmlRegisterSingletonType<K3s::JobManager>("JobManager", 1, 0, "JobManager",
+        [](QQmlEngine *engine, QJSEngine *scriptEngine) -> QObject* {
+            Q_UNUSED(engine)
+            Q_UNUSED(scriptEngine)
+            K3s::JobManager *manager = K3s::JobManager::instance();
+            QJSEngine::setObjectOwnership(manager, QJSEngine::CppOwnership);
+            return manager;
+        });
+
     // Pages
     qmlRegisterType<DigitalAutoAppAsync>("DigitalAutoAppAsync", 1, 0, "DigitalAutoAppAsync");
     qmlRegisterType<CategoryListModel>("MyApp",1,0,"CategoryListModel");
@@ -74,6 +92,9 @@ int main(int argc, char *argv[])
     qmlRegisterType<VappsAsync>("VappsAsync", 1, 0, "VappsAsync");
     qmlRegisterType<ControlsAsync>("ControlsAsync", 1, 0, "ControlsAsync");
 
+    // Generic VSS signal binding for pages
+    qmlRegisterType<VssSignalModel>("VssSignalModel", 1, 0, "VssSignalModel");
+
     QQmlApplicationEngine engine;
     
     // Expose global notification manager instance to QML context
@@ -103,5 +124,15 @@ int main(int argc, char *argv[])
 
     engine.load(url1);
 
+    // Replay a signal log into the pages, e.g. to reproduce field issues:
+    //   DK_VAPI_REPLAY=<file> [DK_VAPI_REPLAY_SPEED=<factor, 0 = max>]
+    SignalReplayer replayer;
+    const QString replayFile = qEnvironmentVariable("DK_VAPI_REPLAY");
+    if (!replayFile.isEmpty() && replayer.open(replayFile.toStdString())) {
+        bool ok = false;
+        double speed = qEnvironmentVariable("DK_VAPI_REPLAY_SPEED").toDouble(&ok);
+        replayer.start(DK_VAPI_DATABROKER, ok ? speed : 1.0);
+    }
+
     return app.exec();
 }
\ No newline at end of file
@@ -7,6 +7,9 @@
 // SPDX-License-Identifier: MIT
 #include "marketplace.hpp"
 #include "../platform/notifications/notificationmanager.hpp"
+#include "../platform/integrations/kubernetes/imagecache.hpp"
+#include "../platform/integrations/kubernetes/pullprogress.hpp"
+#include <mutex>
 
 using namespace Async;
 using K3s::ManifestBuilder;
@@ -155,6 +158,14 @@ InstallationWorker::InstallationWorker(QObject *parent)
     : QObject(parent)
     , m_jobManager(JobManager::instance())
 {
+    // Step starts and job/pod state changes of our installs
+    connect(m_jobManager, &JobManager::installProgress,
+            this, [this](const QString &appId, const QString &message) {
+        if (m_activeApps.contains(appId)) {
+            emit installationProgress(appId, message);
+        }
+    });
+    
     qDebug() << "[InstallationWorker] Using centralized JobManager";
 }
 
@@ -167,11 +178,7 @@ void InstallationWorker::startInstallation(const AppInfo &app, const QString &ca
 {
     qDebug() << "[InstallationWorker] Starting installation for:" << app.name;
     
-    // Store installation info
-    m_currentApp = app;
-    m_currentCategory = category;
-    
-    emit installationProgress("Preparing installation...");
+    emit installationProgress(app.id, "Preparing installation...");
     
     // Create installation request
     JobManager::InstallationRequest request;
@@ -181,131 +188,190 @@ void InstallationWorker::startInstallation(const AppInfo &app, const QString &ca
     
     try {
         // Prepare manifest
-        emit installationProgress("Creating deployment manifest...");
+        emit installationProgress(app.id, "Creating deployment manifest...");
         K3s::ManifestInfo manifest = K3s::ManifestBuilder::write(app);
+        request.node = manifest.deployNodeName;
         
-        // Build installation commands
-        request.commands = buildInstallationCommands(app, manifest);
+        // Build installation steps
+        request.steps = buildInstallationSteps(app, manifest);
         
-        if (request.commands.isEmpty()) {
+        if (request.steps.isEmpty()) {
             emit installationFailed(app.id, "No installation commands generated");
             return;
         }
         
-        // Submit to JobManager
+        // Submit to JobManager, which queues it behind busy nodes
+        m_activeApps.insert(app.id);
         auto *job = m_jobManager->installApplication(request);
         
         connect(job, &Async::JobBase::finished, this, [=](bool jobSuccess) {
+            m_activeApps.remove(app.id);
+            
             // jobSuccess indicates if the async job completed without crashing
             // We also need to check the actual result
             if (jobSuccess) {
                 JobManager::JobResult result = job->result();
                 if (result.success) {
-                    qDebug() << "[InstallationWorker] Installation completed successfully for" << m_currentApp.id;
-                    this->updateInstallationRecord(m_currentApp, m_currentCategory);
-                    emit installationCompleted(m_currentApp.id);
+                    qDebug() << "[InstallationWorker] Installation completed successfully for" << app.id;
+                    this->updateInstallationRecord(app, category);
+                    emit installationCompleted(app.id);
                 } else {
                     qWarning() << "[InstallationWorker] Installation failed:" << result.errorMessage;
                     qWarning() << "[InstallationWorker] Command output:" << result.output;
-                    emit installationFailed(m_currentApp.id, result.errorMessage);
+                    emit installationFailed(app.id, result.errorMessage);
                 }
             } else {
                 qCritical() << "[InstallationWorker] Installation job crashed or failed to execute";
-                emit installationFailed(m_currentApp.id, "Installation job execution failed");
+                emit installationFailed(app.id, "Installation job execution failed");
             }
             job->deleteLater();
         });
         
     } catch (const std::exception &e) {
+        m_activeApps.remove(app.id);
         emit installationFailed(app.id, QString("Exception: %1").arg(e.what()));
     }
 }
 
-void InstallationWorker::cancelInstallation()
+bool InstallationWorker::cancelInstallation(const QString &appId)
 {
-    // JobManager doesn't support cancellation yet, but we can emit failure
-    emit installationFailed(m_currentApp.id, "Installation cancelled by user");
+    // a started installation runs to its end; its job reports the cancel
+    return m_jobManager->cancelQueued(appId);
 }
 
-QStringList InstallationWorker::buildInstallationCommands(const AppInfo &app, const K3s::ManifestInfo &manifest)
+QList<JobManager::InstallStep> InstallationWorker::buildInstallationSteps(const AppInfo &app, const K3s::ManifestInfo &manifest)
 {
-    QStringList commands;
+    // Mirror (copy to the registry on xip) runs once the old jobs are gone
+    // and the remote node is known to be up. The pull (image onto the
+    // deploy node) of a remote node goes through that registry and waits
+    // for the mirror; a local pull does not need it.
+    QList<JobManager::InstallStep> steps;
     
-    qDebug() << "[InstallationWorker] Building installation commands for" << app.id;
+    qDebug() << "[InstallationWorker] Building installation steps for" << app.id;
     qDebug() << "[InstallationWorker] Manifest - isRemoteNode:" << manifest.isRemoteNode;
     qDebug() << "[InstallationWorker] Manifest - pullJobYaml:" << manifest.pullJobYaml;
     qDebug() << "[InstallationWorker] Manifest - mirrorJobYaml:" << manifest.mirrorJobYaml;
     
     // Cleanup jobs to ensure environment is clean
-    if (1) {
-        emit installationProgress("Cleaning up installation jobs...");
-        commands << QString("kubectl delete job mirror-%1 pull-%1 --ignore-not-found").arg(app.id);
-    }
-
+    JobManager::InstallStep cleanup;
+    cleanup.name = "cleanup";
+    cleanup.label = "Cleaning up installation jobs...";
+    cleanup.removeJobs << QString("mirror-%1").arg(app.id) << QString("pull-%1").arg(app.id);
+    cleanup.retries = 1;
+    steps << cleanup;
+    
+    QStringList prepared { "cleanup" };
+    
     // Node readiness check (lightweight)
     if (manifest.isRemoteNode) {
-        emit installationProgress("Checking remote node availability...");
-        commands << QString("kubectl get node vip --no-headers || (echo 'ZonalECU - VIP is not ready' && exit 1)");
+        JobManager::InstallStep nodeCheck;
+        nodeCheck.name = "node-check";
+        nodeCheck.label = "Checking remote node availability...";
+        nodeCheck.requireNode = "vip";
+        nodeCheck.timeoutSec = 15;
+        nodeCheck.retries = 2;
+        steps << nodeCheck;
+        prepared << "node-check";
     }
     
-    // Mirror job (if remote node)
+    QStringList transfers;
+    
+    // Skip-if-present: the image is probed once, by whichever transfer
+    // step starts first. No mirror is needed when the node has the image
+    // already or the local registry holds the same digest.
+    struct Probe {
+        std::once_flag once;
+        K3s::ImagePresence presence;
+    };
+    auto probe = std::make_shared<Probe>();
+    auto presence = [probe, manifest]() -> const K3s::ImagePresence & {
+        std::call_once(probe->once, [&]() {
+            probe->presence = K3s::ImageCache::probe(manifest.image, manifest.deployNodeName,
+                                                     manifest.mirrorImage);
+        });
+        return probe->presence;
+    };
+    auto skipped = [](const QString &image, const QString &step) {
+        const qint64 saved = K3s::ImageCache::recordSkip(image, step);
+        qDebug() << "[InstallationWorker] Image" << image << "present, no" << step << "job needed,"
+                 << (saved > 0 ? QString("saved ~%1 s").arg(saved / 1000.0, 0, 'f', 1)
+                               : QString("nothing measured to compare"));
+        return true;
+    };
+    
+    // Mirror and pull jobs end on their own completion, or as soon as
+    // their pod reports ImagePullBackOff/ErrImagePull
     if (manifest.isRemoteNode && !manifest.mirrorJobYaml.isEmpty()) {
-        emit installationProgress("Setting up image mirroring...");
-        commands << QString("kubectl apply -f %1").arg(manifest.mirrorJobYaml);
-        commands << "sleep 20";  // Initial wait
-        
-        // Check mirror job status before proceeding
-        commands << QString(R"(
-            # Check mirror job status
-            if kubectl get job mirror-%1 -o jsonpath='{.status.conditions[?(@.type=="Failed")].status}' | grep -q True; then
-                echo "Mirror job failed immediately"
-                kubectl logs job/mirror-%1 --tail=5
-                exit 1
-            elif kubectl get pods -l job-name=mirror-%1 -o jsonpath='{.items[0].status.containerStatuses[0].state.waiting.reason}' | grep -qE "ImagePullBackOff|ErrImagePull"; then
-                echo "Mirror job image pull failed"
-                exit 1
-            fi
-            echo "Mirror job status check passed"
-        )").arg(app.id);
-        commands << QString("kubectl wait --for=condition=complete job/mirror-%1 --timeout=300s").arg(app.id);
+        JobManager::InstallStep mirror;
+        mirror.name = "mirror";
+        mirror.label = "Setting up image mirroring...";
+        mirror.after = prepared;
+        mirror.waitForJob = QString("mirror-%1").arg(app.id);
+        mirror.applyJob = manifest.mirrorJobYaml;
+        mirror.timeoutSec = 360;
+        mirror.skipIf = [presence, skipped, image = manifest.image]() {
+            const K3s::ImagePresence &p = presence();
+            return (p.onNode || p.inLocalRegistry) && skipped(image, "mirror");
+        };
+        // layers show up in the local registry as skopeo pushes them
+        auto progress = std::make_shared<K3s::PullProgress>(
+            QString("Mirroring %1").arg(app.name), manifest.image,
+            K3s::PullProgress::Target::Registry, manifest.mirrorImage);
+        mirror.onWaiting = [progress]() { progress->poll(); };
+        mirror.onDone = [progress, image = manifest.image](qint64 ms) {
+            progress->finish();
+            K3s::ImageCache::recordTransfer(image, "mirror", ms);
+        };
+        steps << mirror;
+        transfers << "mirror";
     }
     
     // Pull job
     if (!manifest.pullJobYaml.isEmpty()) {
-        emit installationProgress("Pulling container image...");
-        commands << QString("kubectl apply -f %1").arg(manifest.pullJobYaml);
-        commands << "sleep 25";  // Initial wait for job to start
-        
-        // Check pull job status before long wait
-        commands << QString(R"(
-            # Quick status check after job creation
-            if kubectl get job pull-%1 -o jsonpath='{.status.conditions[?(@.type=="Failed")].status}' | grep -q True; then
-                echo "Pull job failed immediately"
-                kubectl logs job/pull-%1 --tail=5
-                exit 1
-            elif kubectl get pods -l job-name=pull-%1 -o jsonpath='{.items[0].status.containerStatuses[0].state.waiting.reason}' | grep -qE "ImagePullBackOff|ErrImagePull"; then
-                echo "Pull job image pull failed - check registry access"
-                exit 1
-            fi
-            echo "Pull job initial status check passed"
-        )").arg(app.id);
-        
-        // Wait for pull completion
-        commands << QString("kubectl wait --for=condition=complete job/pull-%1 --timeout=1200s").arg(app.id);
+        JobManager::InstallStep pull;
+        pull.name = "pull";
+        pull.label = "Pulling container image...";
+        // the vip pulls from xip:5000, which has the image once mirrored
+        pull.after = transfers.contains("mirror") ? QStringList{ "mirror" } : prepared;
+        pull.waitForJob = QString("pull-%1").arg(app.id);
+        pull.applyJob = manifest.pullJobYaml;
+        pull.timeoutSec = 1260;
+        pull.skipIf = [presence, skipped, image = manifest.image]() {
+            return presence().onNode && skipped(image, "pull");
+        };
+        // only the content store of this device can be looked into
+        std::shared_ptr<K3s::PullProgress> progress;
+        if (!manifest.isRemoteNode) {
+            progress = std::make_shared<K3s::PullProgress>(
+                QString("Downloading %1").arg(app.name), manifest.image,
+                K3s::PullProgress::Target::Node);
+            pull.onWaiting = [progress]() { progress->poll(); };
+        }
+        pull.onDone = [progress, image = manifest.image](qint64 ms) {
+            if (progress) {
+                progress->finish();
+            }
+            K3s::ImageCache::recordTransfer(image, "pull", ms);
+        };
+        steps << pull;
+        transfers << "pull";
     }
     
     // Cleanup jobs after successful pull
-    if (!commands.isEmpty()) {
-        emit installationProgress("Cleaning up installation jobs...");
-        commands << QString("kubectl delete job mirror-%1 pull-%1 --ignore-not-found").arg(app.id);
-    }
+    JobManager::InstallStep finalCleanup;
+    finalCleanup.name = "cleanup-jobs";
+    finalCleanup.after = transfers.isEmpty() ? prepared : transfers;
+    finalCleanup.removeJobs = cleanup.removeJobs;
+    finalCleanup.retries = 1;
+    steps << finalCleanup;
     
-    qDebug() << "[InstallationWorker] Generated" << commands.size() << "installation commands:";
-    for (int i = 0; i < commands.size(); ++i) {
-        qDebug() << "[InstallationWorker] Command" << (i+1) << ":" << commands[i];
+    qDebug() << "[InstallationWorker] Generated" << steps.size() << "installation steps:";
+    for (const auto &step : steps) {
+        qDebug() << "[InstallationWorker] Step" << step.name << "after" << step.after
+                 << "- applies" << (step.applyJob.isEmpty() ? QString("nothing") : step.applyJob);
     }
     
-    return commands;
+    return steps;
 }
 
 void InstallationWorker::updateInstallationRecord(const AppInfo &app, const QString &category)
@@ -366,6 +432,8 @@ MarketplaceViewModel::MarketplaceViewModel(QObject *parent)
     // Connect JobManager signals for UI feedback
     connect(m_jobManager, &JobManager::requestRejected,
             this, &MarketplaceViewModel::onJobManagerBusy);
+    connect(m_jobManager, &JobManager::queueChanged,
+            this, &MarketplaceViewModel::queueChanged);
             
     qDebug() << "[MarketplaceViewModel] Initialized with JobManager integration";
 }
@@ -392,9 +460,14 @@ void MarketplaceViewModel::search(const QString &term)
     opt.limit      = 100;
     opt.rootFolder = DK_CONTAINER_ROOT + "dk_marketplace/";
 
-    if (m_searchJob) m_searchJob->deleteLater();
+    // a search still waiting in the queue is outdated now
+    if (m_searchJob) {
+        m_searchJob->cancel();
+        m_searchJob->deleteLater();
+    }
     m_searchJob = new Job<QList<AppInfo>>(
         [=](){ return DataManager::fetchAppList(opt); },
+        RunOptions{ Pool::Io, Priority::Interactive },
         this);
 
     connect(m_searchJob, &JobBase::finished,
@@ -437,9 +510,9 @@ void MarketplaceViewModel::appSelected(int idx) {
     QVariantMap info = m_apps->get(idx);
     
     if (!info.value("isInstalled").toBool()) {
-        // Check if JobManager is busy
-        if (m_jobManager->isBusy()) {
-            NOTIFY_WARNING("Installation", "System busy: " + m_jobManager->currentOperation());
+        // Other installs may be running: this one is queued behind them
+        if (m_activeInstalls.contains(m_lastApps[idx].id)) {
+            NOTIFY_INFO("Installation", info.value("name").toString() + " is already being installed");
             return;
         }
         
@@ -463,71 +536,94 @@ void MarketplaceViewModel::confirmInstall()
         return;
     }
     
-    // Double-check JobManager isn't busy
-    if (m_jobManager->isBusy()) {
-        NOTIFY_WARNING("Installation", "System busy: " + m_jobManager->currentOperation());
-        cancelInstall();
-        return;
-    }
-    
     const AppInfo app = m_lastApps[m_pendingIndex];
     
     // Update UI state
     m_isInstalling = true;
+    m_installingAppId = app.id;
+    m_activeInstalls.insert(app.id);
     emit isInstallingChanged(true);
     
     // Start installation
     m_installWorker->startInstallation(app, m_lastSearchTerm);
+    emit queueChanged();
     
-    qDebug() << "[MarketplaceViewModel] Started installation for:" << app.name;
+    qDebug() << "[MarketplaceViewModel] Started installation for:" << app.name
+             << "queue position:" << queuePosition();
 }
 
 void MarketplaceViewModel::cancelInstall() {
     if (!m_installPending) return;
     
-    m_installWorker->cancelInstallation();
+    // a queued install is dropped, its failure resets the state
+    if (m_isInstalling && m_installWorker->cancelInstallation(m_installingAppId)) {
+        return;
+    }
     
     // Reset state
     resetInstallationState();
 }
 
+int MarketplaceViewModel::queuePosition() const
+{
+    return m_installingAppId.isEmpty() ? -1 : m_jobManager->queuePosition(m_installingAppId);
+}
+
+int MarketplaceViewModel::queueEtaSec() const
+{
+    return m_installingAppId.isEmpty() ? -1 : m_jobManager->queueEtaSec(m_installingAppId);
+}
+
 void MarketplaceViewModel::resetInstallationState()
 {
     m_installPending = false;
     m_isInstalling = false;
     m_installingIndex = -1;
     m_pendingIndex = -1;
+    m_installingAppId.clear();
     
     emit installPendingChanged(false);
     emit isInstallingChanged(false);
     emit installingIndexChanged(-1);
 }
 
-void MarketplaceViewModel::onInstallationProgress(const QString &message)
+void MarketplaceViewModel::onInstallationProgress(const QString &appId, const QString &message)
 {
-    emit installProgressChanged(message);
+    if (appId == m_installingAppId) {
+        emit installProgressChanged(message);
+    }
 }
 
 void MarketplaceViewModel::onInstallationCompleted(const QString &appId)
 {
     qDebug() << "[MarketplaceViewModel] Installation completed:" << appId;
+    m_activeInstalls.remove(appId);
     
-    // Update app as installed
-    if (m_pendingIndex >= 0) {
-        m_apps->setAppInstalled(m_pendingIndex, true);
-        emit installFinished();
+    // Update app as installed, wherever it is in the list now
+    for (int i = 0; i < m_lastApps.size(); ++i) {
+        if (m_lastApps[i].id == appId) {
+            m_lastApps[i].isInstalled = true;
+            m_apps->setAppInstalled(i, true);
+        }
     }
     
-    resetInstallationState();
+    // the progress UI follows one install; others finish in the background
+    if (appId == m_installingAppId) {
+        emit installFinished();
+        resetInstallationState();
+    }
     NOTIFY_SUCCESS("Installation", "Application installed successfully: " + appId);
 }
 
 void MarketplaceViewModel::onInstallationFailed(const QString &appId, const QString &error)
 {
     qDebug() << "[MarketplaceViewModel] Installation failed:" << appId << error;
+    m_activeInstalls.remove(appId);
     
-    resetInstallationState();
-    emit installError();
+    if (appId == m_installingAppId) {
+        resetInstallationState();
+        emit installError();
+    }
     
     NOTIFY_ERROR("Installation", "Installation failed: " + error);
 }
@@ -537,8 +633,8 @@ void MarketplaceViewModel::onJobManagerBusy(const QString &reason)
     qDebug() << "[MarketplaceViewModel] JobManager busy:" << reason;
     NOTIFY_WARNING("Installation", QString("System busy: %1").arg(reason));
     
-    // If we have a pending installation, cancel it
-    if (m_installPending) {
+    // Installs are queued, never rejected: only a confirm dialog still open is dropped
+    if (m_installPending && !m_isInstalling) {
         resetInstallationState();
     }
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QDateTime>
+#include <QSet>
 
 // bring in your existing fetch helpers:
 #include "../platform/async/asyncjob.hpp"
@@ -79,21 +80,21 @@ public:
     explicit InstallationWorker(QObject *parent = nullptr);
     ~InstallationWorker();
 
+    // installations run concurrently, each reported with its app id
     void startInstallation(const AppInfo &app, const QString &category);
-    void cancelInstallation();
+    bool cancelInstallation(const QString &appId);     // only while still queued
 
 signals:
-    void installationProgress(const QString &message);
+    void installationProgress(const QString &appId, const QString &message);
     void installationCompleted(const QString &appId);
     void installationFailed(const QString &appId, const QString &error);
 
 private:
-    QStringList buildInstallationCommands(const AppInfo &app, const K3s::ManifestInfo &manifest);
+    QList<K3s::JobManager::InstallStep> buildInstallationSteps(const AppInfo &app, const K3s::ManifestInfo &manifest);
     void updateInstallationRecord(const AppInfo &app, const QString &category);
 
     K3s::JobManager *m_jobManager;
-    AppInfo m_currentApp;
-    QString m_currentCategory;
+    QSet<QString> m_activeApps;
 };
 
 class MarketplaceViewModel : public QObject {
@@ -107,6 +108,9 @@ class MarketplaceViewModel : public QObject {
     Q_PROPERTY(int                 installingIndex  READ installingIndex NOTIFY installingIndexChanged)
     Q_PROPERTY(bool                installPending   READ installPending  NOTIFY installPendingChanged)
     Q_PROPERTY(QString             pendingAppName   READ pendingAppName  NOTIFY pendingAppNameChanged)
+    // of the install shown: 0 = running, n = n-th in the queue, -1 = none
+    Q_PROPERTY(int                 queuePosition    READ queuePosition   NOTIFY queueChanged)
+    Q_PROPERTY(int                 queueEtaSec      READ queueEtaSec     NOTIFY queueChanged)
 
   public:
     explicit MarketplaceViewModel(QObject* parent=nullptr);
@@ -118,6 +122,8 @@ class MarketplaceViewModel : public QObject {
     int                installingIndex() const { return m_installingIndex; }
     bool               installPending() const  { return m_installPending; }
     QString            pendingAppName() const  { return m_pendingName; }
+    int                queuePosition() const;
+    int                queueEtaSec() const;
 
   public slots:
     // called by QML
@@ -134,6 +140,7 @@ class MarketplaceViewModel : public QObject {
     void installPendingChanged(bool);
     void pendingAppNameChanged(const QString&);
     void installProgressChanged(const QString &message);  // Progress updates
+    void queueChanged();
     // 
     void searchFinished();
     void searchError();
@@ -141,7 +148,7 @@ class MarketplaceViewModel : public QObject {
     void installError();
 
   private slots:
-    void onInstallationProgress(const QString &message);
+    void onInstallationProgress(const QString &appId, const QString &message);
     void onInstallationCompleted(const QString &appId);
     void onInstallationFailed(const QString &appId, const QString &error);
     void onJobManagerBusy(const QString &reason);
@@ -165,5 +172,7 @@ class MarketplaceViewModel : public QObject {
     bool    m_installPending  = false;
     QString m_pendingName;
     int     m_pendingIndex    = -1;
+    QString m_installingAppId;          // the install the progress UI follows
+    QSet<QString> m_activeInstalls;     // running or queued
     QString m_lastSearchTerm;
 };
\ No newline at end of file
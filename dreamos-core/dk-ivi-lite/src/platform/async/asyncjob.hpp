@@ -12,6 +12,7 @@
 #include <QtConcurrent>
 #include <functional>
 #include <type_traits>
+#include "executor.hpp"
 
 namespace Async {
 
@@ -23,8 +24,31 @@ class JobBase : public QObject
     Q_OBJECT
 public:
     explicit JobBase(QObject *p = nullptr) : QObject(p) {}
+
+    /*  A job cancelled before it started never runs and finishes with
+     *  ok = false; a running job can poll cancelToken().            */
+    void cancel() { m_cancel.cancel(); }
+    CancelToken cancelToken() const { return m_cancel; }
+
+    /*  valid once finished() has been emitted, for code that looks
+     *  at the job later (e.g. a coroutine awaiting it)              */
+    bool isFinished() const { return m_finished; }
+    bool succeeded() const  { return m_ok; }
+
 signals:
     void finished(bool ok);
+
+protected:
+    void finish(bool ok)
+    {
+        m_finished = true;
+        m_ok       = ok;
+        emit finished(ok);
+    }
+
+    CancelToken m_cancel;
+    bool        m_finished = false;
+    bool        m_ok       = false;
 };
 
 /* ------------------------------------------------------------------ */
@@ -36,10 +60,31 @@ class Job : public JobBase
 public:
     using Fn = std::function<T()>;
 
+    /*  Without options the job runs on the I/O pool at normal priority,
+     *  which fits the kubectl/QProcess work most jobs wrap.          */
     explicit Job(Fn fn, QObject *parent = nullptr)
+        : Job(std::move(fn), RunOptions(), parent) {}
+
+    Job(Fn fn, RunOptions opts, QObject *parent = nullptr)
         : JobBase(parent)
     {
-        m_future  = QtConcurrent::run(std::move(fn));
+        m_cancel  = opts.cancel;
+        watch(Executor::instance().run(opts, std::move(fn)));
+    }
+
+    /*  adopts a future produced elsewhere, e.g. Task<T>::future() */
+    explicit Job(QFuture<T> future, QObject *parent = nullptr)
+        : JobBase(parent)
+    {
+        watch(std::move(future));
+    }
+
+    T result() const { return m_result; }
+
+private:
+    void watch(QFuture<T> future)
+    {
+        m_future = std::move(future);
         m_watcher.setFuture(m_future);
 
         connect(&m_watcher, &QFutureWatcher<T>::finished,
@@ -51,13 +96,10 @@ public:
             } catch (...) {
                 ok = false;
             }
-            emit finished(ok);
+            finish(ok);
         });
     }
 
-    T result() const { return m_result; }
-
-private:
     QFuture<T>          m_future;
     QFutureWatcher<T>   m_watcher;
     T                   m_result {};
@@ -75,16 +117,25 @@ public:
     /*  internal: ctor is fed by Chain with a wrapper that *always*
      *  returns bool (true = success, false = failure)               */
     explicit Job(Fn fn, QObject *parent = nullptr)
+        : Job(std::move(fn), RunOptions(), parent) {}
+
+    Job(Fn fn, RunOptions opts, QObject *parent = nullptr)
         : JobBase(parent)
     {
-        m_future  = QtConcurrent::run(std::move(fn));   // bool future
+        m_cancel  = opts.cancel;
+        m_future  = Executor::instance().run(opts, std::move(fn));   // bool future
         m_watcher.setFuture(m_future);
 
         connect(&m_watcher, &QFutureWatcher<bool>::finished,
                 this,
                 [this]() {
-            const bool ok = m_future.result();
-            emit finished(ok);
+            bool ok = false;
+            try {
+                ok = m_future.result();            // throws if cancelled
+            } catch (...) {
+                ok = false;
+            }
+            finish(ok);
         });
     }
 
@@ -129,13 +180,19 @@ public:
 
     explicit Chain(QObject *p = nullptr) : QObject(p) {}
 
+    /*  every step runs with these options; cancelling the token stops
+     *  the chain before its next step                                */
+    Chain(RunOptions opts, QObject *p = nullptr) : QObject(p), m_opts(std::move(opts)) {}
+
+    void cancel() { m_opts.cancel.cancel(); }
+
     void start()
     {
         if (m_idx >= m_fns.size()) {
             emit finished(true);
             return;
         }
-        auto *job = new Job<void>(m_fns[m_idx], this);
+        auto *job = new Job<void>(m_fns[m_idx], m_opts, this);
         connect(job, &JobBase::finished,
                 this,
                 [this](bool ok){
@@ -154,6 +211,7 @@ signals:
 private:
     QList<std::function<bool()>> m_fns;    // list of wrapped steps
     int                           m_idx {0};
+    RunOptions                    m_opts;
 };
 
 } // namespace Async
@@ -0,0 +1,361 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QPromise>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include "asyncjob.hpp"
+
+namespace Async {
+
+/* ------------------------------------------------------------------ */
+/* Coroutines on the Qt event loop                                    */
+/*                                                                    */
+/*  A coroutine returning Task<T> starts right away and runs until    */
+/*  its first co_await. It is resumed by the event loop of the thread */
+/*  whose signal it waited for: jobs created by the coroutine, timers */
+/*  and processes all belong to the thread it runs on, so the whole   */
+/*  coroutine stays there. While it waits no thread is held.          */
+/*                                                                    */
+/*  Whatever the coroutine uses must outlive its awaits: take         */
+/*  parameters by value and check a QPointer to 'this' after each     */
+/*  co_await when the object may go away meanwhile.                   */
+/* ------------------------------------------------------------------ */
+namespace detail {
+
+template<typename T>
+struct TaskState {
+    using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    std::optional<Value>            value;
+    std::exception_ptr              error;
+    std::coroutine_handle<>         continuation;   // a coroutine awaiting the task
+    QList<std::function<void()>>    callbacks;      // then() and future()
+
+    bool finished() const { return value.has_value() || error; }
+
+    void whenFinished(std::function<void()> fn)
+    {
+        if (finished()) fn();
+        else            callbacks << std::move(fn);
+    }
+
+    void complete()
+    {
+        if (continuation)
+            std::exchange(continuation, {}).resume();
+        const auto fns = std::move(callbacks);
+        for (const auto &fn : fns)
+            fn();
+    }
+};
+
+template<typename T>
+struct TaskPromiseBase {
+    std::shared_ptr<TaskState<T>> state = std::make_shared<TaskState<T>>();
+    void return_value(T value) { state->value = std::move(value); }
+};
+
+template<>
+struct TaskPromiseBase<void> {
+    std::shared_ptr<TaskState<void>> state = std::make_shared<TaskState<void>>();
+    void return_void() { state->value.emplace(); }
+};
+
+} // namespace detail
+
+template<typename T = void>
+class Task
+{
+public:
+    using State = detail::TaskState<T>;
+
+    struct promise_type : detail::TaskPromiseBase<T> {
+        Task get_return_object() { return Task(this->state); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        /* the frame is freed here; whoever waits holds the state */
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                auto state = h.promise().state;
+                h.destroy();
+                state->complete();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { this->state->error = std::current_exception(); }
+    };
+
+    bool isFinished() const { return m_state->finished(); }
+
+    /*  A task is awaited at most once: from another coroutine with
+     *  co_await (which rethrows its exception), or from plain code
+     *  with then().                                                  */
+    auto operator co_await() const
+    {
+        struct Awaiter {
+            std::shared_ptr<State> state;
+
+            bool await_ready() const { return state->finished(); }
+            void await_suspend(std::coroutine_handle<> h) { state->continuation = h; }
+            T await_resume()
+            {
+                if (state->error)
+                    std::rethrow_exception(state->error);
+                if constexpr (!std::is_void_v<T>)
+                    return std::move(*state->value);
+            }
+        };
+        return Awaiter{ m_state };
+    }
+
+    /*  fn(bool ok) runs once the coroutine has returned (ok) or thrown,
+     *  unless context has been destroyed by then.                    */
+    template<typename F>
+    void then(QObject *context, F fn) const
+    {
+        QPointer<QObject> guard(context);
+        std::weak_ptr<State> weak = m_state;
+        m_state->whenFinished([guard, weak, fn = std::move(fn)]() {
+            const auto state = weak.lock();
+            if (guard && state)
+                fn(!state->error);
+        });
+    }
+
+    /*  Bridges the task to the QFuture based API, e.g. to hand it out
+     *  as a Job<T>. An exception ends up in the future.              */
+    QFuture<T> future() const
+    {
+        auto promise = std::make_shared<QPromise<T>>();
+        promise->start();
+        QFuture<T> f = promise->future();
+
+        std::weak_ptr<State> weak = m_state;
+        m_state->whenFinished([promise, weak]() {
+            if (const auto state = weak.lock()) {
+                if (state->error) {
+                    promise->setException(state->error);
+                } else if constexpr (!std::is_void_v<T>) {
+                    promise->addResult(*state->value);
+                }
+            }
+            promise->finish();
+        });
+        return f;
+    }
+
+private:
+    explicit Task(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+    std::shared_ptr<State> m_state;
+};
+
+/* ------------------------------------------------------------------ */
+/* co_await Async::finished(job)                                      */
+/*                                                                    */
+/*  Yields the job's result, std::nullopt if the job failed, was      */
+/*  cancelled or is null; for Job<void> the ok flag. The job is not   */
+/*  deleted.                                                          */
+/* ------------------------------------------------------------------ */
+template<typename T>
+class JobAwaiter
+{
+public:
+    explicit JobAwaiter(Job<T> *job) : m_job(job) {}
+
+    bool await_ready() const { return !m_job || m_job->isFinished(); }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        QObject::connect(m_job, &JobBase::finished, m_job, [h](bool) { h.resume(); },
+                         Qt::SingleShotConnection);
+    }
+
+    auto await_resume() const
+    {
+        const bool ok = m_job && m_job->succeeded();
+        if constexpr (std::is_void_v<T>) {
+            return ok;
+        } else {
+            return ok ? std::optional<T>(m_job->result()) : std::nullopt;
+        }
+    }
+
+private:
+    QPointer<Job<T>> m_job;
+};
+
+template<typename T>
+JobAwaiter<T> finished(Job<T> *job) { return JobAwaiter<T>(job); }
+
+/* ------------------------------------------------------------------ */
+/* co_await Async::signal(sender, &Sender::someSignal)                */
+/*                                                                    */
+/*  Resumes on the next emission, the arguments are dropped. Await    */
+/*  only signals that cannot have been emitted already, e.g.          */
+/*  QNetworkReply::finished right after the request was sent.         */
+/* ------------------------------------------------------------------ */
+template<typename Sender, typename Signal>
+class SignalAwaiter
+{
+public:
+    SignalAwaiter(Sender *sender, Signal signal) : m_sender(sender), m_signal(signal) {}
+
+    bool await_ready() const { return !m_sender; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        QObject::connect(m_sender.data(), m_signal, m_sender.data(), [h]() { h.resume(); },
+                         Qt::SingleShotConnection);
+    }
+    void await_resume() const {}
+
+private:
+    QPointer<Sender> m_sender;
+    Signal           m_signal;
+};
+
+template<typename Sender, typename Signal>
+SignalAwaiter<Sender, Signal> signal(Sender *sender, Signal signal)
+{
+    return SignalAwaiter<Sender, Signal>(sender, signal);
+}
+
+/* ------------------------------------------------------------------ */
+/* co_await Async::sleep(duration)                                    */
+/* ------------------------------------------------------------------ */
+class SleepAwaiter
+{
+public:
+    explicit SleepAwaiter(std::chrono::milliseconds delay) : m_delay(delay) {}
+
+    bool await_ready() const { return m_delay.count() <= 0; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        QTimer::singleShot(m_delay, [h]() { h.resume(); });
+    }
+    void await_resume() const {}
+
+private:
+    std::chrono::milliseconds m_delay;
+};
+
+inline SleepAwaiter sleep(std::chrono::milliseconds delay) { return SleepAwaiter(delay); }
+
+/* ------------------------------------------------------------------ */
+/* co_await Async::process(program, args, timeout)                    */
+/*                                                                    */
+/*  Runs the process without blocking a thread on waitForFinished().  */
+/*  A process still running after the timeout is killed.              */
+/* ------------------------------------------------------------------ */
+struct ProcessResult {
+    bool                  started    = false;
+    bool                  timedOut   = false;
+    int                   exitCode   = -1;
+    QProcess::ExitStatus  exitStatus = QProcess::NormalExit;
+    QString               output;         // stdout and stderr merged, trimmed
+    QString               errorString;    // set when the process failed to start
+
+    bool ok() const
+    {
+        return started && !timedOut && exitStatus == QProcess::NormalExit && exitCode == 0;
+    }
+};
+
+class ProcessAwaiter
+{
+public:
+    ProcessAwaiter(QString program, QStringList args, std::chrono::milliseconds timeout,
+                   QProcessEnvironment env)
+        : m_program(std::move(program)), m_args(std::move(args))
+        , m_timeout(timeout), m_env(std::move(env)) {}
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        auto *proc  = new QProcess;
+        auto *timer = new QTimer(proc);
+        ProcessResult *r = &m_result;       // lives in the frame until resumed
+
+        auto resume = [proc, timer, h]() {
+            timer->stop();
+            QObject::disconnect(proc, nullptr, nullptr, nullptr);
+            proc->deleteLater();
+            h.resume();
+        };
+
+        QObject::connect(proc, &QProcess::started, proc, [r]() { r->started = true; });
+        QObject::connect(proc, &QProcess::finished, proc,
+                         [proc, r, resume](int exitCode, QProcess::ExitStatus status) {
+            r->exitCode   = exitCode;
+            r->exitStatus = status;
+            r->output     = QString::fromUtf8(proc->readAll()).trimmed();
+            resume();
+        });
+        // finished() follows every other error
+        QObject::connect(proc, &QProcess::errorOccurred, proc,
+                         [proc, r, resume](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart)
+                return;
+            r->errorString = proc->errorString();
+            resume();
+        });
+
+        if (m_timeout.count() > 0) {
+            timer->setSingleShot(true);
+            QObject::connect(timer, &QTimer::timeout, proc, [proc, r]() {
+                r->timedOut = true;
+                proc->kill();
+            });
+            timer->start(m_timeout);
+        }
+
+        proc->setProcessChannelMode(QProcess::MergedChannels);
+        proc->setProcessEnvironment(m_env);
+        // may resume the coroutine right here: nothing of 'this' after it
+        proc->start(m_program, m_args);
+    }
+
+    ProcessResult await_resume() { return std::move(m_result); }
+
+private:
+    QString                     m_program;
+    QStringList                 m_args;
+    std::chrono::milliseconds   m_timeout;
+    QProcessEnvironment         m_env;
+    ProcessResult               m_result;
+};
+
+inline ProcessAwaiter process(QString program, QStringList args,
+                              std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                              QProcessEnvironment env = QProcessEnvironment::systemEnvironment())
+{
+    return ProcessAwaiter(std::move(program), std::move(args), timeout, std::move(env));
+}
+
+} // namespace Async
@@ -0,0 +1,120 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "executor.hpp"
+#include <QDebug>
+#include <QThread>
+#include <algorithm>
+
+namespace Async {
+
+Executor &Executor::instance()
+{
+    static Executor executor;
+    return executor;
+}
+
+Executor::Executor()
+{
+    const int cores = std::max(2, QThread::idealThreadCount());
+
+    m_cpu.setObjectName("Async.Cpu");
+    m_cpu.setMaxThreadCount(cores);
+    m_cpuBackground.setObjectName("Async.CpuBackground");
+    m_cpuBackground.setMaxThreadCount(std::max(1, cores / 2));
+    m_cpuBackground.setThreadPriority(QThread::LowPriority);
+
+    // blocking calls mostly sleep in waitpid()/poll(), size by concurrency
+    m_io.setObjectName("Async.Io");
+    m_io.setMaxThreadCount(std::max(8, cores));
+    m_io.setExpiryTimeout(60000);
+    m_ioBackground.setObjectName("Async.IoBackground");
+    m_ioBackground.setMaxThreadCount(4);
+    m_ioBackground.setExpiryTimeout(60000);
+}
+
+int Executor::laneIndex(Pool pool, Priority priority)
+{
+    return static_cast<int>(pool) * 3 + static_cast<int>(priority);
+}
+
+int Executor::queuePriority(Priority priority)
+{
+    // QThreadPool starts higher values first
+    switch (priority) {
+    case Priority::Interactive: return 2;
+    case Priority::Normal:      return 1;
+    default:                    return 0;
+    }
+}
+
+QThreadPool *Executor::threadPool(Pool pool, Priority priority)
+{
+    const bool background = priority == Priority::Background;
+    if (pool == Pool::Cpu)
+        return background ? &m_cpuBackground : &m_cpu;
+    return background ? &m_ioBackground : &m_io;
+}
+
+void Executor::setMaxThreads(Pool pool, Priority priority, int count)
+{
+    threadPool(pool, priority)->setMaxThreadCount(std::max(1, count));
+}
+
+void Executor::Lane::started(Clock::time_point queuedAt)
+{
+    const quint64 waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - queuedAt).count();
+
+    startedCount.fetch_add(1, std::memory_order_relaxed);
+    totalWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+
+    quint64 prev = maxWaitUs.load(std::memory_order_relaxed);
+    while (waitUs > prev &&
+           !maxWaitUs.compare_exchange_weak(prev, waitUs, std::memory_order_relaxed)) {
+    }
+}
+
+Executor::LaneStats Executor::stats(Pool pool, Priority priority) const
+{
+    const Lane &lane = m_lanes[laneIndex(pool, priority)];
+
+    LaneStats s;
+    s.finished  = lane.finished.load(std::memory_order_relaxed);
+    s.started   = lane.startedCount.load(std::memory_order_relaxed);
+    s.submitted = lane.submitted.load(std::memory_order_relaxed);
+    s.cancelled = lane.cancelled.load(std::memory_order_relaxed);
+    s.queued    = static_cast<int>(s.submitted - std::min(s.submitted, s.started));
+    s.running   = static_cast<int>(s.started - std::min(s.started, s.finished));
+    if (s.started)
+        s.avgWaitMs = lane.totalWaitUs.load(std::memory_order_relaxed) / 1000.0 / s.started;
+    s.maxWaitMs = lane.maxWaitUs.load(std::memory_order_relaxed) / 1000.0;
+    return s;
+}
+
+void Executor::logStats() const
+{
+    static const char *pools[]      = { "cpu", "io" };
+    static const char *priorities[] = { "interactive", "normal", "background" };
+
+    for (int p = 0; p < 2; ++p) {
+        for (int q = 0; q < 3; ++q) {
+            const LaneStats s = stats(static_cast<Pool>(p), static_cast<Priority>(q));
+            if (!s.submitted)
+                continue;
+            qDebug().nospace() << "[Async] " << pools[p] << "/" << priorities[q]
+                               << ": submitted " << s.submitted
+                               << ", queued " << s.queued
+                               << ", running " << s.running
+                               << ", cancelled " << s.cancelled
+                               << ", wait avg " << s.avgWaitMs << " ms"
+                               << ", max " << s.maxWaitMs << " ms";
+        }
+    }
+}
+
+} // namespace Async
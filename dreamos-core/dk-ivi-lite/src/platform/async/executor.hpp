@@ -0,0 +1,155 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+#include <QException>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Async {
+
+/* ------------------------------------------------------------------ */
+/* 0) where and how urgently a task runs                              */
+/* ------------------------------------------------------------------ */
+enum class Pool {
+    Cpu,        // parsing, JSON, model building - never blocks
+    Io          // kubectl, QProcess, network, file system - may block long
+};
+
+enum class Priority {
+    Interactive,    // the user is waiting: search, status refresh
+    Normal,
+    Background      // installs, image pulls, periodic checks
+};
+
+/* ------------------------------------------------------------------ */
+/* 1) cooperative cancellation                                        */
+/* ------------------------------------------------------------------ */
+class CancelToken
+{
+public:
+    CancelToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const            { m_flag->store(true); }
+    bool isCancelled() const       { return m_flag->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+/* thrown into the future of a task cancelled before it started       */
+class Cancelled : public QException
+{
+public:
+    void raise() const override          { throw *this; }
+    Cancelled *clone() const override    { return new Cancelled(*this); }
+    const char *what() const noexcept override { return "Async task cancelled"; }
+};
+
+struct RunOptions {
+    Pool        pool     = Pool::Io;
+    Priority    priority = Priority::Normal;
+    CancelToken cancel;
+};
+
+/* ------------------------------------------------------------------ */
+/* 2) executor                                                        */
+/*                                                                    */
+/*  Each Pool has two QThreadPools: one shared by the Interactive and */
+/*  Normal lanes (Interactive is dequeued first) and one for the      */
+/*  Background lane. Long background work can therefore fill its own  */
+/*  threads but never the ones user-facing tasks wait for. The global */
+/*  QThreadPool is not used.                                          */
+/* ------------------------------------------------------------------ */
+class Executor
+{
+public:
+    struct LaneStats {
+        quint64 submitted = 0;
+        quint64 started   = 0;
+        quint64 finished  = 0;
+        quint64 cancelled = 0;      // skipped because cancelled before start
+        int     queued    = 0;      // submitted, not started yet
+        int     running   = 0;
+        double  avgWaitMs = 0.0;    // submit -> start
+        double  maxWaitMs = 0.0;
+    };
+
+    static Executor &instance();
+
+    template<typename F>
+    auto run(const RunOptions &opts, F fn) -> QFuture<std::invoke_result_t<F>>
+    {
+        using R = std::invoke_result_t<F>;
+        Lane *lane = &m_lanes[laneIndex(opts.pool, opts.priority)];
+        lane->submitted.fetch_add(1, std::memory_order_relaxed);
+
+        const auto queuedAt = Clock::now();
+        auto task = [lane, queuedAt, cancel = opts.cancel, fn = std::move(fn)]() mutable -> R {
+            lane->started(queuedAt);
+            struct Done {
+                Lane *lane;
+                ~Done() { lane->finished.fetch_add(1, std::memory_order_relaxed); }
+            } done{lane};
+
+            if (cancel.isCancelled()) {
+                lane->cancelled.fetch_add(1, std::memory_order_relaxed);
+                throw Cancelled();
+            }
+            return fn();
+        };
+
+        return QtConcurrent::task(std::move(task))
+            .onThreadPool(*threadPool(opts.pool, opts.priority))
+            .withPriority(queuePriority(opts.priority))
+            .spawn();
+    }
+
+    QThreadPool *threadPool(Pool pool, Priority priority);
+    void setMaxThreads(Pool pool, Priority priority, int count);
+
+    LaneStats stats(Pool pool, Priority priority) const;
+    void logStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Lane {
+        std::atomic<quint64> submitted {0};
+        std::atomic<quint64> startedCount {0};
+        std::atomic<quint64> finished {0};
+        std::atomic<quint64> cancelled {0};
+        std::atomic<quint64> totalWaitUs {0};
+        std::atomic<quint64> maxWaitUs {0};
+
+        void started(Clock::time_point queuedAt);
+    };
+
+    static constexpr int LANES = 6;     // 2 pools x 3 priorities
+
+    Executor();
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    static int laneIndex(Pool pool, Priority priority);
+    static int queuePriority(Priority priority);
+
+    std::array<Lane, LANES>     m_lanes;
+    QThreadPool                 m_cpu;
+    QThreadPool                 m_cpuBackground;
+    QThreadPool                 m_io;
+    QThreadPool                 m_ioBackground;
+};
+
+} // namespace Async
@@ -0,0 +1,252 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "graph.hpp"
+#include <QDebug>
+#include <QTimer>
+#include <algorithm>
+
+namespace Async {
+
+Graph::StepId Graph::addStep(const QString &name, Fn fn, const QList<StepId> &after,
+                             const StepOptions &opts)
+{
+    if (m_started) {
+        qWarning() << "[Graph] cannot add" << name << "to a started graph";
+        return -1;
+    }
+    const StepId id = m_steps.size();
+    for (StepId dep : after) {
+        if (dep < 0 || dep >= id) {
+            qWarning() << "[Graph] step" << name << "depends on unknown step" << dep;
+            return -1;
+        }
+    }
+
+    Step step;
+    step.name        = name;
+    step.fn          = std::move(fn);
+    step.opts        = opts;
+    step.after       = after;
+    step.waiting     = after.size();
+    step.timing.name = name;
+    for (StepId dep : after)
+        m_steps[dep].next << id;
+    m_steps << step;
+    return id;
+}
+
+void Graph::start()
+{
+    if (m_started)
+        return;
+    m_started   = true;
+    m_remaining = m_steps.size();
+    m_clock.start();
+
+    for (StepId id = 0; id < m_steps.size() && !m_cancelled; ++id) {
+        if (m_steps[id].waiting == 0)
+            launch(id);
+    }
+    maybeFinish();
+}
+
+void Graph::cancel()
+{
+    if (m_finished)
+        return;
+    m_cancelled = true;
+    for (Step &s : m_steps) {
+        if (s.running)
+            s.token.cancel();
+    }
+    if (m_started)
+        maybeFinish();
+}
+
+void Graph::launch(StepId id)
+{
+    Step &s = m_steps[id];
+    s.token   = CancelToken();
+    s.running = true;
+    s.expired = false;
+    ++m_active;
+
+    const int attempt = ++s.timing.attempts;
+    if (s.timing.startMs < 0)
+        s.timing.startMs = m_clock.elapsed();
+
+    RunOptions opts = m_defaults;
+    opts.cancel = s.token;
+    const Fn          fn    = s.fn;
+    const CancelToken token = s.token;
+
+    auto *job = new Job<void>([fn, token]() { return fn(token); }, opts, this);
+    connect(job, &JobBase::finished, this, [this, id, attempt, job](bool ok) {
+        job->deleteLater();
+        attemptFinished(id, attempt, ok);
+    });
+
+    if (s.opts.timeout.count() > 0) {
+        QTimer::singleShot(s.opts.timeout, this, [this, id, attempt]() {
+            attemptTimedOut(id, attempt);
+        });
+    }
+}
+
+void Graph::attemptFinished(StepId id, int attempt, bool ok)
+{
+    Step &s = m_steps[id];
+    if (!s.running || s.timing.attempts != attempt)
+        return;
+    s.running = false;
+    --m_active;
+
+    if (ok && !s.expired && !m_cancelled) complete(id, true);
+    else                                  attemptFailed(id);
+}
+
+void Graph::attemptTimedOut(StepId id, int attempt)
+{
+    Step &s = m_steps[id];
+    if (!s.running || s.timing.attempts != attempt)
+        return;
+    // the attempt fails once it has returned; until then no retry may
+    // run the same step alongside it
+    qWarning() << "[Graph] step" << s.name << "timed out after"
+               << s.opts.timeout.count() << "ms, attempt" << attempt << "- cancelling it";
+    s.token.cancel();
+    s.expired         = true;
+    s.timing.timedOut = true;
+}
+
+void Graph::attemptFailed(StepId id)
+{
+    Step &s = m_steps[id];
+    const int attempt = s.timing.attempts;
+    if (m_failed || m_cancelled || attempt > s.opts.retries) {
+        complete(id, false);
+        return;
+    }
+
+    const auto delay = s.opts.retryDelay * (1 << std::min(attempt - 1, 10));
+    qDebug() << "[Graph] retrying step" << s.name << "in" << delay.count() << "ms";
+    ++m_active;
+    QTimer::singleShot(delay, this, [this, id]() {
+        --m_active;
+        if (m_failed || m_cancelled) complete(id, false);
+        else                         launch(id);
+    });
+}
+
+void Graph::complete(StepId id, bool ok)
+{
+    Step &s = m_steps[id];
+    s.done         = true;
+    s.timing.ok    = ok;
+    s.timing.endMs = m_clock.elapsed();
+    emit stepFinished(s.name, ok);
+
+    if (ok) {
+        --m_remaining;
+        for (StepId n : s.next) {
+            if (--m_steps[n].waiting == 0 && !m_failed && !m_cancelled)
+                launch(n);
+        }
+    } else if (!m_failed) {
+        m_failed = true;
+        qWarning() << "[Graph] step" << s.name << "failed, stopping the graph";
+        for (Step &other : m_steps) {
+            if (other.running)
+                other.token.cancel();
+        }
+    }
+    maybeFinish();
+}
+
+void Graph::maybeFinish()
+{
+    if (m_finished || m_active > 0)
+        return;
+    if (!m_failed && !m_cancelled && m_remaining > 0)
+        return;
+
+    m_finished = true;
+    m_totalMs  = m_clock.elapsed();
+    markCriticalPath();
+
+    const bool ok = !m_failed && !m_cancelled && m_remaining == 0;
+    qDebug().noquote() << "[Graph]" << report();
+    emit finished(ok);
+}
+
+void Graph::markCriticalPath()
+{
+    // the path ends in the step that finished last; walking back, the
+    // dependency that finished last is the one the step waited for
+    StepId cur = -1;
+    for (StepId id = 0; id < m_steps.size(); ++id) {
+        if (m_steps[id].timing.endMs >= 0 &&
+            (cur < 0 || m_steps[id].timing.endMs > m_steps[cur].timing.endMs))
+            cur = id;
+    }
+    while (cur >= 0) {
+        m_steps[cur].timing.critical = true;
+        StepId prev = -1;
+        for (StepId dep : m_steps[cur].after) {
+            if (prev < 0 || m_steps[dep].timing.endMs > m_steps[prev].timing.endMs)
+                prev = dep;
+        }
+        cur = prev;
+    }
+}
+
+QList<Graph::StepTiming> Graph::timings() const
+{
+    QList<StepTiming> list;
+    for (const Step &s : m_steps)
+        list << s.timing;
+    return list;
+}
+
+QString Graph::report() const
+{
+    QStringList path;
+    qint64 workMs = 0;
+    for (const Step &s : m_steps) {
+        if (s.timing.critical)
+            path << s.name;
+        if (s.timing.startMs >= 0 && s.timing.endMs >= 0)
+            workMs += s.timing.endMs - s.timing.startMs;
+    }
+
+    QString out = QString("%1 ms total, %2 ms of step time, critical path: %3")
+                      .arg(elapsedMs()).arg(workMs).arg(path.join(" -> "));
+    for (const Step &s : m_steps) {
+        const StepTiming &t = s.timing;
+        if (t.startMs < 0) {
+            out += QString("\n  %1: not started").arg(t.name);
+            continue;
+        }
+        out += QString("\n  %1%2: %3 .. %4 ms (%5 ms), %6, %7 attempt(s)%8")
+                   .arg(t.critical ? "* " : "  ")
+                   .arg(t.name)
+                   .arg(t.startMs)
+                   .arg(t.endMs)
+                   .arg(t.endMs >= 0 ? t.endMs - t.startMs : -1)
+                   .arg(t.endMs < 0 ? "running" : t.ok ? "ok" : "failed")
+                   .arg(t.attempts)
+                   .arg(t.timedOut ? ", timed out" : "");
+    }
+    return out;
+}
+
+} // namespace Async
+
+/* The path to the generated moc file is provided by CMake/qmake via the
+   include search path, so a plain include works: */
+#include "moc_graph.cpp"
@@ -0,0 +1,154 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <chrono>
+#include <functional>
+#include <type_traits>
+#include "asyncjob.hpp"
+
+namespace Async {
+
+struct StepOptions {
+    /*  per attempt, 0 = none. An attempt that times out counts as
+     *  failed and its token is cancelled; the retry (or the step's
+     *  failure) waits until the step function has returned, so two
+     *  attempts of a step never run at the same time.               */
+    std::chrono::milliseconds timeout {0};
+    int                       retries {0};
+    std::chrono::milliseconds retryDelay {500};   // doubled per retry
+};
+
+/* ------------------------------------------------------------------ */
+/* Dependency graph of steps                                          */
+/*                                                                    */
+/*  A step starts as soon as all steps it comes after have succeeded, */
+/*  so independent branches run in parallel on the Executor. A step  */
+/*  may only come after steps added before it, which keeps the graph */
+/*  acyclic. The first step failing for good stops the graph: steps  */
+/*  not started yet never start, running ones are cancelled and      */
+/*  finished(false) follows once they have returned.                 */
+/*                                                                    */
+/*  Like Chain, the graph lives on the thread that calls start() and  */
+/*  needs its event loop.                                             */
+/* ------------------------------------------------------------------ */
+class Graph : public QObject
+{
+    Q_OBJECT
+public:
+    using StepId = int;
+
+    struct StepTiming {
+        QString name;
+        qint64  startMs  = -1;      // first attempt, relative to start()
+        qint64  endMs    = -1;
+        int     attempts = 0;
+        bool    ok       = false;
+        bool    timedOut = false;
+        bool    critical = false;   // on the path that decided the total time
+    };
+
+    explicit Graph(QObject *p = nullptr) : QObject(p) {}
+    explicit Graph(RunOptions defaults, QObject *p = nullptr)
+        : QObject(p), m_defaults(std::move(defaults)) {}
+
+    /* --------------------------------------------------------------
+     *  add() accepts a functor returning void or bool, taking either
+     *  nothing or the const CancelToken & of the current attempt.
+     *  Returns -1 if a dependency is unknown.
+     * ----------------------------------------------------------- */
+    template<typename F>
+    StepId add(const QString &name, F fn,
+               const QList<StepId> &after = {},
+               StepOptions opts = StepOptions())
+    {
+        auto wrapper = [fn](const CancelToken &token) -> bool {
+            try {
+                if constexpr (std::is_invocable_v<F, const CancelToken &>) {
+                    return toBool([&]() { return fn(token); });
+                } else {
+                    return toBool(fn);
+                }
+            } catch (...) {
+                return false;              // any throw  -> failure
+            }
+        };
+        return addStep(name, std::move(wrapper), after, opts);
+    }
+
+    void start();
+    void cancel();
+
+    bool isRunning() const { return m_started && !m_finished; }
+    qint64 elapsedMs() const { return m_finished ? m_totalMs : m_clock.elapsed(); }
+
+    QList<StepTiming> timings() const;
+    QString report() const;         // timing breakdown, critical path first
+
+signals:
+    void stepFinished(const QString &name, bool ok);
+    void finished(bool ok);
+
+private:
+    using Fn = std::function<bool(const CancelToken &)>;
+
+    struct Step {
+        QString        name;
+        Fn             fn;
+        QList<StepId>  next;
+        StepOptions    opts;
+        int            waiting  = 0;      // unfinished dependencies
+        QList<StepId>  after;
+        CancelToken    token;             // of the current attempt
+        bool           running  = false;
+        bool           expired  = false;  // current attempt timed out
+        bool           done     = false;
+        StepTiming     timing;
+    };
+
+    template<typename G>
+    static bool toBool(G &&g)
+    {
+        using Result = std::invoke_result_t<G>;
+        if constexpr (std::is_same_v<Result, void>) {
+            g();
+            return true;
+        } else {
+            static_assert(std::is_same_v<Result, bool>,
+                          "Graph::add(): functor must return void or bool");
+            return g();
+        }
+    }
+
+    StepId addStep(const QString &name, Fn fn, const QList<StepId> &after,
+                   const StepOptions &opts);
+    void launch(StepId id);
+    void attemptFinished(StepId id, int attempt, bool ok);
+    void attemptTimedOut(StepId id, int attempt);
+    void attemptFailed(StepId id);
+    void complete(StepId id, bool ok);
+    void maybeFinish();
+    void markCriticalPath();
+
+    QVector<Step>   m_steps;
+    RunOptions      m_defaults;
+    QElapsedTimer   m_clock;
+    qint64          m_totalMs   = 0;
+    int             m_remaining = 0;    // steps not succeeded yet
+    int             m_active    = 0;    // running attempts and scheduled retries
+    bool            m_started   = false;
+    bool            m_failed    = false;
+    bool            m_cancelled = false;
+    bool            m_finished  = false;
+};
+
+} // namespace Async
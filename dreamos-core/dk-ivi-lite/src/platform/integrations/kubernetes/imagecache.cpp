@@ -0,0 +1,378 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "imagecache.hpp"
+#include "informer.hpp"
+#include "kubeclient.hpp"
+#include "../../data/datamanager.hpp"
+#include "../../data/jsonstorage.hpp"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+#include <QUrlQuery>
+#include <memory>
+
+using namespace K3s;
+using Core::JsonStorage;
+
+namespace {
+    // an index digest is what containerd records for multi-arch images
+    const QByteArray MANIFEST_TYPES =
+        "application/vnd.oci.image.index.v1+json, "
+        "application/vnd.docker.distribution.manifest.list.v2+json, "
+        "application/vnd.oci.image.manifest.v1+json, "
+        "application/vnd.docker.distribution.manifest.v2+json";
+
+    QMutex s_statsMutex;
+
+    std::unique_ptr<QNetworkReply> finish(QNetworkReply *reply)
+    {
+        if (!reply->isFinished()) {
+            QEventLoop loop;
+            QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        return std::unique_ptr<QNetworkReply>(reply);
+    }
+
+    int httpStatus(const QNetworkReply *reply)
+    {
+        return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* image references                                                   */
+/* ------------------------------------------------------------------ */
+ImageRef ImageRef::parse(const QString &image)
+{
+    ImageRef ref;
+    QString rest = image.trimmed();
+
+    const int at = rest.indexOf('@');
+    if (at >= 0) {
+        ref.digest = rest.mid(at + 1);
+        rest.truncate(at);
+    }
+
+    const int slash = rest.indexOf('/');
+    const QString first = rest.left(slash);
+    if (slash > 0 && (first.contains('.') || first.contains(':') || first == "localhost")) {
+        ref.registry = first;
+        rest = rest.mid(slash + 1);
+    } else {
+        ref.registry = "docker.io";
+    }
+
+    const int colon = rest.lastIndexOf(':');
+    if (colon > rest.lastIndexOf('/')) {
+        ref.tag = rest.mid(colon + 1);
+        rest.truncate(colon);
+    } else if (ref.digest.isEmpty()) {
+        ref.tag = "latest";
+    }
+
+    if (ref.registry == "docker.io" && !rest.contains('/')) {
+        rest.prepend("library/");
+    }
+    ref.repository = rest;
+    return ref;
+}
+
+QString ImageRef::apiHost() const
+{
+    return registry == "docker.io" ? QString("registry-1.docker.io") : registry;
+}
+
+bool ImageRef::isInsecure() const
+{
+    return registry.startsWith("localhost") || registry.startsWith("127.0.0.1");
+}
+
+/* ------------------------------------------------------------------ */
+/* registry                                                           */
+/* ------------------------------------------------------------------ */
+QString ImageCache::remoteDigest(const ImageRef &ref, int timeoutMs)
+{
+    if (!ref.digest.isEmpty()) {
+        return ref.digest;
+    }
+
+    QByteArray token;
+    const auto reply = registryCall(ref, "manifests/" + ref.reference(), true, timeoutMs, &token);
+    if (httpStatus(reply.get()) != 200) {
+        qDebug() << "[ImageCache] No digest for" << reply->url().toString()
+                 << "- HTTP" << httpStatus(reply.get()) << reply->errorString();
+        return QString();
+    }
+    return QString::fromLatin1(reply->rawHeader("Docker-Content-Digest"));
+}
+
+QList<ImageLayer> ImageCache::layers(const ImageRef &ref, const QString &architecture, int timeoutMs)
+{
+    QList<ImageLayer> result;
+    QSet<QString> seen;
+    QByteArray token;
+
+    // an index lists one manifest per platform, each with its own layers
+    QStringList pending{ ref.reference() };
+    bool isIndex = true;
+    while (!pending.isEmpty()) {
+        const auto reply = registryCall(ref, "manifests/" + pending.takeFirst(), false, timeoutMs, &token);
+        if (httpStatus(reply.get()) != 200) {
+            qDebug() << "[ImageCache] No manifest at" << reply->url().toString()
+                     << "- HTTP" << httpStatus(reply.get()) << reply->errorString();
+            return {};
+        }
+        const QJsonObject manifest = QJsonDocument::fromJson(reply->readAll()).object();
+
+        if (manifest.contains("manifests") && isIndex) {
+            for (const QJsonValue &v : manifest.value("manifests").toArray()) {
+                const QJsonObject entry = v.toObject();
+                const QJsonObject platform = entry.value("platform").toObject();
+                if (platform.value("os").toString() == "unknown") {
+                    continue;       // attestations
+                }
+                if (architecture.isEmpty()
+                    || platform.value("architecture").toString() == architecture) {
+                    pending << entry.value("digest").toString();
+                }
+            }
+            isIndex = false;
+            continue;
+        }
+        for (const QJsonValue &v : manifest.value("layers").toArray()) {
+            const QJsonObject layer = v.toObject();
+            const QString digest = layer.value("digest").toString();
+            if (!digest.isEmpty() && !seen.contains(digest)) {
+                seen.insert(digest);
+                result << ImageLayer{ digest, layer.value("size").toInteger() };
+            }
+        }
+    }
+    return result;
+}
+
+bool ImageCache::hasBlob(const ImageRef &ref, const QString &digest, int timeoutMs)
+{
+    QByteArray token;
+    const auto reply = registryCall(ref, "blobs/" + digest, true, timeoutMs, &token);
+    return httpStatus(reply.get()) == 200;
+}
+
+QNetworkAccessManager &ImageCache::manager()
+{
+    // One manager per thread, as KubeClient's: a progress poll asks the
+    // registry every second and keeps its connection. The replies are
+    // done with before their call returns; the GUI thread's manager goes
+    // away with the application.
+    struct Holder {
+        QPointer<QNetworkAccessManager> nam;
+        ~Holder() { if (nam && !nam->parent()) delete nam.data(); }
+    };
+    thread_local Holder holder;
+
+    if (!holder.nam) {
+        auto *nam = new QNetworkAccessManager;
+        if (qApp && QThread::currentThread() == qApp->thread()) {
+            nam->setParent(qApp);
+        }
+        holder.nam = nam;
+    }
+    return *holder.nam;
+}
+
+std::unique_ptr<QNetworkReply> ImageCache::registryCall(const ImageRef &ref, const QString &path,
+                                                        bool headOnly, int timeoutMs,
+                                                        QByteArray *token)
+{
+    const QUrl url(QString("%1://%2/v2/%3/%4")
+                       .arg(ref.isInsecure() ? "http" : "https",
+                            ref.apiHost(), ref.repository, path));
+    // a second round only after an anonymous token was handed out
+    std::unique_ptr<QNetworkReply> reply;
+    for (int round = 0; round < 2; ++round) {
+        QNetworkRequest req(url);
+        req.setRawHeader("Accept", MANIFEST_TYPES);
+        if (!token->isEmpty()) {
+            req.setRawHeader("Authorization", "Bearer " + *token);
+        }
+        req.setTransferTimeout(timeoutMs);
+
+        reply = finish(headOnly ? manager().head(req) : manager().get(req));
+        if (httpStatus(reply.get()) == 401 && token->isEmpty()) {
+            *token = bearerToken(reply->rawHeader("WWW-Authenticate"), timeoutMs);
+            if (!token->isEmpty()) {
+                continue;
+            }
+        }
+        break;
+    }
+    return reply;
+}
+
+QByteArray ImageCache::bearerToken(const QByteArray &challenge, int timeoutMs)
+{
+    // Bearer realm="https://auth.docker.io/token",service="...",scope="..."
+    if (!challenge.startsWith("Bearer ")) {
+        return QByteArray();
+    }
+    QString realm;
+    QUrlQuery query;
+    static const QRegularExpression param(R"re((\w+)="([^"]*)")re");
+    auto it = param.globalMatch(QString::fromLatin1(challenge.mid(7)));
+    while (it.hasNext()) {
+        const auto m = it.next();
+        if (m.captured(1) == "realm") {
+            realm = m.captured(2);
+        } else {
+            query.addQueryItem(m.captured(1), m.captured(2));
+        }
+    }
+    if (realm.isEmpty()) {
+        return QByteArray();
+    }
+
+    QUrl url(realm);
+    url.setQuery(query);
+    QNetworkRequest req(url);
+    req.setTransferTimeout(timeoutMs);
+
+    const auto reply = finish(manager().get(req));
+    const QJsonObject o = QJsonDocument::fromJson(reply->readAll()).object();
+    const QString token = o.value("token").toString(o.value("access_token").toString());
+    return token.toLatin1();
+}
+
+/* ------------------------------------------------------------------ */
+/* presence                                                           */
+/* ------------------------------------------------------------------ */
+bool ImageCache::presentOnNode(const QString &node, const ImageRef &ref, const QString &digest,
+                               const QString &mirrorImage)
+{
+    if (digest.isEmpty()) {
+        return false;
+    }
+
+    std::optional<QJsonObject> object;
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Node)) {
+        object = informer->get(Kind::Node, node);
+    } else {
+        const KubeResult r = KubeClient::instance().get(Kind::Node, node);
+        if (r.ok) {
+            object = r.object;
+        }
+    }
+    if (!object) {
+        return false;
+    }
+
+    // The deployment refers to the tag with IfNotPresent, so the tag must
+    // be there and point at the registry's current digest. Nodes report a
+    // limited number of images; one missing from the list is pulled.
+    QList<ImageRef> refs { ref };
+    if (!mirrorImage.isEmpty()) {
+        refs << ImageRef::parse(mirrorImage);
+    }
+    const QJsonArray images = object->value("status").toObject().value("images").toArray();
+    for (const QJsonValue &v : images) {
+        const QJsonArray names = v.toObject().value("names").toArray();
+        for (const ImageRef &r : refs) {
+            const QString byDigest = r.name() + "@" + digest;
+            const QString byTag    = r.name() + ":" + r.tag;
+            if (names.contains(QJsonValue(byDigest))
+                && (r.tag.isEmpty() || names.contains(QJsonValue(byTag)))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ImagePresence ImageCache::probe(const QString &image, const QString &node,
+                                const QString &mirrorImage)
+{
+    ImagePresence presence;
+    const ImageRef ref = ImageRef::parse(image);
+    presence.digest = remoteDigest(ref);
+    if (presence.digest.isEmpty()) {
+        return presence;
+    }
+
+    presence.onNode = presentOnNode(node, ref, presence.digest, mirrorImage);
+    if (!presence.onNode && !mirrorImage.isEmpty()) {
+        // skopeo copy --all keeps the digest
+        presence.inLocalRegistry = remoteDigest(ImageRef::parse(mirrorImage)) == presence.digest;
+    }
+
+    qDebug() << "[ImageCache]" << image << presence.digest
+             << "on" << node << ":" << presence.onNode
+             << "in local registry:" << presence.inLocalRegistry;
+    return presence;
+}
+
+/* ------------------------------------------------------------------ */
+/* statistics                                                         */
+/* ------------------------------------------------------------------ */
+QString ImageCache::statsFile()
+{
+    return DK_CONTAINER_ROOT + "dk_marketplace/image_transfers.json";
+}
+
+void ImageCache::recordTransfer(const QString &image, const QString &step, qint64 ms)
+{
+    QMutexLocker locker(&s_statsMutex);
+    QJsonObject stats = JsonStorage::load(statsFile(), QJsonObject()).object();
+    QJsonObject images = stats.value("images").toObject();
+    QJsonObject entry = images.value(image).toObject();
+    entry[step] = ms;
+    images[image] = entry;
+    stats["images"] = images;
+    JsonStorage::save(statsFile(), QJsonDocument(stats));
+}
+
+qint64 ImageCache::recordSkip(const QString &image, const QString &step)
+{
+    QMutexLocker locker(&s_statsMutex);
+    QJsonObject stats = JsonStorage::load(statsFile(), QJsonObject()).object();
+    const QJsonObject images = stats.value("images").toObject();
+
+    // the image's own last transfer, else the average of all images
+    qint64 saved = images.value(image).toObject().value(step).toInteger();
+    if (saved <= 0) {
+        qint64 sum = 0;
+        int count = 0;
+        for (const QJsonValue &v : images) {
+            const qint64 ms = v.toObject().value(step).toInteger();
+            if (ms > 0) {
+                sum += ms;
+                ++count;
+            }
+        }
+        saved = count ? sum / count : 0;
+    }
+
+    QJsonObject totals = stats.value("saved").toObject();
+    totals[step + "Ms"] = totals.value(step + "Ms").toInteger() + saved;
+    totals[step + "Skips"] = totals.value(step + "Skips").toInt() + 1;
+    stats["saved"] = totals;
+    JsonStorage::save(statsFile(), QJsonDocument(stats));
+    return saved;
+}
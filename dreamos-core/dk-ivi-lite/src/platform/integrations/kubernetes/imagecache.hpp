@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+// k3s/imagecache.hpp
+//
+// Decides whether the pull and mirror jobs of an install can be left out:
+// the image's digest is resolved at its registry and looked up in the
+// image list the node reports (status.images, i.e. what containerd has)
+// and in the local registry the mirror job copies to. Also keeps the
+// measured transfer times, to know what a skipped job saved.
+//
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+namespace K3s {
+
+struct ImageRef {
+    QString registry;       // docker.io for images without one
+    QString repository;     // library/ prefixed for official Docker Hub images
+    QString tag;            // latest if neither tag nor digest is given
+    QString digest;         // set when the reference is pinned
+
+    static ImageRef parse(const QString &image);
+
+    QString apiHost() const;        // registry-1.docker.io for docker.io
+    QString name() const { return registry + "/" + repository; }   // as containerd lists it
+    QString reference() const { return digest.isEmpty() ? tag : digest; }
+    bool    isInsecure() const;     // localhost registries speak plain http
+};
+
+struct ImagePresence {
+    QString digest;                 // empty if it could not be resolved
+    bool    onNode          = false;
+    bool    inLocalRegistry = false;
+};
+
+struct ImageLayer {
+    QString digest;
+    qint64  size = 0;               // compressed, as transferred
+};
+
+class ImageCache
+{
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 8000;
+
+    /*  Blocking, for the Async pools. Without a digest nothing counts
+     *  as present: a tag alone may have moved on at the registry.    */
+    static ImagePresence probe(const QString &image, const QString &node,
+                               const QString &mirrorImage = QString());
+
+    // manifest digest as the registry serves it, anonymous token auth included
+    static QString remoteDigest(const ImageRef &ref, int timeoutMs = DEFAULT_TIMEOUT_MS);
+    // a remote node pulls from the local registry and lists the image under
+    // its mirrored name; both names are looked for
+    static bool presentOnNode(const QString &node, const ImageRef &ref, const QString &digest,
+                              const QString &mirrorImage = QString());
+    // layers of the platform with the given architecture (amd64, arm64, ...),
+    // of every platform if it is empty; empty on any error
+    static QList<ImageLayer> layers(const ImageRef &ref, const QString &architecture,
+                                    int timeoutMs = DEFAULT_TIMEOUT_MS);
+    static bool hasBlob(const ImageRef &ref, const QString &digest,
+                        int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /* ---- transfer statistics, <root>/dk_marketplace/image_transfers.json ---- */
+    // step is "pull" or "mirror"
+    static void recordTransfer(const QString &image, const QString &step, qint64 ms);
+    // returns the estimated time saved in ms, 0 if nothing was measured yet
+    static qint64 recordSkip(const QString &image, const QString &step);
+
+private:
+    // GET or HEAD <registry>/v2/<repository>/<path>, answering a bearer challenge once
+    static std::unique_ptr<QNetworkReply> registryCall(const ImageRef &ref, const QString &path,
+                                                       bool headOnly, int timeoutMs,
+                                                       QByteArray *token);
+    static QByteArray bearerToken(const QByteArray &challenge, int timeoutMs);
+    static QString statsFile();
+    static QNetworkAccessManager &manager();
+};
+
+} // namespace K3s
@@ -0,0 +1,376 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "informer.hpp"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <utility>
+
+using namespace K3s;
+
+namespace {
+    const char *kindName(Kind kind)
+    {
+        switch (kind) {
+        case Kind::Deployment: return "deployments";
+        case Kind::Pod:        return "pods";
+        case Kind::Node:       return "nodes";
+        case Kind::Job:        return "jobs";
+        }
+        return "?";
+    }
+
+    QString nameOf(const QJsonObject &object)
+    {
+        return object.value("metadata").toObject().value("name").toString();
+    }
+
+    QString resourceVersionOf(const QJsonObject &object)
+    {
+        return object.value("metadata").toObject().value("resourceVersion").toString();
+    }
+}
+
+Informer *Informer::instance()
+{
+    // the first call may come from a pool thread, the initialization is
+    // thread safe. Qt refuses a parent living in another thread, so off the
+    // GUI thread the informer is moved there first and parented from there.
+    static Informer *const informer = []() {
+        if (QThread::currentThread() == qApp->thread()) {
+            return new Informer(qApp);
+        }
+        auto *i = new Informer();
+        i->moveToThread(qApp->thread());
+        QMetaObject::invokeMethod(qApp, [i]() { i->setParent(qApp); }, Qt::QueuedConnection);
+        return i;
+    }();
+    return informer;
+}
+
+Informer::Informer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void Informer::start()
+{
+    if (m_running) {
+        return;
+    }
+    if (!KubeClient::instance().isAvailable()) {
+        qWarning() << "[Informer] Kubernetes API unavailable, callers keep polling";
+        return;
+    }
+    m_running = true;
+    for (Kind kind : { Kind::Deployment, Kind::Pod, Kind::Node, Kind::Job }) {
+        relist(kind);
+    }
+}
+
+void Informer::stop()
+{
+    m_running = false;
+    for (Store &store : m_stores) {
+        if (store.watch) {
+            QNetworkReply *reply = std::exchange(store.watch, nullptr);
+            reply->abort();
+            reply->deleteLater();
+        }
+    }
+    QWriteLocker locker(&m_lock);
+    for (Store &store : m_stores) {
+        store.synced = false;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* list and watch                                                     */
+/* ------------------------------------------------------------------ */
+Async::Task<> Informer::relist(Kind kind)
+{
+    QPointer<Informer> self(this);
+    const KubeResult r = co_await KubeClient::instance().requestAsync(
+        "GET", KubeClient::resourcePath(kind));
+    if (!self || !m_running) {
+        co_return;
+    }
+    if (!r.ok) {
+        qWarning() << "[Informer] Listing" << kindName(kind) << "failed:" << r.error;
+        retryLater(kind);
+        co_return;
+    }
+
+    replaceAll(kind, r.items(), resourceVersionOf(r.object));
+    emit synced(kind);
+    startWatch(kind);
+}
+
+void Informer::startWatch(Kind kind)
+{
+    Store &store = m_stores[index(kind)];
+    store.buffer.clear();
+    store.expired = false;
+    store.watch   = KubeClient::instance().watch(kind, store.resourceVersion);
+    if (!store.watch) {
+        retryLater(kind);
+        return;
+    }
+
+    connect(store.watch, &QNetworkReply::readyRead, this, [this, kind]() { onWatchData(kind); });
+    connect(store.watch, &QNetworkReply::finished,  this, [this, kind]() { onWatchEnded(kind); });
+}
+
+void Informer::onWatchData(Kind kind)
+{
+    Store &store = m_stores[index(kind)];
+    if (!store.watch) {
+        return;
+    }
+    store.buffer += store.watch->readAll();
+
+    int newline;
+    while ((newline = store.buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = store.buffer.left(newline).trimmed();
+        store.buffer.remove(0, newline + 1);
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        const QJsonObject event  = QJsonDocument::fromJson(line).object();
+        const QString     type   = event.value("type").toString();
+        const QJsonObject object = event.value("object").toObject();
+
+        if (type == "ERROR") {
+            // 410 Gone: the resourceVersion is too old to resume from
+            qDebug() << "[Informer] Watch of" << kindName(kind) << "ended:"
+                     << object.value("message").toString();
+            store.expired = true;
+            store.watch->abort();
+            return;
+        }
+
+        store.backoffMs = 1000;
+        const QString rv = resourceVersionOf(object);
+        if (!rv.isEmpty()) {
+            store.resourceVersion = rv;
+        }
+        if (type != "BOOKMARK") {
+            applyEvent(kind, type, object);
+        }
+    }
+}
+
+void Informer::onWatchEnded(Kind kind)
+{
+    Store &store = m_stores[index(kind)];
+    QNetworkReply *reply = std::exchange(store.watch, nullptr);
+    if (!reply) {
+        return;             // stopped
+    }
+    const bool failed = reply->error() != QNetworkReply::NoError;
+    const QString error = reply->errorString();
+    reply->deleteLater();
+    if (!m_running) {
+        return;
+    }
+
+    if (store.expired) {
+        relist(kind);
+    } else if (failed) {
+        qWarning() << "[Informer] Watch of" << kindName(kind) << "failed:" << error;
+        {
+            // the cache may miss events until the relist
+            QWriteLocker locker(&m_lock);
+            m_stores[index(kind)].synced = false;
+        }
+        retryLater(kind);
+    } else {
+        startWatch(kind);   // the server closed it after timeoutSeconds
+    }
+}
+
+void Informer::retryLater(Kind kind)
+{
+    Store &store = m_stores[index(kind)];
+    const int delay = store.backoffMs;
+    store.backoffMs = std::min(store.backoffMs * 2, MAX_BACKOFF_MS);
+    QTimer::singleShot(delay, this, [this, kind]() {
+        if (m_running) {
+            relist(kind);
+        }
+    });
+}
+
+/* ------------------------------------------------------------------ */
+/* cache                                                              */
+/* ------------------------------------------------------------------ */
+void Informer::replaceAll(Kind kind, const QJsonArray &items, const QString &resourceVersion)
+{
+    QHash<QString, QJsonObject> fresh;
+    for (const QJsonValue &v : items) {
+        const QJsonObject object = v.toObject();
+        fresh.insert(nameOf(object), object);
+    }
+
+    QHash<QString, QJsonObject> previous;
+    {
+        QWriteLocker locker(&m_lock);
+        Store &store = m_stores[index(kind)];
+        previous = std::exchange(store.objects, fresh);
+        store.resourceVersion = resourceVersion;
+        store.synced = true;
+    }
+    wakeWaiters();
+
+    // deltas against what was cached before the relist
+    for (auto it = fresh.cbegin(); it != fresh.cend(); ++it) {
+        const auto old = previous.constFind(it.key());
+        if (old == previous.cend()) {
+            notify(kind, it.key(), std::nullopt, it.value());
+        } else if (resourceVersionOf(old.value()) != resourceVersionOf(it.value())) {
+            notify(kind, it.key(), old.value(), it.value());
+        }
+    }
+    for (auto it = previous.cbegin(); it != previous.cend(); ++it) {
+        if (!fresh.contains(it.key())) {
+            notify(kind, it.key(), it.value(), std::nullopt);
+        }
+    }
+}
+
+void Informer::applyEvent(Kind kind, const QString &type, const QJsonObject &object)
+{
+    const QString name = nameOf(object);
+    std::optional<QJsonObject> before;
+    std::optional<QJsonObject> after;
+
+    {
+        QWriteLocker locker(&m_lock);
+        QHash<QString, QJsonObject> &objects = m_stores[index(kind)].objects;
+        const auto it = objects.constFind(name);
+        if (it != objects.cend()) {
+            before = it.value();
+        }
+        if (type == "DELETED") {
+            objects.remove(name);
+        } else {
+            objects.insert(name, object);
+            after = object;
+        }
+    }
+    wakeWaiters();
+    notify(kind, name, before, after);
+}
+
+void Informer::notify(Kind kind, const QString &name,
+                      const std::optional<QJsonObject> &before,
+                      const std::optional<QJsonObject> &after)
+{
+    if (after) {
+        emit changed(kind, name, *after);
+    } else {
+        emit removed(kind, name);
+    }
+
+    if (kind == Kind::Deployment) {
+        const bool was = before && KubeClient::deploymentAvailable(*before);
+        const bool is  = after && KubeClient::deploymentAvailable(*after);
+        if (!before || was != is) {
+            emit deploymentAvailabilityChanged(name, is);
+        }
+    } else if (kind == Kind::Node) {
+        const bool was = before && KubeClient::nodeReady(*before);
+        const bool is  = after && KubeClient::nodeReady(*after);
+        if (!before || was != is) {
+            emit nodeReadinessChanged(name, is);
+        }
+    }
+}
+
+void Informer::wakeWaiters()
+{
+    // taking the mutex orders the wake after a waiter's last check
+    QMutexLocker locker(&m_waitMutex);
+    m_changedCond.wakeAll();
+}
+
+/* ------------------------------------------------------------------ */
+/* reads                                                              */
+/* ------------------------------------------------------------------ */
+bool Informer::isSynced(Kind kind) const
+{
+    QReadLocker locker(&m_lock);
+    return m_stores[index(kind)].synced;
+}
+
+std::optional<QJsonObject> Informer::get(Kind kind, const QString &name) const
+{
+    QReadLocker locker(&m_lock);
+    const QHash<QString, QJsonObject> &objects = m_stores[index(kind)].objects;
+    const auto it = objects.constFind(name);
+    if (it == objects.cend()) {
+        return std::nullopt;
+    }
+    return it.value();
+}
+
+QList<QJsonObject> Informer::list(Kind kind) const
+{
+    QReadLocker locker(&m_lock);
+    return m_stores[index(kind)].objects.values();
+}
+
+QList<QJsonObject> Informer::podsOf(const QString &app) const
+{
+    return podsLabelled("app", app);
+}
+
+QList<QJsonObject> Informer::podsLabelled(const QString &key, const QString &value) const
+{
+    QList<QJsonObject> pods;
+    QReadLocker locker(&m_lock);
+    for (const QJsonObject &pod : m_stores[index(Kind::Pod)].objects) {
+        const QJsonObject labels = pod.value("metadata").toObject().value("labels").toObject();
+        if (labels.value(key).toString() == value) {
+            pods << pod;
+        }
+    }
+    return pods;
+}
+
+bool Informer::waitFor(Kind kind, const QString &name, const Predicate &pred, int timeoutMs) const
+{
+    return waitUntil([&]() { return pred(get(kind, name)); }, timeoutMs);
+}
+
+bool Informer::waitUntil(const std::function<bool()> &condition, int timeoutMs) const
+{
+    if (QThread::currentThread() == thread()) {
+        qWarning() << "[Informer] waitUntil() on the GUI thread would block the watches";
+        return condition();
+    }
+
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&m_waitMutex);
+    for (;;) {
+        if (condition()) {
+            return true;
+        }
+        if (!m_changedCond.wait(&m_waitMutex, deadline)) {
+            return condition();
+        }
+    }
+}
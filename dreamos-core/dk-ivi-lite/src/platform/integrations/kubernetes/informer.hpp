@@ -0,0 +1,104 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+// k3s/informer.hpp
+//
+// Lists deployments, pods and jobs of the default namespace and the
+// cluster's nodes once, then follows their watch streams and keeps an
+// in-memory copy. Changes are pushed as signals; reads never go to the
+// API server.
+//
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QWaitCondition>
+#include <array>
+#include <functional>
+#include <optional>
+#include "kubeclient.hpp"
+
+namespace K3s {
+
+class Informer : public QObject
+{
+    Q_OBJECT
+public:
+    using Predicate = std::function<bool(const std::optional<QJsonObject> &)>;
+
+    // lives on the GUI thread, which runs the watches
+    static Informer *instance();
+
+    void start();
+    void stop();
+
+    /* ---- reads: any thread ---- */
+    // false before the first list and while a broken watch is relisted
+    bool isSynced(Kind kind) const;
+    std::optional<QJsonObject> get(Kind kind, const QString &name) const;
+    QList<QJsonObject> list(Kind kind) const;
+    QList<QJsonObject> podsOf(const QString &app) const;     // by the "app" label
+    QList<QJsonObject> podsLabelled(const QString &key, const QString &value) const;
+
+    /*  Blocks a pool thread until pred holds for the named object
+     *  (std::nullopt while it does not exist) or timeoutMs passed.
+     *  Returns whether pred held. Not for the GUI thread.          */
+    bool waitFor(Kind kind, const QString &name, const Predicate &pred, int timeoutMs) const;
+    // same for a condition over several objects, re-evaluated on every change
+    bool waitUntil(const std::function<bool()> &condition, int timeoutMs) const;
+
+signals:
+    void synced(K3s::Kind kind);
+    void changed(K3s::Kind kind, const QString &name, const QJsonObject &object);
+    void removed(K3s::Kind kind, const QString &name);
+
+    // derived from the above, emitted when first seen and on change
+    void deploymentAvailabilityChanged(const QString &name, bool available);
+    void nodeReadinessChanged(const QString &name, bool ready);
+
+private:
+    static constexpr int KINDS = 4;
+    static constexpr int MAX_BACKOFF_MS = 30000;
+
+    struct Store {
+        QHash<QString, QJsonObject> objects;
+        QString                     resourceVersion;
+        bool                        synced  = false;
+        bool                        expired = false;    // 410 Gone, relist
+        QNetworkReply              *watch   = nullptr;
+        QByteArray                  buffer;              // partial event line
+        int                         backoffMs = 1000;
+    };
+
+    explicit Informer(QObject *parent = nullptr);
+
+    static int index(Kind kind) { return static_cast<int>(kind); }
+
+    Async::Task<> relist(Kind kind);
+    void startWatch(Kind kind);
+    void onWatchData(Kind kind);
+    void onWatchEnded(Kind kind);
+    void retryLater(Kind kind);
+
+    void replaceAll(Kind kind, const QJsonArray &items, const QString &resourceVersion);
+    void applyEvent(Kind kind, const QString &type, const QJsonObject &object);
+    void notify(Kind kind, const QString &name,
+                const std::optional<QJsonObject> &before,
+                const std::optional<QJsonObject> &after);
+    void wakeWaiters();
+
+    std::array<Store, KINDS>    m_stores;
+    mutable QReadWriteLock      m_lock;         // objects and synced flags
+    mutable QMutex              m_waitMutex;
+    mutable QWaitCondition      m_changedCond;
+    bool                        m_running = false;
+};
+
+} // namespace K3s
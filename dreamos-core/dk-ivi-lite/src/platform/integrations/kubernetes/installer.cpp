@@ -6,10 +6,45 @@
 // 
 // SPDX-License-Identifier: MIT
 #include "installer.hpp"
+#include "informer.hpp"
+#include "kubeclient.hpp"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QThread>
 
 using namespace K3s;
 
+namespace {
+    // kubectl is the fallback when the Kubernetes API is not reachable
+    bool runKubectl(const QStringList &args, int timeoutSec, QString *output)
+    {
+        QProcess proc;
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        QString path = env.value("PATH");
+        if (!path.contains("/usr/local/bin"))
+            path += ":/usr/local/bin";
+        env.insert("PATH", path);
+        proc.setProcessEnvironment(env);
+        proc.setProcessChannelMode(QProcess::MergedChannels);
+
+        proc.start("kubectl", args);
+        if (!proc.waitForStarted(1000)) {
+            qWarning() << "[Installer] kubectl did not start";
+            return false;
+        }
+        if (!proc.waitForFinished((timeoutSec + 1) * 1000)) {
+            qWarning() << "[Installer] kubectl timed out after" << timeoutSec << "seconds";
+            proc.kill();
+            proc.waitForFinished(1000);
+            return false;
+        }
+        if (output)
+            *output = QString::fromUtf8(proc.readAll()).trimmed();
+        return proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
+    }
+}
+
 Installer::Installer(QObject *p) : QObject(p)
 {
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
@@ -125,69 +160,30 @@ bool Installer::nodeReady(const QString &nodeName,
                           int timeoutSec,
                           QString *stdoutText)
 {
-    QProcess proc;
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    QString p = env.value("PATH");
-    if (!p.contains("/usr/local/bin"))
-        p += ":/usr/local/bin";
-    env.insert("PATH", p);
-    proc.setProcessEnvironment(env);
-
-    /* ask for full JSON to avoid shell quoting hell                */
-    proc.setProgram("kubectl");
-    proc.setArguments({ "get", "node", nodeName, "-o", "json" });
-    proc.setProcessChannelMode(QProcess::MergedChannels);
-
-    proc.start();
-    if (!proc.waitForStarted(1000)) {
-        qWarning() << "[Installer::nodeReady] kubectl not start";
-        return false;
-    }
-    
-    // Use a shorter, non-blocking approach
-    bool finished = proc.waitForFinished(timeoutSec * 1000);
-    if (!finished) {
-        qWarning() << "[Installer::nodeReady] kubectl timed out after" << timeoutSec << "seconds";
-        proc.kill();
-        proc.waitForFinished(1000); // Brief wait for cleanup
-        return false;
+    if (!KubeClient::instance().isAvailable()) {
+        QString out;
+        const bool ok = runKubectl({ "get", "node", nodeName, "-o", "json",
+                                     QString("--request-timeout=%1s").arg(timeoutSec) },
+                                   timeoutSec, &out);
+        if (stdoutText)
+            *stdoutText = out;
+        /* strip everything before the first "{" so that QJson parses cleanly */
+        const int brace = out.indexOf('{');
+        const QJsonDocument doc = QJsonDocument::fromJson(out.mid(brace < 0 ? 0 : brace).toUtf8());
+        return ok && doc.isObject() && KubeClient::nodeReady(doc.object());
     }
 
-    QByteArray raw = proc.readAll();          // may contain noise
+    const KubeResult r = KubeClient::instance().get(Kind::Node, nodeName, QString(),
+                                                    timeoutSec * 1000);
     if (stdoutText)
-        *stdoutText = QString::fromUtf8(raw);
-
-    // Check exit code first
-    if (proc.exitCode() != 0) {
-        qDebug() << "[Installer::nodeReady] kubectl failed with exit code:" << proc.exitCode();
-        return false;
-    }
-
-    /* strip everything before first "{" so that QJson parses cleanly */
-    int pos = raw.indexOf('{');
-    if (pos < 0) {
-        qWarning() << "[Installer::nodeReady] no JSON found";
-        return false;
-    }
-    QByteArray jsonPart = raw.mid(pos);
+        *stdoutText = r.ok ? QString::fromUtf8(QJsonDocument(r.object).toJson())
+                           : r.error;
 
-    const QJsonDocument doc = QJsonDocument::fromJson(jsonPart);
-    if (doc.isNull() || !doc.isObject()) {
-        qWarning() << "[Installer::nodeReady] invalid JSON";
+    if (!r.ok) {
+        qDebug() << "[Installer::nodeReady]" << nodeName << "not readable:" << r.error;
         return false;
     }
-
-    const QJsonArray conditions =
-            doc["status"].toObject()
-               ["conditions"].toArray();
-
-    for (const QJsonValue &v : conditions) {
-        const QJsonObject o = v.toObject();
-        if (o["type"] == QLatin1String("Ready"))
-            return o["status"] == QLatin1String("True");
-    }
-    qWarning() << "[Installer::nodeReady] Ready condition missing";
-    return false;
+    return KubeClient::nodeReady(r.object);
 }
 
 /* static */
@@ -204,45 +200,49 @@ bool Installer::deploymentAvailable(const QString &deploymentId,
                                     int timeoutSec,
                                     QString *stdoutText)
 {
-    // 1) prepare env   make sure kubectl is found
-    QProcess proc;
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    QString p = env.value("PATH");
-    if (!p.contains("/usr/local/bin"))
-        p += ":/usr/local/bin";
-    env.insert("PATH", p);
-    proc.setProcessEnvironment(env);
-
-    // 2) configure the command
-    proc.setProgram("kubectl");
-    proc.setArguments({ "wait",
-                        "--for=condition=available",
-                        "deployment/" + deploymentId,
-                        QString("--timeout=%1s").arg(timeoutSec) });
-    proc.setProcessChannelMode(QProcess::MergedChannels);
-
-    // 3) run synchronously
-    proc.start();
-    if (!proc.waitForStarted(1000)) {
-        qWarning() << "[Installer] kubectl did not start";
-        return false;
+    // same as kubectl wait --for=condition=available: poll until the
+    // condition is met, the deployment is missing or time is up
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Deployment) && QThread::currentThread() != informer->thread()) {
+        // woken by the deployment's watch events instead of polling;
+        // a missing deployment ends the wait like a failed get below
+        std::optional<QJsonObject> last;
+        informer->waitFor(Kind::Deployment, deploymentId,
+            [&last](const std::optional<QJsonObject> &deployment) {
+                last = deployment;
+                return !deployment || KubeClient::deploymentAvailable(*deployment);
+            }, timeoutSec * 1000);
+        const bool ok = last && KubeClient::deploymentAvailable(*last);
+        if (stdoutText)
+            *stdoutText = ok   ? QString("deployment.apps/%1 condition met").arg(deploymentId)
+                        : last ? QString("timed out waiting for deployment.apps/%1").arg(deploymentId)
+                               : QString("deployments.apps \"%1\" not found").arg(deploymentId);
+        return ok;
     }
-    proc.waitForFinished((timeoutSec + 1) * 1000);   // block
 
-    // 4) collect output and evaluate result
-    const QString out = QString::fromUtf8(proc.readAll()).trimmed();
-    if (stdoutText)
-        *stdoutText = out;
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        return runKubectl({ "wait", "--for=condition=available", "deployment/" + deploymentId,
+                            QString("--timeout=%1s").arg(timeoutSec) },
+                          timeoutSec, stdoutText);
+    }
 
-    const bool ok = proc.exitStatus() == QProcess::NormalExit
-                    && proc.exitCode() == 0;
+    QElapsedTimer clock;
+    clock.start();
 
-    // if (!ok)
-    //     qWarning() << "[Installer] kubectl wait failed for" << deploymentId
-    //                << "exitCode=" << proc.exitCode()
-    //                << "output:"   << out;
+    for (;;) {
+        const KubeResult r = kube.get(Kind::Deployment, deploymentId);
+        const bool ok = r.ok && KubeClient::deploymentAvailable(r.object);
 
-    return ok;
+        if (ok || !r.ok || clock.elapsed() >= timeoutSec * 1000) {
+            if (stdoutText)
+                *stdoutText = ok   ? QString("deployment.apps/%1 condition met").arg(deploymentId)
+                            : r.ok ? QString("timed out waiting for deployment.apps/%1").arg(deploymentId)
+                                   : r.error;
+            return ok;
+        }
+        QThread::msleep(1000);
+    }
 }
 
 Async::Job<DeploymentCheck>*
@@ -36,7 +36,7 @@ public:
                          QString *stdoutText = nullptr,
                          QString *stderrText = nullptr);
     
-    // Returns true if `kubectl get node <name>` reports the node Ready.
+    // Returns true if the API server reports the node Ready.
     static bool nodeReady(const QString &nodeName,
         int timeoutSec = 5,
         QString *stdoutText = nullptr);
@@ -45,8 +45,8 @@ public:
                         int timeoutSec = 5,
                         QObject *parent = nullptr);
 
-    // Convenience: return true if kubectl reports the deployment to be
-    // available (≥1 ready replica) within <timeoutSec> seconds.
+    // Convenience: return true if the API server reports the deployment
+    // to be available (≥1 ready replica) within <timeoutSec> seconds.
     static bool deploymentAvailable(const QString &deploymentId,
         int timeoutSec = 10,
         QString *stdoutText = nullptr);
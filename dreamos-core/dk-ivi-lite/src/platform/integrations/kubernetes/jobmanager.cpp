@@ -6,15 +6,86 @@
 // 
 // SPDX-License-Identifier: MIT
 #include "jobmanager.hpp"
+#include <QDeadlineTimer>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QThread>
 #include <QCoreApplication>
+#include <QHash>
 #include <QMetaObject>
 #include <QMutexLocker>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 #include "../../notifications/notificationmanager.hpp"
+#include "informer.hpp"
+#include "kubeclient.hpp"
+#include "manifestbuilder.hpp"
 
 using namespace K3s;
 
+namespace {
+    // Installs, deployments and restarts block on kubectl for minutes; the
+    // background lane keeps them off the threads of interactive work.
+    Async::RunOptions longRunning() { return { Async::Pool::Io, Async::Priority::Background }; }
+    // kubectl queries whose result the UI is waiting for
+    Async::RunOptions check()       { return { Async::Pool::Io, Async::Priority::Normal }; }
+    // nothing to run, only reports "busy" back
+    Async::RunOptions immediate()   { return { Async::Pool::Cpu, Async::Priority::Interactive }; }
+    
+    QProcessEnvironment commandEnvironment()
+    {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        QString path = env.value("PATH");
+        if (!path.contains("/usr/local/bin")) {
+            path += ":/usr/local/bin";
+        }
+        env.insert("PATH", path);
+        return env;
+    }
+    
+    int commandTimeoutMs(const QString &command)
+    {
+        if (command.contains("kubectl wait")) {
+            return 300000; // 5 minutes for wait commands
+        } else if (command.contains("kubectl apply")) {
+            return 60000; // 1 minute for apply commands
+        } else if (command.contains("get node")) {
+            return 10000; // 10 seconds for node checks
+        }
+        return 30000; // default 30 seconds
+    }
+    
+    // A Job's pods carry its uid; a pod of an earlier Job of the same name
+    // may still be around after that Job was deleted
+    bool ownedByJob(const QJsonObject &pod, const QString &jobUid)
+    {
+        const QJsonObject metadata = pod.value("metadata").toObject();
+        const QJsonObject labels = metadata.value("labels").toObject();
+        if (labels.value("batch.kubernetes.io/controller-uid").toString() == jobUid
+            || labels.value("controller-uid").toString() == jobUid) {
+            return true;
+        }
+        for (const QJsonValue &owner : metadata.value("ownerReferences").toArray()) {
+            if (owner.toObject().value("uid").toString() == jobUid) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    JobManager::JobResult fromKube(const KubeResult &kube)
+    {
+        JobManager::JobResult result;
+        result.success = kube.ok;
+        result.errorMessage = kube.error;
+        return result;
+    }
+}
+
 // Static members
 QMutex JobManager::s_instanceMutex;
 JobManager* JobManager::s_instance = nullptr;
@@ -28,6 +99,28 @@ JobManager::JobManager(QObject *parent)
     connect(m_installer, &Installer::finished,
             this, &JobManager::onInstallerFinished);
     
+    // Per-node concurrency: the vip ECU has less headroom than xip
+    m_nodeLimits = { { "xip", 2 }, { "vip", 1 } };
+    const QStringList limits = qEnvironmentVariable("DK_NODE_CONCURRENCY").split(',', Qt::SkipEmptyParts);
+    for (const QString &limit : limits) {
+        const QStringList kv = limit.split('=');
+        if (kv.size() == 2 && kv[1].trimmed().toInt() > 0) {
+            m_nodeLimits[kv[0].trimmed()] = kv[1].trimmed().toInt();
+        }
+    }
+    const QHash<QString, int> configured = m_nodeLimits;
+    for (auto it = configured.cbegin(); it != configured.cend(); ++it) {
+        setNodeConcurrency(it.key(), it.value());
+    }
+    
+    // Status changes arrive from the watch streams instead of being polled
+    Informer *informer = Informer::instance();
+    connect(informer, &Informer::deploymentAvailabilityChanged,
+            this, &JobManager::deploymentStatusChanged);
+    connect(informer, &Informer::nodeReadinessChanged,
+            this, &JobManager::nodeStatusChanged);
+    informer->start();
+    
     qDebug() << "[JobManager] Initialized with state management";
 }
 
@@ -55,22 +148,24 @@ JobManager* JobManager::instance()
 
 bool JobManager::tryAcquireState(State newState, const QString &operation)
 {
-    QMutexLocker locker(&m_stateMutex);
-    
-    if (m_state != State::Idle) {
-        QString reason = QString("JobManager busy with: %1 (requested: %2)")
-            .arg(m_currentOperation, operation);
-        qWarning() << "[JobManager]" << reason;
-        emit requestRejected(reason);
-        return false;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        
+        if (m_state != State::Idle || !m_waiting.isEmpty()) {
+            QString reason = QString("JobManager busy with: %1 (requested: %2)")
+                .arg(m_currentOperation.isEmpty() ? QString("queued operations") : m_currentOperation,
+                     operation);
+            qWarning() << "[JobManager]" << reason;
+            locker.unlock();
+            emit requestRejected(reason);
+            return false;
+        }
+        
+        m_exclusive = newState;
+        m_exclusiveOperation = operation;
     }
     
-    m_state = newState;
-    m_currentOperation = operation;
-    
-    emit busyChanged(true);
-    emit stateChanged(newState);
-    emit currentOperationChanged(operation);
+    updateState();
     emit jobStarted(operation);
     
     qDebug() << "[JobManager] State acquired:" << operation;
@@ -79,46 +174,69 @@ bool JobManager::tryAcquireState(State newState, const QString &operation)
 
 void JobManager::releaseState()
 {
-    QMutexLocker locker(&m_stateMutex);
-    
-    QString completedOperation = m_currentOperation;
-    m_state = State::Idle;
-    m_currentOperation.clear();
-    
-    emit busyChanged(false);
-    emit stateChanged(State::Idle);
-    emit currentOperationChanged(QString());
+    QString completedOperation;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        completedOperation = m_exclusiveOperation;
+        m_exclusive = State::Idle;
+        m_exclusiveOperation.clear();
+    }
     
+    updateState();
     qDebug() << "[JobManager] State released:" << completedOperation;
+    
+    // queued operations waited for the exclusive one
+    QMetaObject::invokeMethod(this, &JobManager::dispatch, Qt::QueuedConnection);
 }
 
-void JobManager::setState(State newState, const QString &operation)
+void JobManager::updateState()
 {
-    QMutexLocker locker(&m_stateMutex);
-    
-    if (!operation.isEmpty()) {
+    // the exclusive operation, else the longest running one
+    State state;
+    QString operation;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        if (m_exclusive != State::Idle) {
+            state = m_exclusive;
+            operation = m_exclusiveOperation;
+        } else if (!m_running.isEmpty()) {
+            state = m_running.first().kind;
+            QStringList names;
+            for (const Operation &op : m_running) {
+                names << op.name;
+            }
+            operation = names.join(", ");
+        } else {
+            state = State::Idle;
+        }
+        
+        if (state == m_state && operation == m_currentOperation) {
+            return;
+        }
+        std::swap(state, m_state);          // state: the previous one now
         m_currentOperation = operation;
-        emit currentOperationChanged(operation);
     }
     
-    if (newState != m_state) {
-        m_state = newState;
-        emit stateChanged(newState);
-        emit busyChanged(newState != State::Idle);
+    if (state != m_state) {
+        emit stateChanged(m_state);
+        if ((state == State::Idle) != (m_state == State::Idle)) {
+            emit busyChanged(m_state != State::Idle);
+        }
     }
+    emit currentOperationChanged(operation);
 }
 
 template<typename T>
-Async::Job<T>* JobManager::createJobSafely(std::function<T()> task)
+Async::Job<T>* JobManager::createJobSafely(const Async::RunOptions &opts, std::function<T()> task)
 {
     try {
         Async::Job<T>* job = nullptr;
         
         if (QThread::currentThread() == m_mainThread) {
-            job = new Async::Job<T>(task, this);
+            job = new Async::Job<T>(task, opts, this);
         } else {
             QMetaObject::invokeMethod(this, [&]() {
-                job = new Async::Job<T>(task, this);
+                job = new Async::Job<T>(task, opts, this);
             }, Qt::BlockingQueuedConnection);
         }
         
@@ -130,15 +248,33 @@ Async::Job<T>* JobManager::createJobSafely(std::function<T()> task)
     }
 }
 
-Async::Chain* JobManager::createChainSafely()
+template<typename T>
+Async::Job<T>* JobManager::createTaskJobSafely(std::function<Async::Task<T>()> start)
+{
+    // the coroutine has to start on the main thread to be resumed there
+    Async::Job<T>* job = nullptr;
+    auto create = [&]() {
+        job = new Async::Job<T>(start().future(), this);
+    };
+    
+    if (QThread::currentThread() == m_mainThread) {
+        create();
+    } else {
+        QMetaObject::invokeMethod(this, create, Qt::BlockingQueuedConnection);
+    }
+    
+    return job;
+}
+
+Async::Chain* JobManager::createChainSafely(const Async::RunOptions &opts)
 {
     Async::Chain* chain = nullptr;
     
     if (QThread::currentThread() == m_mainThread) {
-        chain = new Async::Chain(this);
+        chain = new Async::Chain(opts, this);
     } else {
         QMetaObject::invokeMethod(this, [&]() {
-            chain = new Async::Chain(this);
+            chain = new Async::Chain(opts, this);
         }, Qt::BlockingQueuedConnection);
     }
     
@@ -148,59 +284,28 @@ Async::Chain* JobManager::createChainSafely()
 Async::Job<JobManager::JobResult>* JobManager::deployService(const DeploymentInfo &info)
 {
     const QString operation = QString("Deploy %1").arg(info.name);
+    const QString node = info.node.isEmpty() ? nodeOfDeployment(info.deploymentYaml) : info.node;
     
-    if (!tryAcquireState(State::Deploying, operation)) {
-        // Return a job that immediately fails
-        return createJobSafely<JobResult>([]() -> JobResult {
-            JobResult result;
-            result.success = false;
-            result.errorMessage = "JobManager busy";
-            return result;
-        });
-    }
-    
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
-        JobResult result = this->performDeployment(info);
-        return result;
-    });
+    const QString done = QString("Service %1 %2").arg(info.name, info.subscribe ? "deployed" : "stopped");
     
-    connect(job, &Async::JobBase::finished, this, [=](bool success) {
-        emit jobFinished(operation, success, 
-            success ? QString("Service %1 %2").arg(info.name, info.subscribe ? "deployed" : "stopped")
-                   : "Deployment failed");
-        releaseState();
-        job->deleteLater();
+    return enqueue(State::Deploying, info.id, node, operation, done, [=]() {
+        return createTaskJobSafely<JobResult>([=]() {
+            return this->performDeployment(info);
+        });
     });
-    
-    return job;
 }
     
 Async::Job<JobManager::JobResult>* JobManager::removeService(const QString &id, const QString &deploymentYaml)
 {
     const QString operation = QString("Remove %1").arg(id);
     
-    if (!tryAcquireState(State::Removing, operation)) {
-        return createJobSafely<JobResult>([]() -> JobResult {
-            JobResult result;
-            result.success = false;
-            result.errorMessage = "JobManager busy";
-            return result;
-        });
-    }
-    
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
-        JobResult result = this->performRemoval(id, deploymentYaml);
-        return result;
-    });
+    const QString done = QString("Service %1 removed").arg(id);
     
-    connect(job, &Async::JobBase::finished, this, [=](bool success) {
-        emit jobFinished(operation, success && job->result().success, 
-            success && job->result().success ? QString("Service %1 removed").arg(id) : "Removal failed");
-        releaseState();
-        job->deleteLater();
+    return enqueue(State::Removing, id, nodeOfDeployment(deploymentYaml), operation, done, [=]() {
+        return createJobSafely<JobResult>(longRunning(), [=]() -> JobResult {
+            return this->performRemoval(id, deploymentYaml);
+        });
     });
-    
-    return job;
 }
 
 Async::Job<JobManager::JobResult>* JobManager::restartDeployment(const QString &deploymentName)
@@ -208,7 +313,7 @@ Async::Job<JobManager::JobResult>* JobManager::restartDeployment(const QString &
     const QString operation = QString("Restart %1").arg(deploymentName);
     
     if (!tryAcquireState(State::Restarting, operation)) {
-        return createJobSafely<JobResult>([]() -> JobResult {
+        return createJobSafely<JobResult>(immediate(), []() -> JobResult {
             JobResult result;
             result.success = false;
             result.errorMessage = "JobManager busy";
@@ -216,14 +321,13 @@ Async::Job<JobManager::JobResult>* JobManager::restartDeployment(const QString &
         });
     }
     
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
-        JobResult result;
-        
-        const QString cmd = QString("kubectl rollout restart deployment/%1 -n default")
-            .arg(deploymentName);
-        
-        result = executeCommandsSync({cmd});
-        return result;
+    auto *job = createJobSafely<JobResult>(longRunning(), [=]() -> JobResult {
+        KubeClient &kube = KubeClient::instance();
+        if (!kube.isAvailable()) {
+            return executeCommandsSync({ QString("kubectl rollout restart deployment/%1 -n default")
+                                             .arg(deploymentName) });
+        }
+        return fromKube(kube.restart(deploymentName));
     });
     
     connect(job, &Async::JobBase::finished, this, [=](bool success) {
@@ -244,7 +348,7 @@ Async::Job<JobManager::JobResult>* JobManager::scaleDeployment(const QString &de
     const QString operation = QString("Scale %1 to %2 replicas").arg(deploymentName).arg(replicas);
     
     if (!tryAcquireState(State::Deploying, operation)) {
-        return createJobSafely<JobResult>([]() -> JobResult {
+        return createJobSafely<JobResult>(immediate(), []() -> JobResult {
             JobResult result;
             result.success = false;
             result.errorMessage = "JobManager busy";
@@ -252,14 +356,8 @@ Async::Job<JobManager::JobResult>* JobManager::scaleDeployment(const QString &de
         });
     }
     
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
-        JobResult result;
-        
-        const QString cmd = QString("kubectl scale deployment %1 --replicas=%2 -n default")
-            .arg(deploymentName).arg(replicas);
-        
-        result = executeCommandsSync({cmd});
-        return result;
+    auto *job = createJobSafely<JobResult>(longRunning(), [=]() -> JobResult {
+        return scaleTo(deploymentName, replicas);
     });
     
     connect(job, &Async::JobBase::finished, this, [=](bool success) {
@@ -279,29 +377,18 @@ Async::Job<JobManager::JobResult>* JobManager::installApplication(const Installa
 {
     const QString operation = QString("Install %1").arg(request.appName);
     
-    if (!tryAcquireState(State::Installing, operation)) {
-        return createJobSafely<JobResult>([]() -> JobResult {
-            JobResult result;
-            result.success = false;
-            result.errorMessage = "JobManager busy - installation rejected";
-            return result;
-        });
-    }
-    
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
-        JobResult result = this->performInstallation(request);
-        return result;
-    });
+    const QString done = QString("Application %1 installed").arg(request.appName);
     
-    connect(job, &Async::JobBase::finished, this, [=](bool success) {
-        emit jobFinished(operation, success, 
-            success ? QString("Application %1 installed").arg(request.appName) 
-                   : "Installation failed");
-        releaseState();
-        job->deleteLater();
+    return enqueue(State::Installing, request.appId, request.node, operation, done, [=]() {
+        if (!request.steps.isEmpty()) {
+            return createTaskJobSafely<JobResult>([=]() {
+                return this->performInstallationGraph(request);
+            });
+        }
+        return createJobSafely<JobResult>(longRunning(), [=]() -> JobResult {
+            return this->performInstallation(request);
+        });
     });
-    
-    return job;
 }
 
 Async::Job<JobManager::JobResult>* JobManager::runCommands(const QStringList &commands, const QString &operation)
@@ -309,7 +396,7 @@ Async::Job<JobManager::JobResult>* JobManager::runCommands(const QStringList &co
     const QString op = operation.isEmpty() ? "Run Commands" : operation;
     
     if (!tryAcquireState(State::Installing, op)) {
-        return createJobSafely<JobResult>([]() -> JobResult {
+        return createJobSafely<JobResult>(immediate(), []() -> JobResult {
             JobResult result;
             result.success = false;
             result.errorMessage = "JobManager busy";
@@ -317,7 +404,7 @@ Async::Job<JobManager::JobResult>* JobManager::runCommands(const QStringList &co
         });
     }
     
-    auto *job = createJobSafely<JobResult>([=]() -> JobResult {
+    auto *job = createJobSafely<JobResult>(longRunning(), [=]() -> JobResult {
         JobResult result = this->executeCommandsSync(commands);
         return result;
     });
@@ -331,22 +418,321 @@ Async::Job<JobManager::JobResult>* JobManager::runCommands(const QStringList &co
     return job;
 }
 
+/* ------------------------------------------------------------------ */
+/* queue                                                              */
+/* ------------------------------------------------------------------ */
+Async::Job<JobManager::JobResult>* JobManager::enqueue(State kind, const QString &appId, const QString &node,
+                                                       const QString &operation, const QString &doneMessage,
+                                                       std::function<Async::Job<JobResult>*()> start)
+{
+    if (QThread::currentThread() != m_mainThread) {
+        Async::Job<JobResult>* job = nullptr;
+        QMetaObject::invokeMethod(this, [&]() {
+            job = enqueue(kind, appId, node, operation, doneMessage, start);
+        }, Qt::BlockingQueuedConnection);
+        return job;
+    }
+    
+    Operation op;
+    op.ticket = m_nextTicket++;
+    op.kind = kind;
+    op.appId = appId;
+    op.node = node.isEmpty() ? QString("xip") : node;
+    op.name = operation;
+    op.doneMessage = doneMessage;
+    op.start = std::move(start);
+    op.promise = std::make_shared<QPromise<JobResult>>();
+    op.promise->start();
+    
+    // handed out now, finished by onOperationFinished() or cancelQueued()
+    auto *job = new Async::Job<JobResult>(op.promise->future(), this);
+    
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_waiting << op;
+    }
+    qDebug() << "[JobManager] Queued" << operation << "on" << op.node
+             << "-" << m_waiting.size() << "waiting," << m_running.size() << "running";
+    
+    dispatch();
+    emit queueChanged();
+    return job;
+}
+
+void JobManager::dispatch()
+{
+    QList<Operation> startable;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        if (m_exclusive != State::Idle) {
+            return;
+        }
+        
+        QHash<QString, int> perNode;
+        QSet<QString> apps;                 // running, or waiting ahead in the queue
+        for (const Operation &op : m_running) {
+            perNode[op.node]++;
+            apps.insert(op.appId);
+        }
+        
+        for (auto it = m_waiting.begin(); it != m_waiting.end();) {
+            const bool appFree  = it->appId.isEmpty() || !apps.contains(it->appId);
+            const bool nodeFree = perNode.value(it->node) < nodeLimit(it->node);
+            apps.insert(it->appId);
+            if (appFree && nodeFree) {
+                perNode[it->node]++;
+                it->clock.start();
+                m_running << *it;
+                startable << *it;
+                it = m_waiting.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (startable.isEmpty()) {
+        return;
+    }
+    
+    updateState();
+    for (const Operation &op : startable) {
+        qDebug() << "[JobManager] Starting" << op.name << "on" << op.node;
+        emit jobStarted(op.name);
+        
+        Async::Job<JobResult> *job = op.start();
+        const quint64 ticket = op.ticket;
+        if (!job) {
+            onOperationFinished(ticket, false, JobResult());
+            continue;
+        }
+        connect(job, &Async::JobBase::finished, this, [this, job, ticket](bool success) {
+            onOperationFinished(ticket, success, success ? job->result() : JobResult());
+            job->deleteLater();
+        });
+    }
+    emit queueChanged();
+}
+
+void JobManager::onOperationFinished(quint64 ticket, bool ok, const JobResult &result)
+{
+    Operation op;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        for (int i = 0; i < m_running.size(); ++i) {
+            if (m_running[i].ticket == ticket) {
+                op = m_running.takeAt(i);
+                break;
+            }
+        }
+    }
+    if (!op.ticket) {
+        return;
+    }
+    
+    const bool success = ok && result.success;
+    if (success) {
+        // recent runs weigh more: images get cached, nodes get busier
+        const double sec = op.clock.elapsed() / 1000.0;
+        double &avg = m_avgSec[static_cast<int>(op.kind)];
+        avg = avg > 0 ? 0.7 * avg + 0.3 * sec : sec;
+    }
+    
+    if (ok) {
+        op.promise->addResult(result);
+    } else {
+        op.promise->setException(std::make_exception_ptr(
+            std::runtime_error(QString("%1 failed to run").arg(op.name).toStdString())));
+    }
+    op.promise->finish();
+    
+    emit jobFinished(op.name, success, success ? op.doneMessage : QString("%1 failed").arg(op.name));
+    
+    updateState();
+    dispatch();
+    emit queueChanged();
+}
+
+bool JobManager::cancelQueued(const QString &appId)
+{
+    QList<Operation> dropped;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        for (auto it = m_waiting.begin(); it != m_waiting.end();) {
+            if (it->appId == appId) {
+                dropped << *it;
+                it = m_waiting.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    for (const Operation &op : dropped) {
+        JobResult result;
+        result.errorMessage = "Cancelled while queued";
+        op.promise->addResult(result);
+        op.promise->finish();
+        emit jobFinished(op.name, false, result.errorMessage);
+    }
+    if (!dropped.isEmpty()) {
+        emit queueChanged();
+    }
+    return !dropped.isEmpty();
+}
+
+void JobManager::setNodeConcurrency(const QString &node, int limit)
+{
+    // an install holds a thread for its graph and up to two for its transfers
+    int total = 0;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_nodeLimits[node] = std::max(1, limit);
+        for (int n : std::as_const(m_nodeLimits)) {
+            total += n;
+        }
+    }
+    Async::Executor::instance().setMaxThreads(Async::Pool::Io, Async::Priority::Background,
+                                              std::max(4, 3 * total));
+    
+    QMetaObject::invokeMethod(this, &JobManager::dispatch, Qt::QueuedConnection);
+}
+
+int JobManager::nodeConcurrency(const QString &node) const
+{
+    QMutexLocker locker(&m_stateMutex);
+    return nodeLimit(node);
+}
+
+int JobManager::nodeLimit(const QString &node) const
+{
+    return m_nodeLimits.value(node, 1);
+}
+
+double JobManager::expectedSec(State kind) const
+{
+    const double measured = m_avgSec.value(static_cast<int>(kind));
+    if (measured > 0) {
+        return measured;
+    }
+    // until something was measured in this session
+    switch (kind) {
+    case State::Installing: return 120;
+    case State::Deploying:  return 20;
+    case State::Removing:   return 30;
+    default:                return 10;
+    }
+}
+
+QHash<quint64, int> JobManager::estimateEtas() const
+{
+    // Replays the queue per node: each slot is free once its running
+    // operation is expected to end, waiting ones take the earliest slot.
+    QHash<QString, QList<double>> freeAt;
+    QHash<quint64, int> etas;
+    
+    for (const Operation &op : m_running) {
+        const double left = std::max(1.0, expectedSec(op.kind) - op.clock.elapsed() / 1000.0);
+        freeAt[op.node] << left;
+        etas.insert(op.ticket, qRound(left));
+    }
+    
+    QHash<QString, double> appDone;         // same app: after its previous operation
+    for (const Operation &op : m_running) {
+        appDone[op.appId] = std::max(appDone.value(op.appId), double(etas.value(op.ticket)));
+    }
+    
+    for (const Operation &op : m_waiting) {
+        QList<double> &nodeSlots = freeAt[op.node];
+        while (nodeSlots.size() < nodeLimit(op.node)) {
+            nodeSlots << 0.0;
+        }
+        auto slot = std::min_element(nodeSlots.begin(), nodeSlots.end());
+        const double begin = std::max(*slot, appDone.value(op.appId));
+        const double end = begin + expectedSec(op.kind);
+        *slot = end;
+        appDone[op.appId] = end;
+        etas.insert(op.ticket, qRound(end));
+    }
+    return etas;
+}
+
+QVariantList JobManager::queue() const
+{
+    QMutexLocker locker(&m_stateMutex);
+    const QHash<quint64, int> etas = estimateEtas();
+    
+    QVariantList list;
+    auto entry = [&](const Operation &op, int position) {
+        QVariantMap m;
+        m["appId"] = op.appId;
+        m["operation"] = op.name;
+        m["node"] = op.node;
+        m["running"] = position == 0;
+        m["position"] = position;
+        m["etaSec"] = etas.value(op.ticket);
+        list << m;
+    };
+    for (const Operation &op : m_running) {
+        entry(op, 0);
+    }
+    for (int i = 0; i < m_waiting.size(); ++i) {
+        entry(m_waiting[i], i + 1);
+    }
+    return list;
+}
+
+int JobManager::queuePosition(const QString &appId) const
+{
+    QMutexLocker locker(&m_stateMutex);
+    for (const Operation &op : m_running) {
+        if (op.appId == appId) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < m_waiting.size(); ++i) {
+        if (m_waiting[i].appId == appId) {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+int JobManager::queueEtaSec(const QString &appId) const
+{
+    QMutexLocker locker(&m_stateMutex);
+    const QHash<quint64, int> etas = estimateEtas();
+    
+    int eta = -1;
+    for (const QList<Operation> *ops : { &m_running, &m_waiting }) {
+        for (const Operation &op : *ops) {
+            if (op.appId == appId) {
+                eta = std::max(eta, etas.value(op.ticket));
+            }
+        }
+    }
+    return eta;
+}
+
+QString JobManager::nodeOfDeployment(const QString &deploymentYaml)
+{
+    // the manifests pin their pods with kubernetes.io/hostname: <node>
+    QFile file(deploymentYaml);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        static const QRegularExpression hostname(R"(kubernetes\.io/hostname:\s*(\S+))");
+        const QRegularExpressionMatch m = hostname.match(QString::fromUtf8(file.readAll()));
+        if (m.hasMatch()) {
+            return m.captured(1);
+        }
+    }
+    return "xip";
+}
+
 Async::Job<bool>* JobManager::checkNodeReady(const QString &nodeName, int timeoutSec)
 {
     // Node checks are lightweight and don't need state management
-    return createJobSafely<bool>([=]() -> bool {
+    return createJobSafely<bool>(check(), [=]() -> bool {
         try {
-            const QString cmd = QString("kubectl get node %1 --no-headers 2>/dev/null").arg(nodeName);
-            JobResult result = executeCommandsSync({cmd});
-            
-            if (!result.success) {
-                return false;
-            }
-            
-            bool ready = result.output.contains("Ready") && !result.output.contains("NotReady");
-            qDebug() << "[JobManager] Node" << nodeName << "ready:" << ready;
-            return ready;
-            
+            return nodeReady(nodeName, timeoutSec);
         } catch (const std::exception &e) {
             qWarning() << "[JobManager] Node check exception:" << e.what();
             return false;
@@ -357,7 +743,7 @@ Async::Job<bool>* JobManager::checkNodeReady(const QString &nodeName, int timeou
 Async::Job<bool>* JobManager::checkDeploymentAvailable(const QString &deploymentId, int timeoutSec)
 {
     // Deployment checks are lightweight and don't need state management
-    return createJobSafely<bool>([=]() -> bool {
+    return createJobSafely<bool>(check(), [=]() -> bool {
         try {
             return Installer::deploymentAvailable(deploymentId, timeoutSec);
         } catch(...) {
@@ -372,12 +758,12 @@ Async::Chain* JobManager::createAutoRestartChain(const QString &deploymentName)
     
     if (!tryAcquireState(State::Restarting, operation)) {
         // Return a chain that immediately fails
-        auto *chain = createChainSafely();
+        auto *chain = createChainSafely(immediate());
         chain->add([]() -> bool { return false; });
         return chain;
     }
     
-    auto *chain = createChainSafely();
+    auto *chain = createChainSafely(longRunning());
     auto deploymentExists = std::make_shared<bool>(false);
     
     // Step 1: Check deployment exists
@@ -389,11 +775,7 @@ Async::Chain* JobManager::createAutoRestartChain(const QString &deploymentName)
     // Step 2: Scale down
     chain->add([=]() -> bool {
         if (!*deploymentExists) return true;
-        
-        const QString cmd = QString("kubectl scale deployment %1 --replicas=0 -n default")
-            .arg(deploymentName);
-        JobResult result = executeCommandsSync({cmd});
-        return result.success;
+        return scaleTo(deploymentName, 0).success;
     });
     
     // Step 3: Wait for termination
@@ -407,10 +789,7 @@ Async::Chain* JobManager::createAutoRestartChain(const QString &deploymentName)
         if (!*deploymentExists) return true;
         
         QThread::sleep(3); // Brief pause
-        const QString cmd = QString("kubectl scale deployment %1 --replicas=1 -n default")
-            .arg(deploymentName);
-        JobResult result = executeCommandsSync({cmd});
-        return result.success;
+        return scaleTo(deploymentName, 1).success;
     });
     
     // Step 5: Wait for ready
@@ -428,72 +807,98 @@ Async::Chain* JobManager::createAutoRestartChain(const QString &deploymentName)
     return chain;
 }
 
-JobManager::JobResult JobManager::performDeployment(const DeploymentInfo &info)
+Async::Task<JobManager::JobResult> JobManager::performDeployment(DeploymentInfo info)
 {
     JobResult result;
-    result.success = true;
+    bool applied = false;
     
-    try {
-        setState(State::Deploying, QString("Deploying %1").arg(info.name));
+    if (info.subscribe) {
+        KubeClient &kube = KubeClient::instance();
         
-        if (info.subscribe) {
-            // Check node ready first
-            auto nodeJob = checkNodeReady("vip", 3);
-            QEventLoop loop;
-            bool nodeReady = false;
-            
-            connect(nodeJob, &Async::JobBase::finished, &loop, [&](bool success) {
-                if (success) nodeReady = nodeJob->result();
-                loop.quit();
-            });
-            
-            loop.exec();
-            nodeJob->deleteLater();
-            
-            if (!nodeReady) {
-                NOTIFY_WARNING("Deployment", "ZonalECU - VIP is not ready");
-            }
-            
-            // Force cleanup existing
-            QString cleanupCmd = QString("kubectl delete deployment %1 -n default --ignore-not-found --wait=true").arg(info.id);
-            executeCommandsSync({cleanupCmd});
-            QThread::msleep(2000);
+        // Check node ready first
+        bool vipReady = false;
+        if (kube.isAvailable()) {
+            const KubeResult node = co_await kube.getAsync(Kind::Node, "vip", QString(), 3000);
+            vipReady = node.ok && KubeClient::nodeReady(node.object);
+        } else {
+            // NAME STATUS ROLES AGE VERSION
+            const JobResult node = co_await executeCommandAsync("kubectl get node vip --no-headers");
+            vipReady = node.success && node.output.section(QRegularExpression("\\s+"), 1, 1) == "Ready";
+        }
+        if (!vipReady) {
+            NOTIFY_WARNING("Deployment", "ZonalECU - VIP is not ready");
         }
         
-        // Execute deployment
-        const QString cmd = info.subscribe 
-            ? QString("kubectl apply -f %1").arg(info.deploymentYaml)
-            : QString("kubectl delete -f %1 --ignore-not-found").arg(info.deploymentYaml);
-        
-        result = executeCommandsSync({cmd});
+        QFile file(info.deploymentYaml);
+        const QByteArray yaml = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+        const QString hash = ManifestBuilder::hashOf(yaml);
         
-        // Verify deployment if subscribing
-        if (result.success && info.subscribe) {
-            QString waitCmd = QString("kubectl rollout status deployment/%1 --timeout=60s").arg(info.id);
-            JobResult waitResult = executeCommandsSync({waitCmd});
-            
-            if (!waitResult.success) {
-                result.errorMessage = "Deployment applied but not ready: " + waitResult.errorMessage;
-                qWarning() << "[JobManager]" << result.errorMessage;
+        // Unchanged manifest: the live deployment is already what it
+        // describes, unless it was scaled to 0 since, is not available or
+        // its last rollout never completed; then it is applied again and
+        // its rollout waited for
+        std::optional<QJsonObject> live;
+        Informer *informer = Informer::instance();
+        if (informer->isSynced(Kind::Deployment)) {
+            live = informer->get(Kind::Deployment, info.id);
+        } else {
+            const KubeResult r = co_await kube.getAsync(Kind::Deployment, info.id);
+            if (r.ok) {
+                live = r.object;
             }
         }
+        const QString liveHash = live
+            ? live->value("metadata").toObject().value("annotations").toObject()
+                  .value(ManifestBuilder::HASH_ANNOTATION).toString()
+            : QString();
         
-        const QString action = info.subscribe ? "deployed" : "stopped";
-        const QString message = QString("Service '%1' %2").arg(info.name, action);
+        const bool running = live
+            && live->value("spec").toObject().value("replicas").toInt(1) > 0
+            && KubeClient::deploymentAvailable(*live)
+            && KubeClient::rolloutComplete(*live);
         
-        if (result.success) {
-            NOTIFY_INFO("Deployment", message);
+        if (!hash.isEmpty() && hash == liveHash && running) {
+            qDebug() << "[JobManager] Deployment" << info.id << "unchanged (" << hash << "), not applied";
+            result.success = true;
+        } else if (!yaml.isEmpty() && kube.isAvailable()) {
+            // Server-side apply patches the live object in place; the
+            // rolling update (maxSurge 0) replaces the pod
+            result = fromKube(co_await kube.applyYamlAsync(Kind::Deployment, info.id, yaml));
+            applied = true;
         } else {
-            NOTIFY_ERROR("Deployment", QString("Failed to %1 %2: %3")
-                .arg(action, info.name, result.errorMessage));
+            result = co_await executeCommandAsync(
+                QString("kubectl apply --server-side --force-conflicts --field-manager=dk-ivi -f %1")
+                    .arg(info.deploymentYaml));
+            applied = true;
         }
-        
-    } catch (const std::exception &e) {
-        result.success = false;
-        result.errorMessage = QString("Exception: %1").arg(e.what());
+    } else if (KubeClient::instance().isAvailable()) {
+        // the manifest holds only the deployment
+        result = fromKube(co_await KubeClient::instance().removeAsync(Kind::Deployment, info.id));
+    } else {
+        result = co_await executeCommandAsync(
+            QString("kubectl delete -f %1 --ignore-not-found").arg(info.deploymentYaml));
     }
     
-    return result;
+    // Verify deployment if it was applied
+    if (result.success && applied) {
+        if (!co_await waitForRollout(info.id, 60)) {
+            result.success = false;
+            result.errorMessage = "Deployment applied but not ready: rollout not complete after 60 s";
+            qWarning() << "[JobManager]" << result.errorMessage;
+        }
+    }
+    
+    const QString action = info.subscribe ? "deployed" : "stopped";
+    const QString message = QString("Service '%1' %2").arg(info.name, action);
+    
+    if (result.success) {
+        NOTIFY_INFO("Deployment", message);
+    } else {
+        NOTIFY_ERROR("Deployment", QString("Failed to %1 %2: %3")
+            .arg(action, info.name, result.errorMessage));
+    }
+    
+    co_return result;
 }
 
 JobManager::JobResult JobManager::performRemoval(const QString &id, const QString &deploymentYaml)
@@ -502,22 +907,73 @@ JobManager::JobResult JobManager::performRemoval(const QString &id, const QStrin
     result.success = true;
     
     try {
-        setState(State::Removing, QString("Removing %1").arg(id));
         
-        QStringList cleanupCommands;
-        cleanupCommands << QString("kubectl scale deployment %1 --replicas=0 -n default --ignore-not-found").arg(id);
-        cleanupCommands << QString("kubectl wait --for=delete pod -l app=%1 -n default --timeout=30s || true").arg(id);
-        cleanupCommands << QString("kubectl delete -f %1 --ignore-not-found --wait=true").arg(deploymentYaml);
-        cleanupCommands << QString("kubectl delete job pull-%1 mirror-%1 --ignore-not-found").arg(id);
+        KubeClient &kube = KubeClient::instance();
+        if (!kube.isAvailable()) {
+            QStringList cleanupCommands;
+            cleanupCommands << QString("kubectl scale deployment %1 --replicas=0 -n default").arg(id);
+            cleanupCommands << QString("kubectl wait --for=delete pod -l app=%1 -n default --timeout=30s || true").arg(id);
+            cleanupCommands << QString("kubectl delete job pull-%1 mirror-%1 --ignore-not-found").arg(id);
+            for (const QString &cmd : cleanupCommands) {
+                if (!executeCommandsSync({cmd}).success) {
+                    qWarning() << "[JobManager] Cleanup command failed:" << cmd;
+                }
+            }
+            
+            const JobResult removed = executeCommandsSync({
+                QString("kubectl delete -f %1 --ignore-not-found --wait=true").arg(deploymentYaml) });
+            if (!removed.success) {
+                result.success = false;
+                result.errorMessage = QString("Deleting deployment %1 failed: %2").arg(id, removed.errorMessage);
+                NOTIFY_ERROR("Removal", result.errorMessage);
+            } else {
+                NOTIFY_INFO("Removal", QString("Service %1 removed successfully").arg(id));
+            }
+            return result;
+        }
+        
+        const KubeResult scaled = kube.scale(id, 0);
+        if (!scaled.ok && !scaled.notFound()) {
+            qWarning() << "[JobManager] Scale down failed:" << scaled.error;
+        }
         
-        for (const QString &cmd : cleanupCommands) {
-            JobResult cmdResult = executeCommandsSync({cmd});
-            if (!cmdResult.success && !cmd.contains("--ignore-not-found") && !cmd.contains("|| true")) {
-                qWarning() << "[JobManager] Cleanup command failed:" << cmd;
+        // wait up to 30 s for the pods to be gone
+        const QString selector = QString("app=%1").arg(id);
+        for (int i = 0; i < 30; ++i) {
+            const KubeResult pods = kube.list(Kind::Pod, selector);
+            if (!pods.ok || pods.items().isEmpty()) {
+                break;
             }
+            QThread::sleep(1);
         }
         
-        NOTIFY_INFO("Removal", QString("Service %1 removed successfully").arg(id));
+        // the manifest holds only the deployment; wait for it to be gone
+        const KubeResult removed = kube.remove(Kind::Deployment, id);
+        if (!removed.ok && !removed.notFound()) {
+            result.success = false;
+            result.errorMessage = QString("Deleting deployment %1 failed: %2").arg(id, removed.error);
+            qWarning() << "[JobManager]" << result.errorMessage;
+        } else {
+            Informer *informer = Informer::instance();
+            const bool gone = informer->isSynced(Kind::Deployment)
+                ? informer->waitFor(Kind::Deployment, id,
+                      [](const std::optional<QJsonObject> &deployment) { return !deployment; }, 30000)
+                : kube.get(Kind::Deployment, id).notFound();
+            if (!gone) {
+                qWarning() << "[JobManager] Deployment" << id << "still present after deletion";
+            }
+        }
+        
+        const JobResult jobs = removeJobs({ QString("pull-%1").arg(id), QString("mirror-%1").arg(id) });
+        if (!jobs.success) {
+            qWarning() << "[JobManager]" << jobs.errorMessage;
+        }
+        
+        if (result.success) {
+            NOTIFY_INFO("Removal", QString("Service %1 removed successfully").arg(id));
+        } else {
+            NOTIFY_ERROR("Removal", result.errorMessage);
+        }
         
     } catch (const std::exception &e) {
         result.success = false;
@@ -534,7 +990,6 @@ JobManager::JobResult JobManager::performInstallation(const InstallationRequest
     result.success = true; // Start with success assumption
     
     try {
-        setState(State::Installing, QString("Installing %1").arg(request.appName));
         
         qDebug() << "[JobManager] Starting installation of" << request.appName 
                  << "with" << request.commands.size() << "commands";
@@ -585,7 +1040,148 @@ JobManager::JobResult JobManager::performInstallation(const InstallationRequest
     return result;
 }
 
-JobManager::JobResult JobManager::executeCommandsSync(const QStringList &commands)
+Async::Task<JobManager::JobResult> JobManager::performInstallationGraph(InstallationRequest request)
+{
+    qDebug() << "[JobManager] Starting installation of" << request.appName 
+             << "with" << request.steps.size() << "steps";
+    
+    // written by the steps on the pool threads
+    struct Outcome {
+        QMutex mutex;
+        QString failedStep;
+        JobResult failure;
+    };
+    auto outcome = std::make_shared<Outcome>();
+    
+    // The graph lives on the main thread, only its steps take pool
+    // threads. An attempt that times out is cancelled and has returned
+    // before its retry starts, so no two runs of a step race.
+    auto *graph = new Async::Graph(longRunning(), this);
+    QHash<QString, Async::Graph::StepId> ids;
+    
+    for (const InstallStep &step : request.steps) {
+        QList<Async::Graph::StepId> after;
+        for (const QString &dep : step.after) {
+            if (ids.contains(dep)) {
+                after << ids.value(dep);
+            } else {
+                qWarning() << "[JobManager] Step" << step.name << "ignores unknown dependency" << dep;
+            }
+        }
+        
+        Async::StepOptions opts;
+        opts.timeout = std::chrono::seconds(step.timeoutSec);
+        opts.retries = step.retries;
+        
+        const QString appId = request.appId;
+        const auto id = graph->add(step.name, [this, step, appId, outcome](const Async::CancelToken &token) -> bool {
+            auto fail = [&](const JobResult &failure) {
+                QMutexLocker locker(&outcome->mutex);
+                if (outcome->failedStep.isEmpty()) {
+                    outcome->failedStep = step.name;
+                    outcome->failure = failure;
+                }
+                return false;
+            };
+            
+            if (!step.label.isEmpty()) {
+                emit installProgress(appId, step.label);
+            }
+            if (step.skipIf && step.skipIf()) {
+                qDebug() << "[JobManager] Step" << step.name << "not needed, skipped";
+                emit installProgress(appId, QString("%1: not needed, skipped").arg(step.name));
+                return true;
+            }
+            QElapsedTimer clock;
+            clock.start();
+            // a job of the same name may still be cached from an earlier run
+            QString staleUid;
+            if (!step.waitForJob.isEmpty()) {
+                if (const auto old = Informer::instance()->get(Kind::Job, step.waitForJob)) {
+                    staleUid = old->value("metadata").toObject().value("uid").toString();
+                }
+            }
+            if (!step.removeJobs.isEmpty()) {
+                JobResult removed = removeJobs(step.removeJobs);
+                if (!removed.success) {
+                    qWarning() << "[JobManager] Step" << step.name << "failed:" << removed.errorMessage;
+                    return fail(removed);
+                }
+            }
+            if (!step.requireNode.isEmpty() && !nodeReady(step.requireNode, 5)) {
+                JobResult notReady;
+                notReady.errorMessage = QString("Node %1 is not ready").arg(step.requireNode);
+                qWarning() << "[JobManager] Step" << step.name << "failed:" << notReady.errorMessage;
+                return fail(notReady);
+            }
+            if (!step.applyJob.isEmpty()) {
+                JobResult applied = applyJob(step.waitForJob, step.applyJob);
+                if (!applied.success) {
+                    qWarning() << "[JobManager] Step" << step.name << "failed:" << applied.errorMessage;
+                    return fail(applied);
+                }
+            }
+            for (int i = 0; i < step.commands.size(); ++i) {
+                if (token.isCancelled()) {
+                    return false;
+                }
+                JobResult cmdResult = executeCommandsSync({step.commands[i]}, token);
+                if (!cmdResult.success) {
+                    qWarning() << "[JobManager] Step" << step.name << "failed at command" << (i+1)
+                               << ":" << cmdResult.errorMessage;
+                    return fail(cmdResult);
+                }
+            }
+            if (!step.waitForJob.isEmpty()) {
+                JobResult jobResult = waitForJobCompletion(appId, step.waitForJob, staleUid,
+                                                           step.timeoutSec, token, step.onWaiting);
+                if (!jobResult.success) {
+                    qWarning() << "[JobManager] Step" << step.name << "failed:" << jobResult.errorMessage;
+                    return fail(jobResult);
+                }
+            }
+            if (step.onDone) {
+                step.onDone(clock.elapsed());
+            }
+            return true;
+        }, after, opts);
+        ids.insert(step.name, id);
+    }
+    
+    auto ok = std::make_shared<bool>(false);
+    connect(graph, &Async::Graph::finished, graph, [ok](bool success) {
+        *ok = success;
+    });
+    graph->start();
+    if (graph->isRunning()) {
+        co_await Async::signal(graph, &Async::Graph::finished);
+    }
+    // resumed from inside the graph's signal
+    graph->deleteLater();
+    
+    JobResult result;
+    result.success = *ok;
+    if (*ok) {
+        qDebug() << "[JobManager] Installation of" << request.appName << "completed successfully";
+        NOTIFY_INFO("Installation", QString("%1 installed successfully").arg(request.appName));
+        co_return result;
+    }
+    
+    {
+        QMutexLocker locker(&outcome->mutex);
+        const QString step = outcome->failedStep.isEmpty() ? QString("a step") : outcome->failedStep;
+        result.errorMessage = QString("Step %1 failed: %2").arg(step, outcome->failure.errorMessage.isEmpty()
+                                                                   ? QString("timed out or cancelled")
+                                                                   : outcome->failure.errorMessage);
+        result.output = outcome->failure.output;
+    }
+    NOTIFY_ERROR("Installation", QString("Failed to install %1: %2")
+        .arg(request.appName, result.errorMessage));
+    co_return result;
+}
+
+JobManager::JobResult JobManager::executeCommandsSync(const QStringList &commands,
+                                                     const Async::CancelToken &token)
 {
     JobResult result;
     result.success = false;
@@ -601,14 +1197,7 @@ JobManager::JobResult JobManager::executeCommandsSync(const QStringList &command
         QProcess process;
         process.setProcessChannelMode(QProcess::MergedChannels);
         
-        // Set environment
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-        QString path = env.value("PATH");
-        if (!path.contains("/usr/local/bin")) {
-            path += ":/usr/local/bin";
-        }
-        env.insert("PATH", path);
-        process.setProcessEnvironment(env);
+        process.setProcessEnvironment(commandEnvironment());
         
         qDebug() << "[JobManager] Executing command:" << command;
         process.start("/bin/bash", QStringList() << "-c" << command);
@@ -620,20 +1209,25 @@ JobManager::JobResult JobManager::executeCommandsSync(const QStringList &command
         }
         
         // Determine timeout based on command type
-        int timeout = 30000; // default 30 seconds
-        if (command.contains("kubectl wait")) {
-            timeout = 300000; // 5 minutes for wait commands
-        } else if (command.contains("kubectl apply")) {
-            timeout = 60000; // 1 minute for apply commands
-        } else if (command.contains("get node")) {
-            timeout = 10000; // 10 seconds for node checks
-        }
+        const int timeout = commandTimeoutMs(command);
         
-        if (!process.waitForFinished(timeout)) {
-            qWarning() << "[JobManager] Command timed out after" << timeout << "ms:" << command;
+        // waited for in slices, so a cancelled token stops the command
+        const QDeadlineTimer deadline(timeout);
+        bool finished = false;
+        while (!finished && !deadline.hasExpired() && !token.isCancelled()) {
+            finished = process.waitForFinished(static_cast<int>(std::min<qint64>(500, deadline.remainingTime())))
+                       || process.state() == QProcess::NotRunning;
+        }
+        if (!finished) {
             process.kill();
             process.waitForFinished(2000);
-            result.errorMessage = QString("Command timed out after %1 seconds").arg(timeout / 1000);
+            if (token.isCancelled()) {
+                qWarning() << "[JobManager] Command cancelled:" << command;
+                result.errorMessage = "Cancelled";
+            } else {
+                qWarning() << "[JobManager] Command timed out after" << timeout << "ms:" << command;
+                result.errorMessage = QString("Command timed out after %1 seconds").arg(timeout / 1000);
+            }
             return result;
         }
         
@@ -674,19 +1268,103 @@ JobManager::JobResult JobManager::executeCommandsSync(const QStringList &command
     return result;
 }
 
+Async::Task<JobManager::JobResult> JobManager::executeCommandAsync(QString command)
+{
+    const int timeout = commandTimeoutMs(command);
+    qDebug() << "[JobManager] Executing command:" << command;
+    
+    const Async::ProcessResult run = co_await Async::process(
+        "/bin/bash", QStringList() << "-c" << command,
+        std::chrono::milliseconds(timeout), commandEnvironment());
+    
+    JobResult result;
+    if (!run.started) {
+        result.errorMessage = QString("Failed to start process: %1").arg(run.errorString);
+        qWarning() << "[JobManager]" << result.errorMessage;
+        co_return result;
+    }
+    if (run.timedOut) {
+        qWarning() << "[JobManager] Command timed out after" << timeout << "ms:" << command;
+        result.errorMessage = QString("Command timed out after %1 seconds").arg(timeout / 1000);
+        co_return result;
+    }
+    
+    result.output = run.output;
+    result.success = run.ok();
+    
+    if (!result.success) {
+        result.errorMessage = QString("Command failed with exit code %1").arg(run.exitCode);
+        if (!result.output.isEmpty()) {
+            result.errorMessage += QString(": %1").arg(result.output);
+        }
+        qWarning() << "[JobManager] Command failed:" << command;
+        qWarning() << "[JobManager] Error:" << result.errorMessage;
+    }
+    
+    co_return result;
+}
+
+Async::Task<bool> JobManager::waitForRollout(QString deploymentName, int maxWaitSec)
+{
+    // the informer's copy when it is synced, else one GET per second;
+    // either way the main thread is free in between
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        const JobResult status = co_await executeCommandAsync(
+            QString("kubectl rollout status deployment/%1 --timeout=%2s").arg(deploymentName).arg(maxWaitSec));
+        co_return status.success;
+    }
+    
+    Informer *informer = Informer::instance();
+    QDeadlineTimer deadline(maxWaitSec * 1000);
+    for (;;) {
+        std::optional<QJsonObject> deployment;
+        if (informer->isSynced(Kind::Deployment)) {
+            deployment = informer->get(Kind::Deployment, deploymentName);
+        } else {
+            const KubeResult r = co_await kube.getAsync(Kind::Deployment, deploymentName);
+            if (r.ok) {
+                deployment = r.object;
+            }
+        }
+        if (deployment && KubeClient::rolloutComplete(*deployment)) {
+            co_return true;
+        }
+        if (deadline.hasExpired()) {
+            co_return false;
+        }
+        co_await Async::sleep(std::chrono::seconds(1));
+    }
+}
+
 bool JobManager::waitForPodTermination(const QString &deploymentName, int maxWaitSec)
 {
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Deployment)) {
+        return informer->waitFor(Kind::Deployment, deploymentName,
+            [](const std::optional<QJsonObject> &deployment) {
+                return !deployment || KubeClient::replicas(*deployment) == 0;
+            }, maxWaitSec * 1000);
+    }
+    
+    KubeClient &kube = KubeClient::instance();
     for (int i = 0; i < maxWaitSec; ++i) {
-        const QString cmd = QString("kubectl get deployment %1 -n default -o jsonpath='{.status.replicas}' 2>/dev/null")
-            .arg(deploymentName);
-        
-        JobResult result = executeCommandsSync({cmd});
-        
-        if (result.success) {
-            QString output = result.output.trimmed();
-            if (output.isEmpty() || output == "0") {
+        if (!kube.isAvailable()) {
+            const JobResult replicas = executeCommandsSync({
+                QString("kubectl get deployment %1 -n default -o jsonpath='{.status.replicas}' 2>/dev/null")
+                    .arg(deploymentName) });
+            if (replicas.success && (replicas.output.isEmpty() || replicas.output == "0")) {
                 return true;
             }
+            QThread::sleep(1);
+            continue;
+        }
+        
+        const KubeResult deployment = kube.get(Kind::Deployment, deploymentName);
+        
+        if (deployment.notFound() ||
+            (deployment.ok && KubeClient::replicas(deployment.object) == 0)) {
+            return true;
         }
         
         QThread::sleep(1);
@@ -697,21 +1375,41 @@ bool JobManager::waitForPodTermination(const QString &deploymentName, int maxWai
 
 bool JobManager::waitForPodsReady(const QString &deploymentName, int maxWaitSec)
 {
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Deployment)) {
+        return informer->waitFor(Kind::Deployment, deploymentName,
+            [](const std::optional<QJsonObject> &deployment) {
+                if (!deployment) {
+                    return false;
+                }
+                const int ready = KubeClient::readyReplicas(*deployment);
+                return ready > 0 && ready == KubeClient::replicas(*deployment);
+            }, maxWaitSec * 1000);
+    }
+    
+    KubeClient &kube = KubeClient::instance();
     for (int i = 0; i < maxWaitSec; i += 3) {
-        const QString cmd = QString("kubectl get deployment %1 -n default -o jsonpath='{.status.readyReplicas}/{.status.replicas}' 2>/dev/null")
-            .arg(deploymentName);
+        if (!kube.isAvailable()) {
+            const JobResult status = executeCommandsSync({
+                QString("kubectl get deployment %1 -n default -o jsonpath='{.status.readyReplicas}/{.status.replicas}' 2>/dev/null")
+                    .arg(deploymentName) });
+            const QStringList parts = status.output.split('/');
+            if (status.success && parts.size() == 2
+                && parts[0].toInt() > 0 && parts[0].toInt() == parts[1].toInt()) {
+                return true;
+            }
+            QThread::sleep(3);
+            continue;
+        }
         
-        JobResult result = executeCommandsSync({cmd});
+        const KubeResult deployment = kube.get(Kind::Deployment, deploymentName);
         
-        if (result.success && !result.output.isEmpty() && result.output.contains('/')) {
-            QStringList parts = result.output.trimmed().split('/');
-            if (parts.size() == 2) {
-                int ready = parts[0].toInt();
-                int total = parts[1].toInt();
-                
-                if (ready > 0 && ready == total) {
-                    return true;
-                }
+        if (deployment.ok) {
+            const int ready = KubeClient::readyReplicas(deployment.object);
+            const int total = KubeClient::replicas(deployment.object);
+            
+            if (ready > 0 && ready == total) {
+                return true;
             }
         }
         
@@ -721,22 +1419,217 @@ bool JobManager::waitForPodsReady(const QString &deploymentName, int maxWaitSec)
     return false;
 }
 
-bool JobManager::forceDeletePods(const QString &deploymentName)
+JobManager::JobResult JobManager::waitForJobCompletion(const QString &appId, const QString &jobName,
+                                                      const QString &staleUid, int timeoutSec,
+                                                      const Async::CancelToken &token,
+                                                      const std::function<void()> &onWaiting)
 {
-    const QString cmd = QString("kubectl delete pods -l app=%1 -n default --force --grace-period=0 --ignore-not-found")
-        .arg(deploymentName);
+    // Settles on the job's conditions, or early when one of its pods
+    // cannot pull its image. Pods are matched by job-name and then by the
+    // Job's uid, since job names are reused across retries. Each change of the pod's state is reported.
+    struct Status {
+        bool done = false;
+        bool ok = false;
+        QString text;
+    };
+    auto evaluate = [&jobName, &staleUid](const std::optional<QJsonObject> &job,
+                                          const QList<QJsonObject> &jobNamePods) -> Status {
+        const QString uid = job ? job->value("metadata").toObject().value("uid").toString() : QString();
+        if (!job || (!staleUid.isEmpty() && uid == staleUid)) {
+            return { false, false, "waiting for the job" };
+        }
+        // only the pods of this Job, not those of a deleted retry
+        QList<QJsonObject> pods;
+        for (const QJsonObject &pod : jobNamePods) {
+            if (ownedByJob(pod, uid)) {
+                pods << pod;
+            }
+        }
+        QString message;
+        if (KubeClient::jobComplete(*job)) {
+            return { true, true, "completed" };
+        }
+        if (KubeClient::jobFailed(*job, &message)) {
+            return { true, false, QString("job %1 failed: %2").arg(jobName, message) };
+        }
+        for (const QJsonObject &pod : pods) {
+            const QString reason = KubeClient::waitingReason(pod, &message);
+            if (reason == "ImagePullBackOff" || reason == "ErrImagePull" || reason == "InvalidImageName") {
+                return { true, false, QString("%1: %2").arg(reason, message) };
+            }
+            if (!reason.isEmpty()) {
+                return { false, false, reason };
+            }
+        }
+        if (!pods.isEmpty()) {
+            return { false, false, pods.first().value("status").toObject().value("phase").toString() };
+        }
+        return { false, false, "waiting for a pod" };
+    };
+    
+    Informer *informer = Informer::instance();
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        return executeCommandsSync({ QString("kubectl wait --for=condition=complete job/%1 --timeout=%2s")
+                                         .arg(jobName).arg(timeoutSec > 0 ? timeoutSec : 1200) }, token);
+    }
+    
+    const QString selector = QString("job-name=%1").arg(jobName);
+    const QDeadlineTimer deadline = timeoutSec > 0 ? QDeadlineTimer(timeoutSec * 1000)
+                                                   : QDeadlineTimer(QDeadlineTimer::Forever);
+    Status status;
+    QString reported;
+    JobResult result;
     
-    JobResult result = executeCommandsSync({cmd});
-    return result.success;
+    for (;;) {
+        const bool watched = informer->isSynced(Kind::Job) && informer->isSynced(Kind::Pod);
+        if (watched) {
+            // woken by the watches; the slice bounds how late a cancel is seen
+            informer->waitUntil([&]() {
+                status = evaluate(informer->get(Kind::Job, jobName),
+                                  informer->podsLabelled("job-name", jobName));
+                return status.done || status.text != reported;
+            }, 1000);
+        } else {
+            const KubeResult job = kube.get(Kind::Job, jobName);
+            if (!job.ok && !job.notFound()) {
+                qWarning() << "[JobManager] Reading job" << jobName << "failed:" << job.error;
+            }
+            QList<QJsonObject> pods;
+            if (job.ok) {
+                for (const QJsonValue &pod : kube.list(Kind::Pod, selector).items()) {
+                    pods << pod.toObject();
+                }
+            }
+            status = evaluate(job.ok ? std::optional<QJsonObject>(job.object) : std::nullopt, pods);
+        }
+        
+        if (status.text != reported) {
+            reported = status.text;
+            qDebug() << "[JobManager] Job" << jobName << "-" << reported;
+            emit installProgress(appId, QString("%1: %2").arg(jobName, reported));
+        }
+        if (onWaiting && !status.done) {
+            onWaiting();
+        }
+        if (status.done) {
+            result.success = status.ok;
+            if (!status.ok) {
+                result.errorMessage = status.text;
+            }
+            return result;
+        }
+        if (token.isCancelled()) {
+            result.errorMessage = "Cancelled";
+            return result;
+        }
+        if (deadline.hasExpired()) {
+            result.errorMessage = QString("Job %1 did not complete within %2 seconds")
+                .arg(jobName).arg(timeoutSec);
+            return result;
+        }
+        if (!watched) {
+            QThread::msleep(1000);
+        }
+    }
+}
+
+bool JobManager::forceDeletePods(const QString &deploymentName)
+{
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        return executeCommandsSync({
+            QString("kubectl delete pods -l app=%1 -n default --force --grace-period=0 --ignore-not-found")
+                .arg(deploymentName) }).success;
+    }
+    const QString selector = QString("app=%1").arg(deploymentName);
+    return kube.removeAll(Kind::Pod, selector, "default", 0).ok;
+}
+
+JobManager::JobResult JobManager::scaleTo(const QString &deploymentName, int replicas)
+{
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        return executeCommandsSync({ QString("kubectl scale deployment %1 --replicas=%2 -n default")
+                                         .arg(deploymentName).arg(replicas) });
+    }
+    return fromKube(kube.scale(deploymentName, replicas));
 }
 
 bool JobManager::deploymentExists(const QString &deploymentName)
 {
-    const QString cmd = QString("kubectl get deployment %1 -n default --no-headers 2>/dev/null")
-        .arg(deploymentName);
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Deployment)) {
+        return informer->get(Kind::Deployment, deploymentName).has_value();
+    }
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        const JobResult deployment = executeCommandsSync({
+            QString("kubectl get deployment %1 -n default --no-headers 2>/dev/null").arg(deploymentName) });
+        return deployment.success && !deployment.output.isEmpty();
+    }
+    return kube.get(Kind::Deployment, deploymentName).ok;
+}
+
+bool JobManager::nodeReady(const QString &nodeName, int timeoutSec)
+{
+    Informer *informer = Informer::instance();
+    if (informer->isSynced(Kind::Node)) {
+        const auto node = informer->get(Kind::Node, nodeName);
+        return node && KubeClient::nodeReady(*node);
+    }
+    
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        // NAME STATUS ROLES AGE VERSION
+        const JobResult node = executeCommandsSync({ QString("kubectl get node %1 --no-headers").arg(nodeName) });
+        return node.success && node.output.section(QRegularExpression("\\s+"), 1, 1) == "Ready";
+    }
+    
+    const KubeResult node = kube.get(Kind::Node, nodeName, QString(), timeoutSec * 1000);
+    if (!node.ok) {
+        return false;
+    }
+    
+    bool ready = KubeClient::nodeReady(node.object);
+    qDebug() << "[JobManager] Node" << nodeName << "ready:" << ready;
+    return ready;
+}
+
+JobManager::JobResult JobManager::applyJob(const QString &jobName, const QString &manifestFile)
+{
+    KubeClient &kube = KubeClient::instance();
+    QFile file(manifestFile);
+    const QByteArray yaml = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    if (yaml.isEmpty() || !kube.isAvailable()) {
+        return executeCommandsSync({ QString("kubectl apply --server-side --force-conflicts --field-manager=dk-ivi -f %1")
+                                         .arg(manifestFile) });
+    }
+    
+    JobResult result = fromKube(kube.applyYaml(Kind::Job, jobName, yaml));
+    if (!result.success) {
+        result.errorMessage = QString("Applying job %1 failed: %2").arg(jobName, result.errorMessage);
+    }
+    return result;
+}
+
+JobManager::JobResult JobManager::removeJobs(const QStringList &jobs)
+{
+    KubeClient &kube = KubeClient::instance();
+    if (!kube.isAvailable()) {
+        return executeCommandsSync({ QString("kubectl delete job %1 --ignore-not-found").arg(jobs.join(' ')) });
+    }
     
-    JobResult result = executeCommandsSync({cmd});
-    return result.success && !result.output.trimmed().isEmpty();
+    JobResult result;
+    result.success = true;
+    for (const QString &job : jobs) {
+        const KubeResult removed = kube.remove(Kind::Job, job);
+        if (!removed.ok) {
+            result.success = false;
+            result.errorMessage = QString("Deleting job %1 failed: %2").arg(job, removed.error);
+        }
+    }
+    return result;
 }
 
 void JobManager::onInstallerFinished(bool success)
@@ -13,8 +13,15 @@
 #include <QMutex>
 #include <QThread>
 #include <QQueue>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPromise>
+#include <QVariantList>
+#include <functional>
 #include <memory>
 #include "../../async/asyncjob.hpp"
+#include "../../async/coro.hpp"
+#include "../../async/graph.hpp"
 #include "installer.hpp"
 
 namespace K3s {
@@ -27,6 +34,7 @@ class JobManager : public QObject
     Q_OBJECT
     Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
     Q_PROPERTY(QString currentOperation READ currentOperation NOTIFY currentOperationChanged)
+    Q_PROPERTY(QVariantList queue READ queue NOTIFY queueChanged)
     
 public:
     enum class State {
@@ -50,6 +58,33 @@ public:
         QString name;
         QString deploymentYaml;
         bool subscribe = false;
+        QString node;           // empty: read from the deployment's nodeSelector
+    };
+    
+    // One step of an installation graph: once the steps named in 'after'
+    // have succeeded, the Jobs in removeJobs are deleted, requireNode is
+    // checked, the Job manifest applyJob is applied server-side and the
+    // commands run in order. With waitForJob set the step then lasts
+    // until that Kubernetes Job has completed or failed. kubectl is only
+    // used when the Kubernetes API is not available.
+    struct InstallStep {
+        QString name;
+        QString label;          // reported as progress when the step starts
+        QStringList removeJobs; // missing ones are fine
+        QString requireNode;    // the step fails unless this node is Ready
+        QString applyJob;       // manifest file of the Job waitForJob
+        QStringList commands;
+        QString waitForJob;
+        QStringList after;
+        int timeoutSec = 0;     // per attempt, 0 = none
+        int retries = 0;
+        // All run on the pool thread: skipIf when the step is due (true
+        // counts the step as done without running it), onWaiting about
+        // once a second while waitForJob runs, onDone with the duration
+        // in ms once it succeeded.
+        std::function<bool()> skipIf;
+        std::function<void()> onWaiting;
+        std::function<void(qint64)> onDone;
     };
     
     struct InstallationRequest {
@@ -57,16 +92,35 @@ public:
         QString appName;
         QStringList commands;
         QString category;
+        QList<InstallStep> steps;   // when set, run as an Async::Graph instead of commands
+        QString node = "xip";       // where the image goes, for the queue's limits
     };
     
     explicit JobManager(QObject *parent = nullptr);
     ~JobManager();
     
-    // State accessors
+    // State accessors: busy while any operation runs
     bool isBusy() const { return m_state != State::Idle; }
     State currentState() const { return m_state; }
     QString currentOperation() const { return m_currentOperation; }
     
+    /*  Deploy, remove and install requests are queued rather than
+     *  rejected. They run concurrently up to the limit of their node
+     *  (DK_NODE_CONCURRENCY="xip=2,vip=1" by default); operations on
+     *  the same app id run one after another. Restart and scale still
+     *  need the manager to be idle.                                    */
+    Q_INVOKABLE void setNodeConcurrency(const QString &node, int limit);
+    int nodeConcurrency(const QString &node) const;
+    
+    // [{ appId, operation, node, running, position, etaSec }], running first
+    QVariantList queue() const;
+    // 0 = running, n = n-th waiting, -1 = not queued
+    Q_INVOKABLE int queuePosition(const QString &appId) const;
+    // until the app's last queued operation is done, -1 = not queued
+    Q_INVOKABLE int queueEtaSec(const QString &appId) const;
+    // drops the app's waiting operations; they finish as failed
+    Q_INVOKABLE bool cancelQueued(const QString &appId);
+    
     // Core operations - all go through central orchestration
     Q_INVOKABLE Async::Job<JobResult>* deployService(const DeploymentInfo &info);
     Q_INVOKABLE Async::Job<JobResult>* removeService(const QString &id, const QString &deploymentYaml);
@@ -89,35 +143,82 @@ signals:
     void busyChanged(bool busy);
     void stateChanged(State newState);
     void currentOperationChanged(const QString &operation);
+    void queueChanged();
     void jobStarted(const QString &operation);
     void jobFinished(const QString &operation, bool success, const QString &message);
     void requestRejected(const QString &reason);
+    void installProgress(const QString &appId, const QString &message);
+    
+    // Pushed from the informer's watches, once per change
+    void deploymentStatusChanged(const QString &deploymentId, bool available);
+    void nodeStatusChanged(const QString &nodeName, bool ready);
 
 private slots:
     void onInstallerFinished(bool success);
     
 private:
+    // A queued deploy, remove or install
+    struct Operation {
+        quint64 ticket = 0;
+        State kind = State::Idle;
+        QString appId;
+        QString node;
+        QString name;
+        QString doneMessage;
+        std::function<Async::Job<JobResult>*()> start;     // on the main thread
+        std::shared_ptr<QPromise<JobResult>> promise;
+        QElapsedTimer clock;                                // since start
+    };
+    
     // Central state management
-    bool tryAcquireState(State newState, const QString &operation);
+    bool tryAcquireState(State newState, const QString &operation);   // exclusive
     void releaseState();
-    void setState(State newState, const QString &operation = QString());
+    void updateState();
+    
+    // Queue
+    Async::Job<JobResult>* enqueue(State kind, const QString &appId, const QString &node,
+                                   const QString &operation, const QString &doneMessage,
+                                   std::function<Async::Job<JobResult>*()> start);
+    void dispatch();
+    void onOperationFinished(quint64 ticket, bool ok, const JobResult &result);
+    double expectedSec(State kind) const;
+    int nodeLimit(const QString &node) const;               // caller holds m_stateMutex
+    QHash<quint64, int> estimateEtas() const;               // ticket -> seconds
+    static QString nodeOfDeployment(const QString &deploymentYaml);
     
     // Thread-safe job creation
     template<typename T>
-    Async::Job<T>* createJobSafely(std::function<T()> task);
-    Async::Chain* createChainSafely();
+    Async::Job<T>* createJobSafely(const Async::RunOptions &opts, std::function<T()> task);
+    Async::Chain* createChainSafely(const Async::RunOptions &opts);
+    template<typename T>
+    Async::Job<T>* createTaskJobSafely(std::function<Async::Task<T>()> start);
     
     // Core execution methods
-    JobResult executeCommandsSync(const QStringList &commands);
-    JobResult performDeployment(const DeploymentInfo &info);
+    // a cancelled token kills the running command
+    JobResult executeCommandsSync(const QStringList &commands,
+                                  const Async::CancelToken &token = Async::CancelToken());
+    
+    // Coroutines: run on the main thread, hold no thread while waiting
+    Async::Task<JobResult> executeCommandAsync(QString command);
+    Async::Task<JobResult> performDeployment(DeploymentInfo info);
+    Async::Task<bool> waitForRollout(QString deploymentName, int maxWaitSec);
     JobResult performRemoval(const QString &id, const QString &deploymentYaml);
     JobResult performInstallation(const InstallationRequest &request);
+    Async::Task<JobResult> performInstallationGraph(InstallationRequest request);
     
     // Helper methods
     bool waitForPodTermination(const QString &deploymentName, int maxWaitSec = 30);
+    JobResult scaleTo(const QString &deploymentName, int replicas);
     bool waitForPodsReady(const QString &deploymentName, int maxWaitSec = 180);
     bool forceDeletePods(const QString &deploymentName);
     bool deploymentExists(const QString &deploymentName);
+    bool nodeReady(const QString &nodeName, int timeoutSec);
+    JobResult applyJob(const QString &jobName, const QString &manifestFile);
+    JobResult removeJobs(const QStringList &jobs);
+    JobResult waitForJobCompletion(const QString &appId, const QString &jobName,
+                                   const QString &staleUid, int timeoutSec,
+                                   const Async::CancelToken &token,
+                                   const std::function<void()> &onWaiting = {});
     
     Installer *m_installer;
     QThread *m_mainThread;
@@ -126,6 +227,15 @@ private:
     State m_state;
     QString m_currentOperation;
     mutable QMutex m_stateMutex;
+    State m_exclusive = State::Idle;        // restart/scale holding the manager
+    QString m_exclusiveOperation;
+    
+    // Queue, touched on the main thread only
+    QList<Operation> m_waiting;
+    QList<Operation> m_running;
+    QHash<QString, int> m_nodeLimits;
+    QHash<int, double> m_avgSec;            // by State, moving average of successes
+    quint64 m_nextTicket = 1;
     
     // Singleton
     static QMutex s_instanceMutex;
@@ -0,0 +1,585 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "kubeclient.hpp"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QSslCertificate>
+#include <QSslKey>
+#include <QSslSocket>
+#include <QThread>
+
+using namespace K3s;
+
+namespace {
+    const QString SERVICE_ACCOUNT_DIR = "/var/run/secrets/kubernetes.io/serviceaccount";
+
+    QByteArray readFile(const QString &path)
+    {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        return f.readAll();
+    }
+
+    // value of the first "key: value" line, quotes removed
+    QString yamlValue(const QStringList &lines, const QString &key)
+    {
+        const QString prefix = key + ":";
+        for (const QString &line : lines) {
+            QString t = line.trimmed();
+            if (t.startsWith("- ")) {
+                t = t.mid(2).trimmed();
+            }
+            if (!t.startsWith(prefix)) {
+                continue;
+            }
+            QString v = t.mid(prefix.size()).trimmed();
+            if (v.size() >= 2 && (v.startsWith('"') || v.startsWith('\'')) && v.endsWith(v.front())) {
+                v = v.mid(1, v.size() - 2);
+            }
+            return v;
+        }
+        return {};
+    }
+
+    // inline base64 data, else the file next to the kubeconfig
+    QByteArray pemFrom(const QStringList &lines, const QString &key, const QDir &baseDir)
+    {
+        const QString data = yamlValue(lines, key + "-data");
+        if (!data.isEmpty()) {
+            return QByteArray::fromBase64(data.toLatin1());
+        }
+        const QString file = yamlValue(lines, key);
+        return file.isEmpty() ? QByteArray() : readFile(baseDir.absoluteFilePath(file));
+    }
+
+    QSslKey privateKey(const QByteArray &pem)
+    {
+        if (pem.contains("EC PRIVATE KEY")) {
+            return QSslKey(pem, QSsl::Ec);
+        }
+        // PKCS#8 does not name the algorithm in its header
+        QSslKey key(pem, QSsl::Rsa);
+        return key.isNull() ? QSslKey(pem, QSsl::Ec) : key;
+    }
+
+    QString kindPath(Kind kind)
+    {
+        switch (kind) {
+        case Kind::Deployment: return "/apis/apps/v1/namespaces/%1/deployments";
+        case Kind::Pod:        return "/api/v1/namespaces/%1/pods";
+        case Kind::Node:       return "/api/v1/nodes";
+        case Kind::Job:        return "/apis/batch/v1/namespaces/%1/jobs";
+        }
+        return {};
+    }
+    
+    bool conditionTrue(const QJsonObject &resource, const QString &type)
+    {
+        const QJsonArray conditions = resource.value("status").toObject().value("conditions").toArray();
+        for (const QJsonValue &v : conditions) {
+            const QJsonObject o = v.toObject();
+            if (o.value("type").toString() == type) {
+                return o.value("status").toString() == QLatin1String("True");
+            }
+        }
+        return false;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* configuration                                                      */
+/* ------------------------------------------------------------------ */
+KubeConfig KubeConfig::load()
+{
+    QStringList candidates;
+    const QString env = qEnvironmentVariable("KUBECONFIG");
+    if (!env.isEmpty()) {
+        candidates << env.split(':', Qt::SkipEmptyParts);
+    }
+    candidates << QDir::homePath() + "/.kube/config"
+               << "/etc/rancher/k3s/k3s.yaml";
+
+    for (const QString &path : candidates) {
+        KubeConfig config = fromFile(path);
+        if (config.isValid()) {
+            return config;
+        }
+    }
+    return inCluster();
+}
+
+KubeConfig KubeConfig::fromFile(const QString &path)
+{
+    KubeConfig config;
+    const QByteArray raw = readFile(path);
+    if (raw.isEmpty()) {
+        return config;
+    }
+
+    const QStringList lines = QString::fromUtf8(raw).split('\n');
+    const QDir baseDir = QFileInfo(path).absoluteDir();
+
+    config.server = QUrl(yamlValue(lines, "server"));
+    config.token  = yamlValue(lines, "token").toUtf8();
+    config.source = path;
+    config.ssl    = QSslConfiguration::defaultConfiguration();
+
+    const QByteArray caPem   = pemFrom(lines, "certificate-authority", baseDir);
+    const QByteArray certPem = pemFrom(lines, "client-certificate", baseDir);
+    const QByteArray keyPem  = pemFrom(lines, "client-key", baseDir);
+
+    if (!caPem.isEmpty()) {
+        config.ssl.setCaCertificates(QSslCertificate::fromData(caPem, QSsl::Pem));
+    }
+    if (!certPem.isEmpty()) {
+        // k3s puts the client CA after the client certificate
+        config.ssl.setLocalCertificateChain(QSslCertificate::fromData(certPem, QSsl::Pem));
+    }
+    if (!keyPem.isEmpty()) {
+        const QSslKey key = privateKey(keyPem);
+        if (key.isNull()) {
+            qWarning() << "[KubeClient] Unreadable client key in" << path;
+        }
+        config.ssl.setPrivateKey(key);
+    }
+    if (yamlValue(lines, "insecure-skip-tls-verify") == "true") {
+        config.ssl.setPeerVerifyMode(QSslSocket::VerifyNone);
+    }
+    return config;
+}
+
+KubeConfig KubeConfig::inCluster()
+{
+    KubeConfig config;
+    const QString host = qEnvironmentVariable("KUBERNETES_SERVICE_HOST");
+    const QString port = qEnvironmentVariable("KUBERNETES_SERVICE_PORT", "443");
+    if (host.isEmpty()) {
+        return config;
+    }
+
+    config.server.setScheme("https");
+    config.server.setHost(host);
+    config.server.setPort(port.toInt());
+    config.token  = readFile(SERVICE_ACCOUNT_DIR + "/token").trimmed();
+    config.source = "in-cluster";
+    config.ssl    = QSslConfiguration::defaultConfiguration();
+    config.ssl.setCaCertificates(QSslCertificate::fromPath(SERVICE_ACCOUNT_DIR + "/ca.crt"));
+    return config;
+}
+
+/* ------------------------------------------------------------------ */
+/* client                                                             */
+/* ------------------------------------------------------------------ */
+KubeClient &KubeClient::instance()
+{
+    static KubeClient client;
+    return client;
+}
+
+KubeClient::KubeClient()
+    : m_config(KubeConfig::load())
+{
+    if (isAvailable()) {
+        qDebug() << "[KubeClient] API server" << m_config.server.toString()
+                 << "from" << m_config.source;
+    } else {
+        qWarning() << "[KubeClient] No kubeconfig or service account found, Kubernetes API unavailable";
+    }
+}
+
+QNetworkAccessManager *KubeClient::manager()
+{
+    // One manager per thread: requests are made from the pools as well
+    // and each manager keeps its connection to the API server open. The
+    // GUI thread's manager goes away with the application.
+    struct Holder {
+        QPointer<QNetworkAccessManager> nam;
+        ~Holder() { if (nam && !nam->parent()) delete nam.data(); }
+    };
+    thread_local Holder holder;
+
+    if (!holder.nam) {
+        auto *nam = new QNetworkAccessManager;
+        if (qApp && QThread::currentThread() == qApp->thread()) {
+            nam->setParent(qApp);
+        }
+        holder.nam = nam;
+    }
+    return holder.nam;
+}
+
+QString KubeClient::resourcePath(Kind kind, const QString &name, const QString &ns)
+{
+    QString path = kindPath(kind);
+    if (kind != Kind::Node) {
+        path = path.arg(ns.isEmpty() ? QString("default") : ns);
+    }
+    if (!name.isEmpty()) {
+        path += "/" + QString::fromLatin1(QUrl::toPercentEncoding(name));
+    }
+    return path;
+}
+
+QNetworkReply *KubeClient::send(const QByteArray &verb, const QString &path, const QUrlQuery &query,
+                                const QJsonObject &body, const QByteArray &contentType, int timeoutMs)
+{
+    const QByteArray data = body.isEmpty() ? QByteArray()
+                                           : QJsonDocument(body).toJson(QJsonDocument::Compact);
+    return send(verb, path, query, data, contentType, timeoutMs);
+}
+
+QNetworkReply *KubeClient::send(const QByteArray &verb, const QString &path, const QUrlQuery &query,
+                                const QByteArray &data, const QByteArray &contentType, int timeoutMs)
+{
+    QUrl url = m_config.server;
+    url.setPath(url.path() + path);
+    url.setQuery(query);
+
+    QNetworkRequest req(url);
+    req.setSslConfiguration(m_config.ssl);
+    req.setRawHeader("Accept", "application/json");
+    if (!m_config.token.isEmpty()) {
+        req.setRawHeader("Authorization", "Bearer " + m_config.token);
+    }
+    req.setTransferTimeout(timeoutMs);
+
+    if (!data.isEmpty()) {
+        req.setHeader(QNetworkRequest::ContentTypeHeader, contentType);
+    }
+    return manager()->sendCustomRequest(req, verb, data);
+}
+
+KubeResult KubeClient::unavailable() const
+{
+    KubeResult result;
+    result.error = "Kubernetes API not configured";
+    return result;
+}
+
+QUrlQuery KubeClient::applyQuery()
+{
+    // one field manager for every apply, conflicts with kubectl edits are taken over
+    QUrlQuery query;
+    query.addQueryItem("fieldManager", "dk-ivi");
+    query.addQueryItem("force", "true");
+    return query;
+}
+
+KubeResult KubeClient::toResult(QNetworkReply *reply)
+{
+    KubeResult result;
+    result.httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    const QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+    if (doc.isObject()) {
+        result.object = doc.object();
+    }
+
+    result.ok = reply->error() == QNetworkReply::NoError
+                && result.httpStatus >= 200 && result.httpStatus < 300;
+    if (!result.ok) {
+        // a Status object explains API errors better than the reply
+        const QString message = result.object.value("message").toString();
+        result.error = message.isEmpty() ? reply->errorString() : message;
+    }
+    return result;
+}
+
+KubeResult KubeClient::request(const QByteArray &verb, const QString &path, const QUrlQuery &query,
+                               const QJsonObject &body, const QByteArray &contentType, int timeoutMs)
+{
+    if (!isAvailable()) {
+        return unavailable();
+    }
+
+    QNetworkReply *reply = send(verb, path, query, body, contentType, timeoutMs);
+    if (!reply->isFinished()) {
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    const KubeResult result = toResult(reply);
+    delete reply;       // pool threads have no event loop for deleteLater()
+    return result;
+}
+
+Async::Task<KubeResult> KubeClient::requestAsync(QByteArray verb, QString path, QUrlQuery query,
+                                                 QJsonObject body, QByteArray contentType, int timeoutMs)
+{
+    if (!isAvailable()) {
+        co_return unavailable();
+    }
+
+    QNetworkReply *reply = send(verb, path, query, body, contentType, timeoutMs);
+    if (!reply->isFinished()) {
+        co_await Async::signal(reply, &QNetworkReply::finished);
+    }
+
+    const KubeResult result = toResult(reply);
+    reply->deleteLater();
+    co_return result;
+}
+
+/* ------------------------------------------------------------------ */
+/* typed helpers                                                      */
+/* ------------------------------------------------------------------ */
+KubeResult KubeClient::get(Kind kind, const QString &name, const QString &ns, int timeoutMs)
+{
+    return request("GET", resourcePath(kind, name, ns), QUrlQuery(), QJsonObject(),
+                   "application/json", timeoutMs);
+}
+
+Async::Task<KubeResult> KubeClient::getAsync(Kind kind, QString name, QString ns, int timeoutMs)
+{
+    return requestAsync("GET", resourcePath(kind, name, ns), QUrlQuery(), QJsonObject(),
+                        "application/json", timeoutMs);
+}
+
+KubeResult KubeClient::list(Kind kind, const QString &labelSelector, const QString &ns)
+{
+    QUrlQuery query;
+    if (!labelSelector.isEmpty()) {
+        query.addQueryItem("labelSelector", labelSelector);
+    }
+    return request("GET", resourcePath(kind, QString(), ns), query);
+}
+
+QNetworkReply *KubeClient::watch(Kind kind, const QString &resourceVersion, int timeoutSec,
+                                 const QString &ns)
+{
+    if (!isAvailable()) {
+        return nullptr;
+    }
+
+    QUrlQuery query;
+    query.addQueryItem("watch", "1");
+    query.addQueryItem("allowWatchBookmarks", "true");
+    query.addQueryItem("timeoutSeconds", QString::number(timeoutSec));
+    if (!resourceVersion.isEmpty()) {
+        query.addQueryItem("resourceVersion", resourceVersion);
+    }
+    // the server ends the watch after timeoutSec, so no bytes for
+    // longer than that means the connection has stalled
+    return send("GET", resourcePath(kind, QString(), ns), query, QJsonObject(),
+                QByteArray(), (timeoutSec + WATCH_GRACE_SEC) * 1000);
+}
+
+KubeResult KubeClient::apply(const QJsonObject &manifest, const QString &ns)
+{
+    const QString kind = manifest.value("kind").toString();
+    const QString name = manifest.value("metadata").toObject().value("name").toString();
+
+    Kind k;
+    if (kind == "Deployment")  k = Kind::Deployment;
+    else if (kind == "Pod")    k = Kind::Pod;
+    else if (kind == "Node")   k = Kind::Node;
+    else if (kind == "Job")    k = Kind::Job;
+    else {
+        KubeResult result;
+        result.error = QString("Unsupported kind: %1").arg(kind);
+        return result;
+    }
+
+    // JSON is valid YAML, the apply patch content type accepts it
+    return request("PATCH", resourcePath(k, name, ns), applyQuery(), manifest,
+                   "application/apply-patch+yaml");
+}
+
+KubeResult KubeClient::applyYaml(Kind kind, const QString &name, const QByteArray &yaml,
+                                 const QString &ns)
+{
+    if (!isAvailable()) {
+        return unavailable();
+    }
+
+    QNetworkReply *reply = send("PATCH", resourcePath(kind, name, ns), applyQuery(), yaml,
+                                "application/apply-patch+yaml", DEFAULT_TIMEOUT_MS);
+    if (!reply->isFinished()) {
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    const KubeResult result = toResult(reply);
+    delete reply;
+    return result;
+}
+
+Async::Task<KubeResult> KubeClient::applyYamlAsync(Kind kind, QString name, QByteArray yaml,
+                                                   QString ns)
+{
+    if (!isAvailable()) {
+        co_return unavailable();
+    }
+
+    QNetworkReply *reply = send("PATCH", resourcePath(kind, name, ns), applyQuery(), yaml,
+                                "application/apply-patch+yaml", DEFAULT_TIMEOUT_MS);
+    if (!reply->isFinished()) {
+        co_await Async::signal(reply, &QNetworkReply::finished);
+    }
+
+    const KubeResult result = toResult(reply);
+    reply->deleteLater();
+    co_return result;
+}
+
+Async::Task<KubeResult> KubeClient::removeAsync(Kind kind, QString name, QString ns)
+{
+    KubeResult result = co_await requestAsync("DELETE", resourcePath(kind, name, ns), QUrlQuery(),
+                                              deleteOptions(-1));
+    if (result.notFound()) {
+        result.ok = true;
+        result.error.clear();
+    }
+    co_return result;
+}
+
+KubeResult KubeClient::patch(Kind kind, const QString &name, const QJsonObject &mergePatch,
+                             const QString &ns)
+{
+    return request("PATCH", resourcePath(kind, name, ns), QUrlQuery(), mergePatch,
+                   "application/merge-patch+json");
+}
+
+QJsonObject KubeClient::deleteOptions(int gracePeriodSec)
+{
+    QJsonObject options {
+        { "kind", "DeleteOptions" },
+        { "apiVersion", "v1" },
+        { "propagationPolicy", "Background" }
+    };
+    if (gracePeriodSec >= 0) {
+        options.insert("gracePeriodSeconds", gracePeriodSec);
+    }
+    return options;
+}
+
+KubeResult KubeClient::remove(Kind kind, const QString &name, const QString &ns, int gracePeriodSec)
+{
+    KubeResult result = request("DELETE", resourcePath(kind, name, ns), QUrlQuery(),
+                                deleteOptions(gracePeriodSec));
+    if (result.notFound()) {
+        result.ok = true;
+        result.error.clear();
+    }
+    return result;
+}
+
+KubeResult KubeClient::removeAll(Kind kind, const QString &labelSelector, const QString &ns,
+                                 int gracePeriodSec)
+{
+    QUrlQuery query;
+    query.addQueryItem("labelSelector", labelSelector);
+    return request("DELETE", resourcePath(kind, QString(), ns), query,
+                   deleteOptions(gracePeriodSec));
+}
+
+KubeResult KubeClient::scale(const QString &deployment, int replicas, const QString &ns)
+{
+    const QJsonObject body { { "spec", QJsonObject { { "replicas", replicas } } } };
+    return request("PATCH", resourcePath(Kind::Deployment, deployment, ns) + "/scale",
+                   QUrlQuery(), body, "application/merge-patch+json");
+}
+
+KubeResult KubeClient::restart(const QString &deployment, const QString &ns)
+{
+    const QJsonObject annotations {
+        { "kubectl.kubernetes.io/restartedAt",
+          QDateTime::currentDateTimeUtc().toString(Qt::ISODate) }
+    };
+    const QJsonObject body { { "spec", QJsonObject { { "template", QJsonObject {
+        { "metadata", QJsonObject { { "annotations", annotations } } } } } } } };
+    return patch(Kind::Deployment, deployment, body, ns);
+}
+
+/* ------------------------------------------------------------------ */
+/* status evaluation                                                  */
+/* ------------------------------------------------------------------ */
+bool KubeClient::nodeReady(const QJsonObject &node)
+{
+    return conditionTrue(node, "Ready");
+}
+
+bool KubeClient::deploymentAvailable(const QJsonObject &deployment)
+{
+    return conditionTrue(deployment, "Available");
+}
+
+int KubeClient::replicas(const QJsonObject &deployment)
+{
+    return deployment.value("status").toObject().value("replicas").toInt();
+}
+
+int KubeClient::readyReplicas(const QJsonObject &deployment)
+{
+    return deployment.value("status").toObject().value("readyReplicas").toInt();
+}
+
+bool KubeClient::rolloutComplete(const QJsonObject &deployment)
+{
+    const QJsonObject metadata = deployment.value("metadata").toObject();
+    const QJsonObject status = deployment.value("status").toObject();
+    if (status.value("observedGeneration").toInteger() < metadata.value("generation").toInteger()) {
+        return false;       // the controller has not seen the latest spec yet
+    }
+    const int wanted = deployment.value("spec").toObject().value("replicas").toInt(1);
+    const int updated = status.value("updatedReplicas").toInt();
+    return updated >= wanted
+        && status.value("replicas").toInt() <= updated     // no old pods left
+        && status.value("availableReplicas").toInt() >= updated;
+}
+
+bool KubeClient::jobComplete(const QJsonObject &job)
+{
+    return conditionTrue(job, "Complete");
+}
+
+bool KubeClient::jobFailed(const QJsonObject &job, QString *message)
+{
+    const QJsonArray conditions = job.value("status").toObject().value("conditions").toArray();
+    for (const QJsonValue &v : conditions) {
+        const QJsonObject o = v.toObject();
+        if (o.value("type").toString() == QLatin1String("Failed")
+            && o.value("status").toString() == QLatin1String("True")) {
+            if (message)
+                *message = o.value("message").toString();
+            return true;
+        }
+    }
+    return false;
+}
+
+QString KubeClient::waitingReason(const QJsonObject &pod, QString *message)
+{
+    const QJsonObject status = pod.value("status").toObject();
+    for (const char *key : { "initContainerStatuses", "containerStatuses" }) {
+        for (const QJsonValue &v : status.value(key).toArray()) {
+            const QJsonObject waiting = v.toObject().value("state").toObject()
+                                         .value("waiting").toObject();
+            if (!waiting.isEmpty()) {
+                if (message)
+                    *message = waiting.value("message").toString();
+                return waiting.value("reason").toString();
+            }
+        }
+    }
+    return QString();
+}
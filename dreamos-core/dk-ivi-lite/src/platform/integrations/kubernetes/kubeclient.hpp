@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+// k3s/kubeclient.hpp
+//
+// Talks to the Kubernetes API server over HTTPS instead of spawning
+// kubectl: no process start and kubeconfig parsing per call, one kept
+// alive connection per thread and JSON results instead of parsed text.
+// Manifests on disk are YAML: the apply patch takes them as they are.
+//
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSslConfiguration>
+#include <QString>
+#include <QUrl>
+#include <QUrlQuery>
+#include "../../async/coro.hpp"
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+namespace K3s {
+
+enum class Kind {
+    Deployment,
+    Pod,
+    Node,           // cluster scoped, the namespace is ignored
+    Job
+};
+
+struct KubeResult {
+    bool        ok = false;
+    int         httpStatus = 0;     // 0 = no response: network, TLS or timeout
+    QJsonObject object;             // the resource, the list or the API's Status
+    QString     error;
+
+    bool notFound() const { return httpStatus == 404; }
+    QJsonArray items() const { return object.value("items").toArray(); }
+};
+
+struct KubeConfig {
+    QUrl              server;
+    QSslConfiguration ssl;
+    QByteArray        token;
+    QString           source;       // file it was read from, or "in-cluster"
+
+    bool isValid() const { return server.isValid() && !server.host().isEmpty(); }
+
+    // First usable of $KUBECONFIG, ~/.kube/config and the k3s kubeconfig,
+    // then the pod's service account. Reads single-cluster kubeconfigs
+    // like the one k3s writes; contexts are not evaluated.
+    static KubeConfig load();
+    static KubeConfig fromFile(const QString &path);
+    static KubeConfig inCluster();
+};
+
+class KubeClient
+{
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 10000;
+    static constexpr int WATCH_GRACE_SEC = 30;     // beyond a watch's timeoutSec
+
+    static KubeClient &instance();
+
+    bool isAvailable() const { return m_config.isValid(); }
+    const KubeConfig &config() const { return m_config; }
+
+    /* ---- blocking calls: any thread, meant for the Async pools ---- */
+    KubeResult get(Kind kind, const QString &name, const QString &ns = "default",
+                   int timeoutMs = DEFAULT_TIMEOUT_MS);
+    KubeResult list(Kind kind, const QString &labelSelector = QString(),
+                    const QString &ns = "default");
+    // server-side apply of a JSON manifest
+    KubeResult apply(const QJsonObject &manifest, const QString &ns = "default");
+    // server-side apply of a manifest file's YAML, as kubectl apply --server-side
+    KubeResult applyYaml(Kind kind, const QString &name, const QByteArray &yaml,
+                         const QString &ns = "default");
+    KubeResult patch(Kind kind, const QString &name, const QJsonObject &mergePatch,
+                     const QString &ns = "default");
+    // background propagation like kubectl; a missing resource counts as ok
+    KubeResult remove(Kind kind, const QString &name, const QString &ns = "default",
+                      int gracePeriodSec = -1);
+    KubeResult removeAll(Kind kind, const QString &labelSelector,
+                         const QString &ns = "default", int gracePeriodSec = -1);
+    KubeResult scale(const QString &deployment, int replicas, const QString &ns = "default");
+    // same as kubectl rollout restart
+    KubeResult restart(const QString &deployment, const QString &ns = "default");
+
+    KubeResult request(const QByteArray &verb, const QString &path,
+                       const QUrlQuery &query = QUrlQuery(),
+                       const QJsonObject &body = QJsonObject(),
+                       const QByteArray &contentType = "application/json",
+                       int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /* ---- coroutines: resumed on the calling thread's event loop ---- */
+    Async::Task<KubeResult> getAsync(Kind kind, QString name, QString ns = "default",
+                                     int timeoutMs = DEFAULT_TIMEOUT_MS);
+    Async::Task<KubeResult> requestAsync(QByteArray verb, QString path,
+                                         QUrlQuery query = QUrlQuery(),
+                                         QJsonObject body = QJsonObject(),
+                                         QByteArray contentType = "application/json",
+                                         int timeoutMs = DEFAULT_TIMEOUT_MS);
+    // server-side apply of a manifest file's YAML, as kubectl apply --server-side
+    Async::Task<KubeResult> applyYamlAsync(Kind kind, QString name, QByteArray yaml,
+                                           QString ns = "default");
+    Async::Task<KubeResult> removeAsync(Kind kind, QString name, QString ns = "default");
+
+    /*  Starts a watch from resourceVersion: the reply streams one JSON
+     *  event per line until the server ends it after timeoutSec. The
+     *  caller owns the reply; it belongs to the calling thread.      */
+    QNetworkReply *watch(Kind kind, const QString &resourceVersion, int timeoutSec = 300,
+                         const QString &ns = "default");
+
+    static QString resourcePath(Kind kind, const QString &name = QString(),
+                                const QString &ns = "default");
+
+    // status evaluation shared by the callers
+    static bool nodeReady(const QJsonObject &node);
+    static bool deploymentAvailable(const QJsonObject &deployment);   // condition Available
+    static int  replicas(const QJsonObject &deployment);              // status.replicas
+    static int  readyReplicas(const QJsonObject &deployment);
+    // the latest spec is rolled out and available, as kubectl rollout status
+    static bool rolloutComplete(const QJsonObject &deployment);
+    static bool jobComplete(const QJsonObject &job);                  // condition Complete
+    static bool jobFailed(const QJsonObject &job, QString *message = nullptr);
+    // reason of the first waiting container, e.g. ErrImagePull; empty if none
+    static QString waitingReason(const QJsonObject &pod, QString *message = nullptr);
+
+private:
+    KubeClient();
+    KubeClient(const KubeClient &) = delete;
+    KubeClient &operator=(const KubeClient &) = delete;
+
+    QNetworkReply *send(const QByteArray &verb, const QString &path, const QUrlQuery &query,
+                        const QJsonObject &body, const QByteArray &contentType, int timeoutMs);
+    QNetworkReply *send(const QByteArray &verb, const QString &path, const QUrlQuery &query,
+                        const QByteArray &data, const QByteArray &contentType, int timeoutMs);
+    KubeResult unavailable() const;
+    static QUrlQuery applyQuery();
+    static KubeResult toResult(QNetworkReply *reply);
+    static QJsonObject deleteOptions(int gracePeriodSec);
+    static QNetworkAccessManager *manager();
+
+    KubeConfig m_config;
+};
+
+} // namespace K3s
@@ -7,8 +7,10 @@
 // SPDX-License-Identifier: MIT
 #include "manifestbuilder.hpp"
 #include "../../data/jsonstorage.hpp"
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <QRegularExpression>
 #include <QTextStream>
 #include <QDebug>
 
@@ -17,7 +19,12 @@ using Core::JsonStorage;
 
 static QString writeFile(const QString &fn, const QString &txt)
 {
+    // an unchanged manifest keeps its file (and mtime) as it is
     QFile f(fn);
+    if (f.open(QIODevice::ReadOnly) && f.readAll() == txt.toUtf8()) {
+        return fn;
+    }
+    f.close();
     if (!f.open(QIODevice::WriteOnly)) {
         qWarning() << "ManifestBuilder: cannot write" << fn;
         return {};
@@ -26,6 +33,26 @@ static QString writeFile(const QString &fn, const QString &txt)
     return fn;
 }
 
+// fills in the ${hash} annotation with the hash of everything else
+static QString stamp(QString yaml, QString *hash = nullptr)
+{
+    const QString h = QString::fromLatin1(
+        QCryptographicHash::hash(yaml.toUtf8(), QCryptographicHash::Sha256).toHex().left(16));
+    if (hash) {
+        *hash = h;
+    }
+    return yaml.replace("${hash}", h);
+}
+
+QString ManifestBuilder::hashOf(const QByteArray &yaml)
+{
+    // the first one is the object's own, pod templates carry none
+    static const QRegularExpression re(
+        QString(R"(^\s*%1:\s*"?([0-9a-f]+)"?\s*$)").arg(QRegularExpression::escape(HASH_ANNOTATION)),
+        QRegularExpression::MultilineOption);
+    return re.match(QString::fromUtf8(yaml)).captured(1);
+}
+
 ManifestInfo ManifestBuilder::write(const AppInfo &app)
 {
     ManifestInfo info;
@@ -54,6 +81,7 @@ ManifestInfo ManifestBuilder::write(const AppInfo &app)
              
     const QString appId  = app.id;
     const QString image  = app.dashboardConfig.DockerImageURL;
+    info.image = image;
 
     // ── volume mounts generation ────────────────────────────────────
     QStringList volumeMountLines;
@@ -164,6 +192,8 @@ kind: Deployment
 metadata:
   name: ${name}
   namespace: default
+  annotations:
+    dreamkit/manifest-hash: "${hash}"
 spec:
   replicas: 1
   strategy:
@@ -269,13 +299,15 @@ ${volumes_section}
 
     info.deploymentYaml = writeFile(
         QString("%1/%2_deployment.yaml").arg(info.dir, app.id),
-        deployYaml);
+        stamp(deployYaml, &info.deploymentHash));
 
     // ── pull job yaml ───────────────────────────────────────────────
     static const char *pullTpl = R"(apiVersion: batch/v1
 kind: Job
 metadata:
   name: pull-${name}
+  annotations:
+    dreamkit/manifest-hash: "${hash}"
 spec:
   template:
     spec:
@@ -295,7 +327,7 @@ spec:
             .replace("${image}", image);
 
     info.pullJobYaml = writeFile(
-        QString("%1/%2_pull.yaml").arg(info.dir, app.id), pullYaml);
+        QString("%1/%2_pull.yaml").arg(info.dir, app.id), stamp(pullYaml));
 
     // ── mirror job yaml (only if remote) ────────────────────────────
     if (info.isRemoteNode) {
@@ -312,11 +344,14 @@ spec:
         }
         
         const QString mirrorImg = QString("localhost:5000/%1").arg(rest);      
+        info.mirrorImage = mirrorImg;
 
         static const char *mirrorTpl = R"(apiVersion: batch/v1
 kind: Job
 metadata:
   name: mirror-${name}
+  annotations:
+    dreamkit/manifest-hash: "${hash}"
 spec:
   backoffLimit: 1
   template:
@@ -342,7 +377,7 @@ spec:
                 .replace("${src}",   image)
                 .replace("${dst}",   mirrorImg);
         info.mirrorJobYaml = writeFile(
-            QString("%1/%2_mirror.yaml").arg(info.dir, app.id), mirrorYaml);
+            QString("%1/%2_mirror.yaml").arg(info.dir, app.id), stamp(mirrorYaml));
     }
     
     return info;
@@ -9,8 +9,11 @@
 // k3s/manifestbuilder.hpp
 //
 // Emits dashboard JSON + deployment / pull / mirror job YAML files.
+// Each manifest carries the hash of its content as an annotation, so an
+// apply can be left out when the live object has the same one.
 //
 #include "../../data/datamanager.hpp"
+#include <QByteArray>
 #include <QString>
 
 namespace K3s {
@@ -23,6 +26,9 @@ struct ManifestInfo
     QString deploymentYaml;
     QString pullJobYaml;
     QString mirrorJobYaml;
+    QString deploymentHash;    // value of HASH_ANNOTATION in deploymentYaml
+    QString image;             // as the deployment refers to it
+    QString mirrorImage;       // copy in the local registry, remote node only
     QString deployNodeName = "xip";
     bool    isRemoteNode = false;
     bool    hasVolumes = false;    // indicates if custom volumes were configured
@@ -31,8 +37,12 @@ struct ManifestInfo
 class ManifestBuilder
 {
 public:
+    static constexpr const char *HASH_ANNOTATION = "dreamkit/manifest-hash";
+
     // rootDir == “…/dk_marketplace”
     static ManifestInfo write(const AppInfo &app);
+    // the hash annotation of a written manifest, empty for older files
+    static QString hashOf(const QByteArray &yaml);
 };
 
 } // namespace K3s
@@ -0,0 +1,291 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "pullprogress.hpp"
+#include "../../notifications/notificationmanager.hpp"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QSysInfo>
+#include <QThread>
+#include <QUuid>
+#include <algorithm>
+#include <mutex>
+
+using namespace K3s;
+
+namespace {
+    // layers are a few KB to a few hundred MB
+    QString formatBytes(qint64 bytes)
+    {
+        if (bytes >= 1024 * 1024) {
+            return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+        }
+        return QString("%1 KB").arg((bytes + 1023) / 1024);
+    }
+
+    QString shortDigest(const QString &digest)
+    {
+        return digest.section(':', 1).left(12);
+    }
+
+    // NotificationManager is not thread safe and lives on the GUI thread
+    template<typename F>
+    void onGuiThread(F fn)
+    {
+        NotificationManager *manager = &NotificationManager::instance();
+        if (QThread::currentThread() == manager->thread()) {
+            fn(manager);
+        } else {
+            QMetaObject::invokeMethod(manager, [manager, fn]() { fn(manager); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+PullProgress::PullProgress(const QString &title, const QString &image, Target target,
+                           const QString &destination)
+    : m_title(title)
+    , m_image(image)
+    , m_destination(destination.isEmpty() ? image : destination)
+    , m_target(target)
+{
+}
+
+PullProgress::~PullProgress()
+{
+    if (!m_finished && !m_notificationId.isEmpty()) {
+        onGuiThread([id = m_notificationId](NotificationManager *manager) {
+            manager->dismissNotification(id);
+        });
+    }
+}
+
+QString PullProgress::contentRoot()
+{
+    const QString root = qEnvironmentVariable("DK_CONTAINERD_ROOT",
+                                              "/var/lib/rancher/k3s/agent/containerd");
+    return root + "/io.containerd.content.v1.content";
+}
+
+QString PullProgress::currentArchitecture()
+{
+    const QString arch = QSysInfo::currentCpuArchitecture();
+    if (arch == "x86_64") return "amd64";
+    if (arch == "i386")   return "386";
+    return arch;        // arm64, arm, riscv64, ...
+}
+
+/* ------------------------------------------------------------------ */
+/* sampling                                                           */
+/* ------------------------------------------------------------------ */
+void PullProgress::poll()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_finished || m_unavailable) {
+        return;
+    }
+    if (m_lastUpdate.isValid() && m_lastUpdate.elapsed() < UPDATE_INTERVAL_MS) {
+        return;
+    }
+    m_lastUpdate.start();
+
+    if (!m_resolved && !resolve()) {
+        m_unavailable = true;
+        return;
+    }
+    if (m_target == Target::Node) {
+        sampleNode();
+    } else {
+        sampleRegistry();
+    }
+    report();
+}
+
+bool PullProgress::resolve()
+{
+    m_resolved = true;
+    if (m_target == Target::Node && !QDir(contentRoot()).exists()) {
+        // the store is a hostPath mount of the dk-ivi pod (DK_CONTAINERD_ROOT)
+        static std::once_flag missing;
+        std::call_once(missing, []() {
+            qWarning() << "[PullProgress] No containerd content store at" << contentRoot()
+                       << "- node pulls show no layer progress";
+        });
+        return false;
+    }
+
+    // the mirror job copies every platform (skopeo --all), a node pulls its own
+    const QString arch = m_target == Target::Node ? currentArchitecture() : QString();
+    for (const ImageLayer &layer : ImageCache::layers(ImageRef::parse(m_image), arch)) {
+        m_layers << Layer{ layer.digest, layer.size, 0 };
+    }
+    if (m_layers.isEmpty()) {
+        qDebug() << "[PullProgress] Layers of" << m_image << "unknown - no layer progress";
+        return false;
+    }
+    return true;
+}
+
+void PullProgress::sampleNode()
+{
+    // ingest/<key>/{ref,data}: ref names the blob ("...layer-sha256:<hex>"),
+    // data grows as it downloads; a finished layer moves to blobs/
+    const QString root = contentRoot();
+    QHash<QString, qint64> ingesting;
+    const QDir ingest(root + "/ingest");
+    for (const QString &entry : ingest.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QFile ref(ingest.filePath(entry + "/ref"));
+        if (!ref.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QString name = QString::fromUtf8(ref.readAll()).trimmed();
+        const int at = name.indexOf("sha256:");
+        if (at >= 0) {
+            ingesting.insert(name.mid(at), QFileInfo(ingest.filePath(entry + "/data")).size());
+        }
+    }
+
+    for (Layer &layer : m_layers) {
+        if (layer.done >= layer.size) {
+            continue;
+        }
+        const QString blob = root + "/blobs/" + layer.digest.section(':', 0, 0)
+                           + "/" + layer.digest.section(':', 1);
+        if (QFileInfo::exists(blob)) {
+            layer.done = layer.size;
+        } else {
+            layer.done = std::min(ingesting.value(layer.digest, 0), layer.size);
+        }
+    }
+}
+
+void PullProgress::sampleRegistry()
+{
+    const ImageRef dest = ImageRef::parse(m_destination);
+    for (Layer &layer : m_layers) {
+        if (layer.done < layer.size && ImageCache::hasBlob(dest, layer.digest, 2000)) {
+            layer.done = layer.size;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* reporting                                                          */
+/* ------------------------------------------------------------------ */
+void PullProgress::report()
+{
+    qint64 total = 0;
+    qint64 done  = 0;
+    for (const Layer &layer : m_layers) {
+        total += layer.size;
+        done  += layer.done;
+    }
+
+    if (done != m_lastBytes) {
+        m_lastGrowth.start();
+        m_stallLogged = false;
+    }
+    // rate over the last few seconds, single samples are too noisy
+    if (!m_rateClock.isValid()) {
+        m_rateClock.start();
+        m_rateBytes = done;
+    } else if (m_rateClock.elapsed() >= 3 * UPDATE_INTERVAL_MS) {
+        const double rate = (done - m_rateBytes) * 1000.0 / m_rateClock.elapsed();
+        m_bytesPerSec = m_bytesPerSec > 0 ? 0.5 * m_bytesPerSec + 0.5 * rate : rate;
+        m_rateBytes = done;
+        m_rateClock.restart();
+    }
+    m_lastBytes = done;
+
+    const int percent = total > 0 ? int(done * 99 / total) : 0;     // 100 only on finish()
+    const QString message = describe(done, total);
+
+    // the log gets the changes of a layer and a stall, the notification the rest
+    for (Layer &layer : m_layers) {
+        const Layer::State state = layer.done >= layer.size ? Layer::Complete
+                                 : layer.done > 0           ? Layer::Transferring
+                                                            : Layer::Waiting;
+        if (state != layer.logged) {
+            layer.logged = state;
+            qDebug() << "[PullProgress]" << m_image << "layer" << shortDigest(layer.digest)
+                     << (state == Layer::Complete ? "complete," : "started,")
+                     << formatBytes(layer.size);
+        }
+    }
+    if (!m_stallLogged && m_lastGrowth.elapsed() >= STALL_SEC * 1000) {
+        m_stallLogged = true;
+        qDebug() << "[PullProgress]" << m_image << message;
+    }
+
+    // the id is made here so nothing waits on the GUI thread under m_mutex;
+    // queued calls run in order, the update never overtakes the show
+    if (m_notificationId.isEmpty()) {
+        m_notificationId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        onGuiThread([id = m_notificationId, title = m_title, message, percent]
+                    (NotificationManager *manager) {
+            manager->showProgress(title, message, percent, "image-pull", id);
+        });
+    } else {
+        onGuiThread([id = m_notificationId, message, percent](NotificationManager *manager) {
+            manager->updateProgress(id, percent, message);
+        });
+    }
+}
+
+QString PullProgress::describe(qint64 done, qint64 total) const
+{
+    int complete = 0;
+    QStringList active;
+    for (int i = 0; i < m_layers.size(); ++i) {
+        const Layer &layer = m_layers[i];
+        if (layer.done >= layer.size) {
+            ++complete;
+        } else if (layer.done > 0) {
+            active << QString("layer %1: %2 of %3").arg(i + 1)
+                          .arg(formatBytes(layer.done), formatBytes(layer.size));
+        }
+    }
+
+    QString text = QString("%1 of %2, %3/%4 layers")
+                       .arg(formatBytes(done), formatBytes(total))
+                       .arg(complete).arg(m_layers.size());
+    if (m_lastGrowth.elapsed() >= STALL_SEC * 1000) {
+        text += QString(" - stalled for %1 s").arg(m_lastGrowth.elapsed() / 1000);
+    } else if (m_bytesPerSec > 0) {
+        text += QString(" at %1/s").arg(formatBytes(qint64(m_bytesPerSec)));
+    }
+    if (!active.isEmpty()) {
+        text += "\n" + active.join(", ");
+    }
+    return text;
+}
+
+void PullProgress::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    if (m_notificationId.isEmpty()) {
+        return;
+    }
+
+    qint64 total = 0;
+    for (const Layer &layer : m_layers) {
+        total += layer.size;
+    }
+    // updateProgress completes the notification at 100
+    onGuiThread([id = m_notificationId, message = QString("%1 transferred").arg(formatBytes(total))]
+                (NotificationManager *manager) {
+        manager->updateProgress(id, 100, message);
+    });
+}
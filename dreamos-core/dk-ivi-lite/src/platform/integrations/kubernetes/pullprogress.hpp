@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+// k3s/pullprogress.hpp
+//
+// Layer-level progress of an image transfer, shown as a progress
+// notification. The layers and their sizes come from the registry; the
+// bytes transferred so far from where the layers land:
+//   Node      containerd's content store of this device (the ingest
+//             files of running downloads, the blobs of finished ones)
+//   Registry  the local registry the mirror job copies to (per layer,
+//             a layer counts once it has been pushed completely)
+//
+#include "imagecache.hpp"
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+namespace K3s {
+
+class PullProgress
+{
+public:
+    enum class Target { Node, Registry };
+
+    static constexpr int UPDATE_INTERVAL_MS = 1000;    // notification updates at most this often
+    static constexpr int STALL_SEC          = 30;      // no new bytes for this long = stalled
+
+    // destination is the image as it is stored at the target, if renamed
+    PullProgress(const QString &title, const QString &image, Target target,
+                 const QString &destination = QString());
+    ~PullProgress();                // an unfinished notification is dismissed
+
+    PullProgress(const PullProgress &) = delete;
+    PullProgress &operator=(const PullProgress &) = delete;
+
+    // Blocking; called from the waiting pool thread, throttled inside
+    void poll();
+    void finish();
+
+    // containerd of the local k3s, DK_CONTAINERD_ROOT overrides it
+    static QString contentRoot();
+    static QString currentArchitecture();      // in OCI terms
+
+private:
+    struct Layer {
+        enum State { Waiting, Transferring, Complete };
+        QString digest;
+        qint64  size = 0;
+        qint64  done = 0;
+        State   logged = Waiting;
+    };
+
+    bool resolve();
+    void sampleNode();
+    void sampleRegistry();
+    void report();
+    QString describe(qint64 done, qint64 total) const;
+
+    QString m_title;
+    QString m_image;
+    QString m_destination;
+    Target  m_target;
+
+    QMutex        m_mutex;
+    bool          m_resolved = false;
+    bool          m_unavailable = false;
+    bool          m_finished = false;
+    QList<Layer>  m_layers;
+    QString       m_notificationId;
+    QElapsedTimer m_lastUpdate;
+    QElapsedTimer m_lastGrowth;     // since the byte count last moved
+    bool          m_stallLogged = false;
+    qint64        m_lastBytes = -1;
+    qint64        m_rateBytes = 0;  // at the last rate sample
+    QElapsedTimer m_rateClock;
+    double        m_bytesPerSec = 0;
+};
+
+} // namespace K3s
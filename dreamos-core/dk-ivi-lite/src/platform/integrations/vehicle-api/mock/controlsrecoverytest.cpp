@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+
+//----------------------------------------------------------------------
+// dk_ivi_recovery_test: the controls page comes up while the databroker is
+// down, the databroker recovers, and a value published afterwards has to
+// reach the page's widget signal.
+//
+// Exits 0 on success, 1 on failure or after --timeout seconds.
+//----------------------------------------------------------------------
+#include "mockkuksaclient.hpp"
+#include "../vapiclient.hpp"
+#include "../../../../controls/controls.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Controls page recovery after a failed first connect");
+  parser.addHelpOption();
+  QCommandLineOption timeoutOpt("timeout", "Seconds to wait for the recovered update.", "s", "15");
+  parser.addOption(timeoutOpt);
+  parser.process(app);
+
+  // same path as ControlsAsync
+  const std::string seatPath = qgetenv("DK_VSS_VER") == "VSS_3.0"
+    ? "Vehicle.Cabin.Seat.Row1.Pos1.Position"
+    : "Vehicle.Cabin.Seat.Row1.DriverSide.Position";
+  const int expected = 7;
+
+  MockKuksa::setAvailable(false);
+  ControlsAsync controls;
+  if (controls.isConnected()) {
+    std::fprintf(stderr, "dk_ivi_recovery_test: connected to an unavailable databroker\n");
+    return 1;
+  }
+
+  bool restored = false;
+  int  position = -1;
+  QObject::connect(&controls, &ControlsAsync::connectionStateChanged, &app,
+                   [&restored, &seatPath, expected](bool connected) {
+    if (!connected) return;
+    restored = true;
+    MockKuksa::setValue(seatPath, std::to_string(expected));
+  });
+  QObject::connect(&controls, &ControlsAsync::updateWidget_seat_driverSide_position, &app,
+                   [&position, &app, expected](int p) {
+    position = p;
+    if (p == expected) app.quit();
+  });
+
+  MockKuksa::setAvailable(true);
+  QTimer::singleShot(std::max(1, parser.value(timeoutOpt).toInt()) * 1000, &app, &QCoreApplication::quit);
+  app.exec();
+
+  const bool ok = restored && position == expected;
+  std::printf("connection restored: %s, seat position: %d (expected %d) -> %s\n",
+              restored ? "yes" : "no", position, expected, ok ? "PASS" : "FAIL");
+
+  VAPI_CLIENT.shutdown();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,475 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "mockkuksaclient.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+using Callback = std::function<void(const std::string &, const std::string &, const int &)>;
+
+struct ClientState {
+  std::atomic<bool> connected{false};
+};
+
+//----------------------------------------------------------------------
+// In-memory broker shared by all mock clients of the process. It is never
+// destroyed, so clients released during static destruction can still
+// unregister.
+//----------------------------------------------------------------------
+class Broker {
+public:
+  static Broker& instance() {
+    static Broker *broker = new Broker();
+    return *broker;
+  }
+
+  struct Subscription {
+    const void                   *owner;
+    std::shared_ptr<ClientState>  client;
+    Callback                      callback;
+  };
+  using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+  void publish(const std::string &path, const std::string &value, int field) {
+    if (!available) return;
+
+    MockKuksa::PublishHook hook;
+    {
+      std::lock_guard lock(mMtx_);
+      mValues_[fieldIndex(field)][path] = value;
+      hook = mHook_;
+    }
+    if (hook) hook(path, value, field);
+    enqueue({path, value, field, nullptr});
+    published++;
+  }
+
+  std::string get(const std::string &path, int field) {
+    std::lock_guard lock(mMtx_);
+    auto &values = mValues_[fieldIndex(field)];
+    auto it = values.find(path);
+    return it == values.end() ? std::string() : it->second;
+  }
+
+  void subscribe(const void *owner, std::shared_ptr<ClientState> client,
+                 const std::string &path, int field, Callback callback) {
+    auto sub = std::make_shared<Subscription>(Subscription{owner, std::move(client), std::move(callback)});
+    std::string initial;
+    {
+      std::lock_guard lock(mMtx_);
+      mSubscriptions_[key(path, field)].push_back(sub);
+      auto &values = mValues_[fieldIndex(field)];
+      auto it = values.find(path);
+      if (it == values.end()) return;
+      initial = it->second;
+    }
+    // a new stream starts with the stored value, like the databroker does
+    enqueue({path, initial, field, sub});
+  }
+
+  void unsubscribe(const void *owner) {
+    std::lock_guard lock(mMtx_);
+    for (auto &kv : mSubscriptions_) {
+      auto &subs = kv.second;
+      subs.erase(std::remove_if(subs.begin(), subs.end(),
+                                [owner](const SubscriptionPtr &s) { return s->owner == owner; }),
+                 subs.end());
+    }
+  }
+
+  void startStream(const std::string &path, double hz, MockKuksa::Generator gen, int field) {
+    if (hz <= 0.0 || !gen) return;
+    std::lock_guard lock(mStreamsMtx_);
+    mStreams_.emplace_back([this, path, hz, gen = std::move(gen), field]() {
+      using Clock = std::chrono::steady_clock;
+      const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+      auto next = Clock::now();
+      for (std::uint64_t n = 0; !mStreamsStop_.load(); ++n) {
+        publish(path, gen(n), field);
+        next += period;
+        std::this_thread::sleep_until(next);
+      }
+    });
+  }
+
+  void stopStreams() {
+    std::lock_guard lock(mStreamsMtx_);
+    mStreamsStop_ = true;
+    for (auto &t : mStreams_) {
+      if (t.joinable()) t.join();
+    }
+    mStreams_.clear();
+    mStreamsStop_ = false;
+  }
+
+  void setHook(MockKuksa::PublishHook hook) {
+    std::lock_guard lock(mMtx_);
+    mHook_ = std::move(hook);
+  }
+
+  std::atomic<bool>          available{true};
+  std::atomic<bool>          echoTargets{true};
+  std::atomic<std::uint64_t> published{0};
+  std::atomic<std::uint64_t> delivered{0};
+
+private:
+  struct Update {
+    std::string     path;
+    std::string     value;
+    int             field;
+    SubscriptionPtr only;   // initial value of a single new stream
+  };
+
+  Broker() {
+    mDelivery_ = std::thread(&Broker::deliveryLoop, this);
+    mDelivery_.detach();
+    startEnvStreams();
+  }
+
+  static std::size_t fieldIndex(int field) {
+    return field == KuksaClient::FT_ACTUATOR_TARGET ? 1 : 0;
+  }
+
+  static std::string key(const std::string &path, int field) {
+    return path + (field == KuksaClient::FT_ACTUATOR_TARGET ? "#target" : "#value");
+  }
+
+  void enqueue(Update update) {
+    {
+      std::lock_guard lock(mQueueMtx_);
+      mQueue_.push_back(std::move(update));
+    }
+    mQueueCv_.notify_one();
+  }
+
+  void deliveryLoop() {
+    std::deque<Update> batch;
+    for (;;) {
+      {
+        std::unique_lock lock(mQueueMtx_);
+        mQueueCv_.wait(lock, [this] { return !mQueue_.empty(); });
+        batch.swap(mQueue_);
+      }
+      for (const auto &u : batch) {
+        std::vector<SubscriptionPtr> subs;
+        if (u.only) {
+          subs.push_back(u.only);
+        } else {
+          std::lock_guard lock(mMtx_);
+          auto it = mSubscriptions_.find(key(u.path, u.field));
+          if (it != mSubscriptions_.end()) subs = it->second;
+        }
+        for (const auto &s : subs) {
+          // a disconnected client's streams are down until it reconnects
+          if (!available || !s->client->connected) continue;
+          s->callback(u.path, u.value, u.field);
+          delivered++;
+        }
+      }
+      batch.clear();
+    }
+  }
+
+  void startEnvStreams() {
+    const char *env = std::getenv("DK_MOCK_STREAMS");
+    if (!env) return;
+    std::stringstream list(env);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+      auto eq = item.find('=');
+      if (eq == std::string::npos) continue;
+      const double hz = std::atof(item.c_str() + eq + 1);
+      std::cout << "[MockKuksa] Streaming " << item.substr(0, eq) << " at " << hz << " Hz" << std::endl;
+      startStream(item.substr(0, eq), hz, [](std::uint64_t n) { return std::to_string(n); },
+                  KuksaClient::FT_VALUE);
+    }
+  }
+
+  std::mutex                                                    mMtx_;
+  std::unordered_map<std::string, std::string>                  mValues_[2];
+  std::unordered_map<std::string, std::vector<SubscriptionPtr>> mSubscriptions_;
+  MockKuksa::PublishHook                                        mHook_;
+
+  std::mutex              mQueueMtx_;
+  std::condition_variable mQueueCv_;
+  std::deque<Update>      mQueue_;
+  std::thread             mDelivery_;
+
+  std::mutex               mStreamsMtx_;
+  std::vector<std::thread> mStreams_;
+  std::atomic<bool>        mStreamsStop_{false};
+};
+
+template <typename T>
+std::string toText(const T &value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return value ? "true" : "false";
+  } else if constexpr (std::is_integral_v<T>) {
+    // char types are numbers for the databroker, not characters
+    return std::to_string(static_cast<long long>(value));
+  } else {
+    std::ostringstream out;
+    out.precision(std::numeric_limits<T>::max_digits10);
+    out << value;
+    return out.str();
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+// MockKuksa control API
+//----------------------------------------------------------------------
+namespace MockKuksa {
+  void setValue(const std::string &path, const std::string &value, int field) {
+    Broker::instance().publish(path, value, field);
+  }
+
+  std::string value(const std::string &path, int field) {
+    return Broker::instance().get(path, field);
+  }
+
+  void startStream(const std::string &path, double hz, Generator gen, int field) {
+    Broker::instance().startStream(path, hz, std::move(gen), field);
+  }
+
+  void stopStreams() {
+    Broker::instance().stopStreams();
+  }
+
+  void setPublishHook(PublishHook hook) {
+    Broker::instance().setHook(std::move(hook));
+  }
+
+  void setEchoTargets(bool enabled) {
+    Broker::instance().echoTargets = enabled;
+  }
+
+  void setAvailable(bool available) {
+    Broker::instance().available = available;
+  }
+
+  std::uint64_t published() {
+    return Broker::instance().published;
+  }
+
+  std::uint64_t delivered() {
+    return Broker::instance().delivered;
+  }
+}
+
+//----------------------------------------------------------------------
+// KuksaClient on top of the broker
+//----------------------------------------------------------------------
+namespace KuksaClient {
+
+struct KuksaClient::Impl {
+  std::shared_ptr<ClientState> state = std::make_shared<ClientState>();
+};
+
+KuksaClient::KuksaClient(const Config &config)
+  : pImpl(std::make_unique<Impl>())
+  , serverURI_(config.serverURI)
+  , debug_(config.debug)
+  , config_(config)
+  , signalPaths_(config.signalPaths) {
+}
+
+KuksaClient::KuksaClient(const std::string &configFile)
+  : pImpl(std::make_unique<Impl>()) {
+  parseConfig(configFile, config_);
+  serverURI_   = config_.serverURI;
+  debug_       = config_.debug;
+  signalPaths_ = config_.signalPaths;
+}
+
+KuksaClient::~KuksaClient() {
+  shouldStop_ = true;
+  pImpl->state->connected = false;
+  Broker::instance().unsubscribe(this);
+}
+
+void KuksaClient::connect() {
+  if (!Broker::instance().available) {
+    throw std::runtime_error("mock databroker unavailable");
+  }
+  connected_ = true;
+  pImpl->state->connected = true;
+}
+
+bool KuksaClient::isConnected() const {
+  if (!Broker::instance().available) {
+    connected_ = false;
+    pImpl->state->connected = false;
+  }
+  return connected_;
+}
+
+void KuksaClient::setAutoReconnect(bool enabled) {
+  autoReconnect_ = enabled;
+}
+
+bool KuksaClient::reconnect() {
+  return attemptReconnection();
+}
+
+bool KuksaClient::attemptReconnection() {
+  if (!Broker::instance().available) return false;
+  connected_ = true;
+  pImpl->state->connected = true;
+  return true;
+}
+
+void KuksaClient::handleConnectionFailure() {
+  connected_ = false;
+  pImpl->state->connected = false;
+}
+
+void KuksaClient::restartSubscriptions() {
+  // the broker keeps the streams, they resume once connected again
+}
+
+std::string KuksaClient::getCurrentValue(const std::string &entryPath) {
+  return getValue(entryPath, GV_CURRENT, false);
+}
+
+std::string KuksaClient::getTargetValue(const std::string &entryPath) {
+  return getValue(entryPath, GV_TARGET, true);
+}
+
+std::string KuksaClient::getValue(const std::string &entryPath, GetView, bool target) {
+  if (!isConnected()) return std::string();
+  return Broker::instance().get(entryPath, target ? FT_ACTUATOR_TARGET : FT_VALUE);
+}
+
+void KuksaClient::streamUpdate(const std::string &entryPath, float newValue) {
+  setValueInternalImpl(entryPath, newValue, FT_VALUE);
+}
+
+template <typename T>
+void KuksaClient::setValueInternalImpl(const std::string &entryPath, const T &newValue, int field) {
+  if (!isConnected()) {
+    throw std::runtime_error("not connected to mock databroker");
+  }
+  Broker &broker = Broker::instance();
+  const std::string text = toText(newValue);
+  broker.publish(entryPath, text, field);
+  if (field == FT_ACTUATOR_TARGET && broker.echoTargets) {
+    broker.publish(entryPath, text, FT_VALUE);
+  }
+}
+
+template void KuksaClient::setValueInternalImpl<bool>(const std::string &, const bool &, int);
+template void KuksaClient::setValueInternalImpl<signed char>(const std::string &, const signed char &, int);
+template void KuksaClient::setValueInternalImpl<unsigned char>(const std::string &, const unsigned char &, int);
+template void KuksaClient::setValueInternalImpl<short>(const std::string &, const short &, int);
+template void KuksaClient::setValueInternalImpl<unsigned short>(const std::string &, const unsigned short &, int);
+template void KuksaClient::setValueInternalImpl<int>(const std::string &, const int &, int);
+template void KuksaClient::setValueInternalImpl<unsigned int>(const std::string &, const unsigned int &, int);
+template void KuksaClient::setValueInternalImpl<long>(const std::string &, const long &, int);
+template void KuksaClient::setValueInternalImpl<unsigned long>(const std::string &, const unsigned long &, int);
+template void KuksaClient::setValueInternalImpl<float>(const std::string &, const float &, int);
+template void KuksaClient::setValueInternalImpl<double>(const std::string &, const double &, int);
+
+void KuksaClient::subscribeTargetValue(const std::string &entryPath,
+                                       std::function<void(const std::string &, const std::string &, const int &)> userCallback) {
+  subscribe(entryPath, std::move(userCallback), FT_ACTUATOR_TARGET);
+}
+
+void KuksaClient::subscribeCurrentValue(const std::string &entryPath,
+                                        std::function<void(const std::string &, const std::string &, const int &)> userCallback) {
+  subscribe(entryPath, std::move(userCallback), FT_VALUE);
+}
+
+void KuksaClient::subscribe(const std::string &entryPath,
+                            std::function<void(const std::string &, const std::string &, const int &)> userCallback,
+                            int field) {
+  // the gRPC stream cannot be set up without a channel
+  if (!isConnected()) {
+    throw std::runtime_error("not connected to mock databroker");
+  }
+  Broker::instance().subscribe(this, pImpl->state, entryPath, field, std::move(userCallback));
+}
+
+void KuksaClient::subscribeWithReconnect(const std::string &entryPath,
+                                         std::function<void(const std::string &, const std::string &, const int &)> userCallback,
+                                         int field) {
+  subscribe(entryPath, std::move(userCallback), field);
+}
+
+void KuksaClient::subscribeAll(std::function<void(const std::string &, const std::string &, const int &)> userCallback) {
+  for (const auto &path : signalPaths_) {
+    subscribe(path, userCallback, FT_VALUE);
+  }
+}
+
+void KuksaClient::joinAllSubscriptions() {}
+void KuksaClient::joinAllSubscriptionsWithTimeout() {}
+void KuksaClient::detachAllSubscriptions() {}
+
+void KuksaClient::getServerInfo() {
+  if (debug_) {
+    std::cout << "[MockKuksa] In-process databroker stand-in for " << serverURI_ << std::endl;
+  }
+}
+
+bool KuksaClient::parseConfig(const std::string &filename, Config &config) {
+  // "key=value" lines: serverURI, debug, signalPath (repeatable)
+  std::ifstream in(filename);
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    auto eq = line.find('=');
+    if (eq == std::string::npos) continue;
+    const std::string key = line.substr(0, eq);
+    const std::string val = line.substr(eq + 1);
+    if (key == "serverURI")       config.serverURI = val;
+    else if (key == "debug")      config.debug = (val == "true" || val == "1");
+    else if (key == "signalPath") config.signalPaths.push_back(val);
+  }
+  return true;
+}
+
+bool KuksaClient::convertString(const std::string &str, bool &out) {
+  if (str == "true" || str == "1")  { out = true;  return true; }
+  if (str == "false" || str == "0") { out = false; return true; }
+  return false;
+}
+
+namespace {
+  template <typename T>
+  bool convertUnsigned(const std::string &str, T &out) {
+    try {
+      std::size_t used = 0;
+      const unsigned long v = std::stoul(str, &used);
+      if (used != str.size() || v > std::numeric_limits<T>::max()) return false;
+      out = static_cast<T>(v);
+      return true;
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
+}
+
+bool KuksaClient::convertString(const std::string &str, uint8_t &out) {
+  return convertUnsigned(str, out);
+}
+
+bool KuksaClient::convertString(const std::string &str, uint16_t &out) {
+  return convertUnsigned(str, out);
+}
+
+bool KuksaClient::convertString(const std::string &str, uint32_t &out) {
+  return convertUnsigned(str, out);
+}
+
+} // namespace KuksaClient
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef MOCK_KUKSA_CLIENT_HPP
+#define MOCK_KUKSA_CLIENT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "../KuksaClient.hpp"
+
+//----------------------------------------------------------------------
+// In-process databroker stand-in.
+//
+// mockkuksaclient.cpp implements the KuksaClient interface on top of an
+// in-memory broker and is linked instead of libKuksaClient.so when the
+// project is configured with -DDK_IVI_MOCK_VEHICLE=ON. Every client in the
+// process talks to the same broker:
+//
+//  - get returns the last value set for a path ("" if none)
+//  - set stores the value and publishes it to the subscribers of the path;
+//    a target write is also applied as current value, like the feeder of a
+//    real actuator would
+//  - subscribe delivers the stored value first, then every change, on the
+//    broker's delivery thread as the gRPC stream threads of KuksaClient do;
+//    it throws while the client is not connected
+//
+// Synthetic update streams generate values for a path at a fixed rate.
+// The environment variable DK_MOCK_STREAMS="<path>=<hz>[,...]" starts
+// counter streams (values 0, 1, 2, ...) when the broker is first used.
+//----------------------------------------------------------------------
+namespace MockKuksa {
+  using Generator   = std::function<std::string(std::uint64_t n)>;
+  // Called on the publishing thread right before an update is queued.
+  using PublishHook = std::function<void(const std::string &path,
+                                         const std::string &value,
+                                         int                field)>;
+
+  // Store and publish a value as if a provider had set it.
+  void setValue(const std::string &path, const std::string &value,
+                int field = KuksaClient::FT_VALUE);
+  std::string value(const std::string &path, int field = KuksaClient::FT_VALUE);
+
+  // Publish gen(0), gen(1), ... to path at the given rate until stopped.
+  void startStream(const std::string &path, double hz, Generator gen,
+                   int field = KuksaClient::FT_VALUE);
+  void stopStreams();
+
+  void setPublishHook(PublishHook hook);
+
+  // Mirror target writes to the current value (default: on).
+  void setEchoTargets(bool enabled);
+
+  // Simulate a databroker outage: clients disconnect, updates are dropped
+  // and reconnect() fails until the broker is available again.
+  void setAvailable(bool available);
+
+  // Updates published and updates delivered to callbacks so far.
+  std::uint64_t published();
+  std::uint64_t delivered();
+}
+
+#endif // MOCK_KUKSA_CLIENT_HPP
@@ -0,0 +1,145 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+
+//----------------------------------------------------------------------
+// dk_ivi_bench: end-to-end latency of the signal path
+//
+//   mock databroker -> VAPIClient stream -> SignalDispatcher -> GUI thread
+//   -> ControlsAsync::updateWidget_seat_driverSide_position
+//
+// The seat position is published at --rate Hz with increasing values, the
+// other controls carry the same rate as background load. The publish time
+// of every value is kept in a ring; the widget signal looks it up by value.
+// Prints latency percentiles, how many updates reached the widget (the
+// dispatcher coalesces per GUI frame) and the CPU time of the GUI thread.
+//
+//   dk_ivi_bench [--rate <hz>] [--seconds <s>]
+//----------------------------------------------------------------------
+#include "mockkuksaclient.hpp"
+#include "../vapiclient.hpp"
+#include "../../../../controls/controls.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  constexpr std::size_t RING = 1 << 16;
+  std::array<std::atomic<std::int64_t>, RING> gPublishedAt;
+
+  std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now().time_since_epoch()).count();
+  }
+
+  double threadCpuMs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+  }
+
+  bool isSeatPosition(const std::string &path) {
+    // the path differs between VSS versions (DK_VSS_VER)
+    return path.find(".Seat.Row1.") != std::string::npos
+        && path.size() >= 9 && path.compare(path.size() - 9, 9, ".Position") == 0;
+  }
+
+  double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const std::size_t idx = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+  }
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Signal path latency benchmark on the mock databroker");
+  parser.addHelpOption();
+  QCommandLineOption rateOpt("rate", "Updates per second and signal.", "hz", "200");
+  QCommandLineOption secondsOpt("seconds", "Duration of the measurement.", "s", "10");
+  parser.addOption(rateOpt);
+  parser.addOption(secondsOpt);
+  parser.process(app);
+
+  const double rate    = std::max(1.0, parser.value(rateOpt).toDouble());
+  const double seconds = std::max(1.0, parser.value(secondsOpt).toDouble());
+
+  MockKuksa::setPublishHook([](const std::string &path, const std::string &value, int field) {
+    if (field != KuksaClient::FT_VALUE || !isSeatPosition(path)) return;
+    const std::uint64_t n = std::strtoull(value.c_str(), nullptr, 10);
+    gPublishedAt[n % RING].store(nowNs(), std::memory_order_relaxed);
+  });
+
+  ControlsAsync controls;
+  if (!controls.isConnected()) {
+    std::fprintf(stderr, "dk_ivi_bench: not connected to the mock databroker\n");
+    return 1;
+  }
+
+  std::vector<double> latencies;
+  latencies.reserve(static_cast<std::size_t>(rate * seconds));
+  QObject::connect(&controls, &ControlsAsync::updateWidget_seat_driverSide_position,
+                   &app, [&latencies](int position) {
+    const std::int64_t at = gPublishedAt[static_cast<std::uint64_t>(position) % RING]
+                              .load(std::memory_order_relaxed);
+    if (at > 0) latencies.push_back((nowNs() - at) / 1e6);
+  });
+
+  // start at 1 so the first update differs from a stored 0
+  const auto counter = [](std::uint64_t n) { return std::to_string(n + 1); };
+  const auto toggle  = [](std::uint64_t n) { return std::string(n % 2 ? "true" : "false"); };
+  const auto fan     = [](std::uint64_t n) { return std::to_string(n % 101); };
+
+  // same paths as ControlsAsync
+  const bool vss3 = qgetenv("DK_VSS_VER") == "VSS_3.0";
+  MockKuksa::startStream(vss3 ? "Vehicle.Cabin.Seat.Row1.Pos1.Position"
+                              : "Vehicle.Cabin.Seat.Row1.DriverSide.Position", rate, counter);
+  MockKuksa::startStream(vss3 ? "Vehicle.Body.Lights.IsLowBeamOn"
+                              : "Vehicle.Body.Lights.Beam.Low.IsOn", rate, toggle);
+  MockKuksa::startStream(vss3 ? "Vehicle.Body.Lights.IsHighBeamOn"
+                              : "Vehicle.Body.Lights.Beam.High.IsOn", rate, toggle);
+  MockKuksa::startStream(vss3 ? "Vehicle.Body.Lights.IsHazardOn"
+                              : "Vehicle.Body.Lights.Hazard.IsSignaling", rate, toggle);
+  MockKuksa::startStream(vss3 ? "Vehicle.Cabin.HVAC.Station.Row1.Left.FanSpeed"
+                              : "Vehicle.Cabin.HVAC.Station.Row1.Driver.FanSpeed", rate, fan);
+  MockKuksa::startStream(vss3 ? "Vehicle.Cabin.HVAC.Station.Row1.Right.FanSpeed"
+                              : "Vehicle.Cabin.HVAC.Station.Row1.Passenger.FanSpeed", rate, fan);
+
+  const double cpuStart = threadCpuMs();
+  const auto   start    = Clock::now();
+  QTimer::singleShot(static_cast<int>(seconds * 1000), &app, &QCoreApplication::quit);
+  app.exec();
+  const double cpuMs  = threadCpuMs() - cpuStart;
+  const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  MockKuksa::stopStreams();
+  MockKuksa::setPublishHook(nullptr);
+
+  std::sort(latencies.begin(), latencies.end());
+  const std::uint64_t published = static_cast<std::uint64_t>(rate * seconds);
+  std::printf("rate %.0f Hz x 6 signals, %.1f s\n", rate, seconds);
+  std::printf("seat updates  : %zu of ~%llu published reached the widget\n",
+              latencies.size(), static_cast<unsigned long long>(published));
+  std::printf("latency (ms)  : p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+              percentile(latencies, 0.50), percentile(latencies, 0.90),
+              percentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back());
+  std::printf("broker        : %llu published, %llu delivered to streams\n",
+              static_cast<unsigned long long>(MockKuksa::published()),
+              static_cast<unsigned long long>(MockKuksa::delivered()));
+  std::printf("GUI thread CPU: %.1f ms (%.1f %%)\n", cpuMs, 100.0 * cpuMs / wallMs);
+
+  VAPI_CLIENT.shutdown();
+  return 0;
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "signalcache.hpp"
+#include "KuksaClient.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace {
+  constexpr std::uint8_t KIND_STRING = 6; // variant index of std::string
+}
+
+struct SignalCache::Slot {
+  // seqlock: odd while a writer is updating kind/bits/stamp
+  std::atomic<std::uint32_t> seq{0};
+  std::atomic<std::uint8_t>  kind{0};   // variant index, 0: no value
+  std::atomic<std::uint64_t> bits{0};   // bool/int/float payload
+  std::atomic<Clock::rep>    stamp{0};
+
+  // serializes writers; also guards the text of string values
+  std::mutex  mtx;
+  std::string text;
+};
+
+SignalCache::SignalCache()
+    : mCurrent_(std::make_unique<const Index>()) {
+  mIndex_.store(mCurrent_.get(), std::memory_order_release);
+}
+
+SignalCache::~SignalCache() = default;
+
+// The reader counts itself in before it loads the snapshot (both seq_cst):
+// a writer that swapped the index and then sees no reader knows that every
+// later reader loads the new one, so the retired snapshots can go.
+SignalCache::ReadGuard::ReadGuard(const SignalCache &cache)
+    : mCache(cache) {
+  mCache.mReaders_.fetch_add(1);
+  mIndex = mCache.mIndex_.load();
+}
+
+SignalCache::ReadGuard::~ReadGuard() {
+  mCache.mReaders_.fetch_sub(1);
+}
+
+std::size_t SignalCache::fieldIndex(int field) {
+  return field == KuksaClient::FT_ACTUATOR_TARGET ? 1 : 0;
+}
+
+SignalCache::Slot* SignalCache::track(const std::string &serverURI,
+                                      SignalHandle signal, int field) {
+  if (signal == INVALID_SIGNAL) return nullptr;
+
+  std::lock_guard lock(mWriteMtx_);
+  if (Slot *slot = find(serverURI, signal, field)) return slot;
+
+  mSlots_.push_back(std::make_unique<Slot>());
+  Slot *slot = mSlots_.back().get();
+
+  // copy-on-write: readers keep using the previous snapshot
+  auto next = std::make_unique<Index>(*mCurrent_);
+  auto &bySignal = (*next)[serverURI];
+  if (bySignal.size() <= signal) bySignal.resize(signal + 1, {nullptr, nullptr});
+  bySignal[signal][fieldIndex(field)] = slot;
+
+  mIndex_.store(next.get());
+  mRetired_.push_back(std::move(mCurrent_));
+  mCurrent_ = std::move(next);
+  if (mReaders_.load() == 0) {
+    mRetired_.clear();
+  }
+  return slot;
+}
+
+SignalCache::Slot* SignalCache::find(const std::string &serverURI,
+                                     SignalHandle signal, int field) const {
+  ReadGuard guard(*this);
+  const Index &index = guard.index();
+  auto server = index.find(serverURI);
+  if (server == index.end() || signal >= server->second.size()) return nullptr;
+  return server->second[signal][fieldIndex(field)];
+}
+
+SignalValue SignalCache::parse(std::string_view text) {
+  if (text.empty())    return std::monostate{};
+  if (text == "true")  return true;
+  if (text == "false") return false;
+
+  const char *first = text.data();
+  const char *last  = text.data() + text.size();
+
+  if (text.front() == '-') {
+    std::int64_t i = 0;
+    auto r = std::from_chars(first, last, i);
+    if (r.ec == std::errc() && r.ptr == last) return i;
+  } else {
+    std::uint64_t u = 0;
+    auto r = std::from_chars(first, last, u);
+    if (r.ec == std::errc() && r.ptr == last) {
+      if (u <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+        return static_cast<std::int64_t>(u);
+      }
+      return u;
+    }
+  }
+
+  double d = 0.0;
+  auto r = std::from_chars(first, last, d);
+  if (r.ec == std::errc() && r.ptr == last) return d;
+
+  return std::string(text);
+}
+
+std::string SignalCache::format(const SignalValue &value) {
+  return std::visit([](const auto &v) -> std::string {
+    using V = std::decay_t<decltype(v)>;
+    if constexpr (std::is_same_v<V, std::monostate>) {
+      return std::string();
+    } else if constexpr (std::is_same_v<V, std::string>) {
+      return v;
+    } else if constexpr (std::is_same_v<V, bool>) {
+      return v ? "true" : "false";
+    } else {
+      // shortest text that parses back to the same value
+      char buf[32];
+      auto r = std::to_chars(buf, buf + sizeof(buf), v);
+      return std::string(buf, r.ptr);
+    }
+  }, value);
+}
+
+void SignalCache::store(Slot *slot, const std::string &value) {
+  if (!slot) return;
+  storeValue(slot, parse(value));
+}
+
+void SignalCache::storeValue(Slot *slot, const SignalValue &value) {
+  std::uint64_t bits = 0;
+  std::visit([&bits](const auto &v) {
+    using V = std::decay_t<decltype(v)>;
+    if constexpr (std::is_arithmetic_v<V>) {
+      std::memcpy(&bits, &v, sizeof(V));
+    }
+  }, value);
+
+  std::lock_guard lock(slot->mtx);
+  if (auto *s = std::get_if<std::string>(&value)) {
+    slot->text = *s;
+  }
+
+  const std::uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+  slot->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->kind.store(static_cast<std::uint8_t>(value.index()), std::memory_order_relaxed);
+  slot->bits.store(bits, std::memory_order_relaxed);
+  slot->stamp.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+  slot->seq.store(seq + 2, std::memory_order_release);
+}
+
+void SignalCache::invalidate(const std::string &serverURI,
+                             SignalHandle signal, int field) {
+  if (Slot *slot = find(serverURI, signal, field)) {
+    storeValue(slot, std::monostate{});
+  }
+}
+
+void SignalCache::invalidate(const std::string &serverURI,
+                             const std::string &path, int field) {
+  invalidate(serverURI, SIGNAL_REGISTRY.find(path), field);
+}
+
+void SignalCache::invalidateAll(const std::string &serverURI) {
+  ReadGuard guard(*this);
+  const Index &index = guard.index();
+  auto server = index.find(serverURI);
+  if (server == index.end()) return;
+  for (const auto &slots : server->second) {
+    for (Slot *slot : slots) {
+      if (slot) storeValue(slot, std::monostate{});
+    }
+  }
+}
+
+void SignalCache::invalidateAll() {
+  ReadGuard guard(*this);
+  for (const auto &server : guard.index()) {
+    invalidateAll(server.first);
+  }
+}
+
+bool SignalCache::get(const std::string &serverURI, SignalHandle signal,
+                      int field, SignalValue &out, Clock::duration maxAge) const {
+  Slot *slot = find(serverURI, signal, field);
+  if (!slot) return false;
+
+  std::uint8_t  kind  = 0;
+  std::uint64_t bits  = 0;
+  Clock::rep    stamp = 0;
+  for (;;) {
+    const std::uint32_t before = slot->seq.load(std::memory_order_acquire);
+    if (before & 1) continue;
+    kind  = slot->kind.load(std::memory_order_relaxed);
+    bits  = slot->bits.load(std::memory_order_relaxed);
+    stamp = slot->stamp.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) == before) break;
+  }
+
+  if (kind == 0) return false;
+  if (maxAge != Clock::duration::zero() &&
+      Clock::now() - Clock::time_point(Clock::duration(stamp)) > maxAge) {
+    return false;
+  }
+
+  switch (kind) {
+    case 1: { bool          v; std::memcpy(&v, &bits, sizeof(v)); out = v; return true; }
+    case 2: { std::int64_t  v; std::memcpy(&v, &bits, sizeof(v)); out = v; return true; }
+    case 3: { std::uint64_t v; std::memcpy(&v, &bits, sizeof(v)); out = v; return true; }
+    case 4: { float         v; std::memcpy(&v, &bits, sizeof(v)); out = v; return true; }
+    case 5: { double        v; std::memcpy(&v, &bits, sizeof(v)); out = v; return true; }
+    case KIND_STRING: {
+      std::lock_guard lock(slot->mtx);
+      if (slot->kind.load(std::memory_order_relaxed) != KIND_STRING) return false;
+      out = slot->text;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
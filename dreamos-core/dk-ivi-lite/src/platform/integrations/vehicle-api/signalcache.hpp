@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef SIGNAL_CACHE_HPP
+#define SIGNAL_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+#include "signalregistry.hpp"
+
+//----------------------------------------------------------------------
+// Typed value of a VSS signal. std::monostate means "no value".
+//----------------------------------------------------------------------
+using SignalValue = std::variant<std::monostate, bool, std::int64_t,
+                                 std::uint64_t, float, double, std::string>;
+
+//----------------------------------------------------------------------
+// SignalCache: typed shadow of the values delivered by the subscription
+// streams, one slot per (server, signal handle, field).
+//
+// Only the stream of a slot writes it; readers never take a lock: the
+// signal index is an immutable snapshot replaced when a slot is added, and
+// each slot is a seqlock over plain atomics. Only string values are kept
+// behind a per-slot mutex. Replaced snapshots are freed as soon as no
+// reader is inside the index.
+//----------------------------------------------------------------------
+class SignalCache {
+public:
+  using Clock = std::chrono::steady_clock;
+  struct Slot;
+
+  SignalCache();
+  ~SignalCache();
+
+  SignalCache(const SignalCache&)            = delete;
+  SignalCache& operator=(const SignalCache&) = delete;
+
+  // Create (or find) the slot of a stream. The slot stays valid until the
+  // cache is destroyed, so the stream can keep the pointer.
+  Slot* track(const std::string &serverURI, SignalHandle signal, int field);
+
+  // Parse a value as delivered by KuksaClient and store it in the slot.
+  static void store(Slot *slot, const std::string &value);
+
+  // Drop cached values, e.g. after a write or when the connection is lost.
+  // The next stream update makes the slot valid again.
+  void invalidate(const std::string &serverURI, SignalHandle signal, int field);
+  void invalidate(const std::string &serverURI, const std::string &path, int field);
+  void invalidateAll(const std::string &serverURI);
+  void invalidateAll();
+
+  // Lock-free read of a valid slot. maxAge == 0 accepts any age.
+  bool get(const std::string &serverURI, SignalHandle signal, int field,
+           SignalValue &out, Clock::duration maxAge = Clock::duration::zero()) const;
+  bool get(const std::string &serverURI, const std::string &path, int field,
+           SignalValue &out, Clock::duration maxAge = Clock::duration::zero()) const {
+    return get(serverURI, SIGNAL_REGISTRY.find(path), field, out, maxAge);
+  }
+
+  template<typename Key, typename T>
+  bool getAs(const std::string &serverURI, const Key &signal, int field,
+             T &out, Clock::duration maxAge = Clock::duration::zero()) const {
+    SignalValue value;
+    return get(serverURI, signal, field, value, maxAge) && convert(value, out);
+  }
+
+  // "true"/"false" -> bool, integers -> int64/uint64, decimals -> double,
+  // anything else -> string, empty -> monostate.
+  static SignalValue parse(std::string_view text);
+
+  // Inverse of parse(): the text KuksaClient would deliver for the value.
+  static std::string format(const SignalValue &value);
+
+  // Typed value of a C++ value as written through KuksaClient.
+  template<typename T>
+  static SignalValue from(const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      return value;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+      return static_cast<std::int64_t>(value);
+    } else if constexpr (std::is_integral_v<T>) {
+      return static_cast<std::uint64_t>(value);
+    } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+      return value;
+    } else if constexpr (std::is_convertible_v<T, std::string>) {
+      return std::string(value);
+    } else {
+      return std::monostate{};
+    }
+  }
+
+  template<typename T>
+  static bool convert(const SignalValue &value, T &out) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (auto *s = std::get_if<std::string>(&value)) { out = *s; return true; }
+      return false;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      if (auto *b = std::get_if<bool>(&value))          { out = *b;      return true; }
+      if (auto *i = std::get_if<std::int64_t>(&value))  { out = *i != 0; return true; }
+      if (auto *u = std::get_if<std::uint64_t>(&value)) { out = *u != 0; return true; }
+      return false;
+    } else if constexpr (std::is_integral_v<T>) {
+      if (auto *b = std::get_if<bool>(&value)) { out = *b ? 1 : 0; return true; }
+      if (auto *i = std::get_if<std::int64_t>(&value)) {
+        if (*i < static_cast<std::int64_t>(std::numeric_limits<T>::min())) return false;
+        if (*i > 0 && static_cast<std::uint64_t>(*i) > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) return false;
+        out = static_cast<T>(*i);
+        return true;
+      }
+      if (auto *u = std::get_if<std::uint64_t>(&value)) {
+        if (*u > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) return false;
+        out = static_cast<T>(*u);
+        return true;
+      }
+      return false;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      if (auto *i = std::get_if<std::int64_t>(&value))  { out = static_cast<T>(*i); return true; }
+      if (auto *u = std::get_if<std::uint64_t>(&value)) { out = static_cast<T>(*u); return true; }
+      if (auto *f = std::get_if<float>(&value))         { out = static_cast<T>(*f); return true; }
+      if (auto *d = std::get_if<double>(&value))        { out = static_cast<T>(*d); return true; }
+      return false;
+    } else {
+      return false;
+    }
+  }
+
+private:
+  // server -> signal handle -> slot per field (index 0: FT_VALUE, 1: FT_ACTUATOR_TARGET)
+  using SignalIndex = std::vector<std::array<Slot*, 2>>;
+  using Index       = std::unordered_map<std::string, SignalIndex>;
+
+  // counts a reader in for as long as it uses the index snapshot
+  class ReadGuard {
+  public:
+    explicit ReadGuard(const SignalCache &cache);
+    ~ReadGuard();
+    const Index &index() const { return *mIndex; }
+  private:
+    const SignalCache &mCache;
+    const Index       *mIndex;
+  };
+
+  static std::size_t fieldIndex(int field);
+  static void storeValue(Slot *slot, const SignalValue &value);
+  Slot* find(const std::string &serverURI, SignalHandle signal, int field) const;
+
+  std::atomic<const Index*>                 mIndex_;
+  mutable std::atomic<int>                  mReaders_{0};
+  std::unique_ptr<const Index>              mCurrent_;
+  // replaced snapshots, freed by track() once no reader is counted in
+  std::vector<std::unique_ptr<const Index>> mRetired_;
+  // slots live until destruction: streams keep their pointers
+  std::vector<std::unique_ptr<Slot>>        mSlots_;
+  std::mutex                                mWriteMtx_;
+};
+
+#endif // SIGNAL_CACHE_HPP
@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "signaldispatcher.hpp"
+#include <QTimer>
+#include <QMetaObject>
+#include <QPointer>
+
+SignalDispatcher::SignalDispatcher(const std::string               &serverURI,
+                                   const std::vector<SignalHandle> &handles,
+                                   QObject                         *parent)
+  : QObject(parent)
+  , m_serverURI(serverURI)
+  , m_handles(handles)
+  , m_state(std::make_shared<State>())
+  , m_frameInterval(DEFAULT_FRAME_INTERVAL) {
+  State &state = *m_state;
+  state.entries.reset(new Entry[handles.size()]);
+  state.count = handles.size();
+  state.owner = this;
+  for (std::size_t i = 0; i < state.count; ++i) {
+    const SignalHandle h = handles[i];
+    state.entries[i].signal = h;
+    if (h == INVALID_SIGNAL) continue;
+    if (state.entryOf.size() <= h) state.entryOf.resize(h + 1, -1);
+    state.entryOf[h] = static_cast<int>(i);
+  }
+}
+
+SignalDispatcher::~SignalDispatcher() {
+  // waits for a stream thread that is posting a drain right now
+  std::lock_guard lock(m_state->ownerMtx);
+  m_state->owner = nullptr;
+}
+
+SignalCallback SignalDispatcher::callback() {
+  return [state = m_state](SignalHandle signal, const std::string &, int field) {
+    markDirty(*state, signal, field);
+  };
+}
+
+void SignalDispatcher::setFrameInterval(int milliseconds) {
+  m_frameInterval = milliseconds < 0 ? 0 : milliseconds;
+}
+
+int SignalDispatcher::frameInterval() const {
+  return m_frameInterval;
+}
+
+void SignalDispatcher::markDirty(State &state, SignalHandle signal, int field) {
+  if (signal >= state.entryOf.size() || state.entryOf[signal] < 0) return;
+
+  std::size_t idx = field == KuksaClient::FT_ACTUATOR_TARGET ? 1 : 0;
+  if (!state.entries[state.entryOf[signal]].dirty[idx].exchange(true, std::memory_order_acq_rel)) {
+    scheduleDrain(state);
+  }
+}
+
+void SignalDispatcher::scheduleDrain(State &state) {
+  if (state.drainPending.exchange(true, std::memory_order_acq_rel)) return;
+
+  // one queued call per frame at most, however many updates arrive; a
+  // posted call dies with its receiver, so only posting needs the lock
+  std::lock_guard lock(state.ownerMtx);
+  SignalDispatcher *owner = state.owner;
+  if (!owner) return;
+  QMetaObject::invokeMethod(owner, [owner]() {
+    QTimer::singleShot(owner->m_frameInterval, owner, &SignalDispatcher::drain);
+  }, Qt::QueuedConnection);
+}
+
+void SignalDispatcher::drain() {
+  // cleared first: an update racing with this drain schedules the next one
+  m_state->drainPending.store(false, std::memory_order_release);
+
+  SignalValue value;
+  for (std::size_t i = 0; i < m_state->count; ++i) {
+    Entry &entry = m_state->entries[i];
+    for (int idx = 0; idx < 2; ++idx) {
+      if (!entry.dirty[idx].exchange(false, std::memory_order_acq_rel)) continue;
+
+      int field = idx ? KuksaClient::FT_ACTUATOR_TARGET : KuksaClient::FT_VALUE;
+      // an invalidated slot (pending write) is refilled and marked dirty
+      // again by the stream once the databroker confirms the value
+      if (VAPI_CLIENT.getCachedValue(m_serverURI, entry.signal, field, value)) {
+        emit valueChanged(entry.signal, field, value);
+      }
+    }
+  }
+}
+
+void SignalDispatcher::requestSnapshot() {
+  QPointer<SignalDispatcher> self(this);
+  VAPI_CLIENT.snapshotAsync(m_serverURI, m_handles, [self](const VAPIClient::Snapshot &snapshot) {
+    // called on the fetching thread
+    QMetaObject::invokeMethod(self, [self, snapshot]() {
+      if (self) self->deliverSnapshot(snapshot);
+    }, Qt::QueuedConnection);
+  });
+}
+
+void SignalDispatcher::deliverSnapshot(const VAPIClient::Snapshot &snapshot) {
+  for (const auto &entry : snapshot) {
+    if (!std::holds_alternative<std::monostate>(entry.current)) {
+      emit valueChanged(entry.signal, KuksaClient::FT_VALUE, entry.current);
+    }
+    if (!std::holds_alternative<std::monostate>(entry.target)) {
+      emit valueChanged(entry.signal, KuksaClient::FT_ACTUATOR_TARGET, entry.target);
+    }
+  }
+}
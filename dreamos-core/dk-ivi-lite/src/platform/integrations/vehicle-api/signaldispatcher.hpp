@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef SIGNAL_DISPATCHER_HPP
+#define SIGNAL_DISPATCHER_HPP
+
+#include <QObject>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "vapiclient.hpp"
+
+//----------------------------------------------------------------------
+// SignalDispatcher: coalescing bridge from the subscription threads to
+// the Qt GUI thread.
+//
+// A stream update only marks its signal dirty (one atomic exchange) and
+// schedules a drain if none is pending. The GUI thread drains at most once
+// per frame and reads the latest value of every dirty signal from the
+// VAPIClient shadow cache, so a burst becomes one valueChanged() per
+// changed signal and superseded values are dropped.
+//
+// The callback shares the dirty flags with the dispatcher instead of
+// pointing at it: a stream thread may still be inside it after
+// VAPIClient::unsubscribe() has returned and the dispatcher is gone.
+//----------------------------------------------------------------------
+class SignalDispatcher : public QObject {
+  Q_OBJECT
+public:
+  // The signal set is fixed for the dispatcher's lifetime, so the stream
+  // threads can look it up without locking.
+  SignalDispatcher(const std::string               &serverURI,
+                   const std::vector<SignalHandle> &handles,
+                   QObject                         *parent = nullptr);
+  ~SignalDispatcher() override;
+
+  // Callback to pass to VAPIClient::subscribe(), safe to call from any thread.
+  SignalCallback callback();
+
+  void setFrameInterval(int milliseconds);
+  int frameInterval() const;
+
+public slots:
+  // Deliver all pending updates now.
+  void drain();
+
+  // Fetch the initial state of all signals off the GUI thread and deliver
+  // it through valueChanged() (current, then target value) on completion.
+  void requestSnapshot();
+
+signals:
+  void valueChanged(SignalHandle signal, int field, const SignalValue &value);
+
+private:
+  struct Entry {
+    SignalHandle      signal = INVALID_SIGNAL;
+    // index 0: FT_VALUE, index 1: FT_ACTUATOR_TARGET
+    std::atomic<bool> dirty[2] = {false, false};
+  };
+
+  // what the stream threads touch; outlives the dispatcher if they do
+  struct State {
+    std::unique_ptr<Entry[]> entries;
+    std::size_t              count = 0;
+    // signal handle -> entry, -1 for signals of no interest
+    std::vector<int>         entryOf;
+    std::atomic<bool>        drainPending{false};
+    // cleared by the destructor; held while a drain is being posted
+    std::mutex               ownerMtx;
+    SignalDispatcher        *owner = nullptr;
+  };
+
+  static void markDirty(State &state, SignalHandle signal, int field);
+  static void scheduleDrain(State &state);
+  void deliverSnapshot(const VAPIClient::Snapshot &snapshot);
+
+  std::string               m_serverURI;
+  std::vector<SignalHandle> m_handles;
+  std::shared_ptr<State>    m_state;
+  int                       m_frameInterval;
+
+  static constexpr int DEFAULT_FRAME_INTERVAL = 16; // ~60 fps
+};
+
+#endif // SIGNAL_DISPATCHER_HPP
@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "signalpublisher.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <unordered_set>
+
+SignalPublisher::SignalPublisher(std::string serverURI, Options options, Sink sink)
+  : mServerURI_(std::move(serverURI))
+  , mState_(std::make_shared<State>()) {
+  mState_->options = options;
+  mState_->options.capacity = std::max<std::size_t>(options.capacity, 1);
+  mState_->options.maxBatch = std::max<std::size_t>(options.maxBatch, 1);
+  mState_->sink      = std::move(sink);
+  mState_->rateStart = Clock::now();
+}
+
+SignalPublisher::~SignalPublisher() {
+  close();
+}
+
+bool SignalPublisher::enqueue(Update update) {
+  State &st = *mState_;
+  std::unique_lock lock(st.mtx);
+  if (st.closed) return false;
+
+  if (st.queue.size() >= st.options.capacity) {
+    switch (st.options.overflow) {
+      case Overflow::DropOldest:
+        st.queue.pop_front();
+        st.stats.dropped++;
+        break;
+      case Overflow::DropNewest:
+        st.stats.dropped++;
+        return false;
+      case Overflow::Block:
+        if (!st.spaceCv.wait_for(lock, st.options.blockTimeout, [&st] {
+              return st.closed || st.queue.size() < st.options.capacity;
+            })) {
+          st.stats.dropped++;
+          return false;
+        }
+        if (st.closed) return false;
+        break;
+    }
+  }
+
+  st.queue.push_back(std::move(update));
+  st.stats.published++;
+  st.stats.maxQueued = std::max(st.stats.maxQueued, st.queue.size());
+  submit(mState_, lock);
+  return true;
+}
+
+void SignalPublisher::submit(const StatePtr &state, std::unique_lock<std::mutex> &lock) {
+  State &st = *state;
+  if (st.closed || st.inFlight || st.queue.empty()) {
+    lock.unlock();
+    return;
+  }
+
+  const std::size_t n = std::min(st.options.maxBatch, st.queue.size());
+  std::vector<Update> taken(std::make_move_iterator(st.queue.begin()),
+                            std::make_move_iterator(st.queue.begin() + n));
+  st.queue.erase(st.queue.begin(), st.queue.begin() + n);
+
+  // only the newest value of a (signal, field) in the batch is sent
+  std::vector<Update> batch;
+  std::unordered_set<std::uint64_t> seen;
+  for (std::size_t i = taken.size(); i-- > 0;) {
+    const std::uint64_t key = (static_cast<std::uint64_t>(taken[i].signal) << 1)
+                            | (taken[i].field == KuksaClient::FT_ACTUATOR_TARGET ? 1u : 0u);
+    if (seen.insert(key).second) batch.push_back(std::move(taken[i]));
+  }
+  std::reverse(batch.begin(), batch.end());
+  st.stats.coalesced += taken.size() - batch.size();
+  st.stats.batches++;
+  st.inFlight = batch.size();
+  lock.unlock();
+  st.spaceCv.notify_all();
+
+  const std::size_t count = batch.size();
+  st.sink(std::move(batch), [state, count](bool ok) { complete(state, count, ok); });
+}
+
+void SignalPublisher::complete(const StatePtr &state, std::size_t count, bool ok) {
+  State &st = *state;
+  std::unique_lock lock(st.mtx);
+  if (ok) st.stats.sent   += count;
+  else    st.stats.failed += count;
+  st.inFlight = 0;
+
+  const auto now = Clock::now();
+  const double secs = std::chrono::duration<double>(now - st.rateStart).count();
+  if (secs >= 1.0) {
+    st.stats.sentPerSecond = (st.stats.sent - st.rateSent) / secs;
+    st.rateSent  = st.stats.sent;
+    st.rateStart = now;
+  }
+  // what queued up meanwhile goes next
+  submit(state, lock);
+  st.spaceCv.notify_all();
+}
+
+bool SignalPublisher::flush(std::chrono::milliseconds timeout) {
+  State &st = *mState_;
+  std::unique_lock lock(st.mtx);
+  return st.spaceCv.wait_for(lock, timeout, [&st] {
+    return st.closed || (st.queue.empty() && st.inFlight == 0);
+  }) && !st.closed;
+}
+
+void SignalPublisher::close() {
+  State &st = *mState_;
+  {
+    std::lock_guard lock(st.mtx);
+    if (st.closed) return;
+    st.closed = true;
+    st.stats.dropped += st.queue.size();
+    st.queue.clear();
+  }
+  st.spaceCv.notify_all();
+
+  const Stats s = stats();
+  if (s.published) {
+    std::cout << "[SignalPublisher] " << mServerURI_ << ": published " << s.published
+              << ", sent " << s.sent
+              << ", coalesced " << s.coalesced
+              << ", dropped " << s.dropped
+              << ", failed " << s.failed
+              << " in " << s.batches << " batch(es)" << std::endl;
+  }
+}
+
+bool SignalPublisher::closed() const {
+  std::lock_guard lock(mState_->mtx);
+  return mState_->closed;
+}
+
+SignalPublisher::Stats SignalPublisher::stats() const {
+  const State &st = *mState_;
+  std::lock_guard lock(mState_->mtx);
+  Stats s  = st.stats;
+  s.queued = st.queue.size();
+
+  // an idle stream has no batches updating the rate
+  const double secs = std::chrono::duration<double>(Clock::now() - st.rateStart).count();
+  if (secs >= 2.0) s.sentPerSecond = (st.stats.sent - st.rateSent) / secs;
+  return s;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef SIGNAL_PUBLISHER_HPP
+#define SIGNAL_PUBLISHER_HPP
+
+#include "KuksaClient.hpp"
+#include "signalcache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// SignalPublisher: persistent publish stream for high-rate signals
+// (simulated sensors, UI sliders) on one server, created by
+// VAPIClient::openPublisher().
+//
+// publish() only appends a typed update to a bounded queue. The queue is
+// handed to the VAPIClient writer in batches of up to maxBatch updates,
+// one batch at a time, keeping only the newest value of every
+// (signal, field) of a batch; the writer's rate limits and latest-wins
+// coalescing apply as for setValuesAsync(). While a batch is with the
+// writer the queue fills up, and once it is full the overflow policy
+// applies: drop the oldest update, reject the new one or block the
+// publisher until there is room.
+//----------------------------------------------------------------------
+class SignalPublisher {
+public:
+  enum class Overflow {
+    DropOldest,   // make room by dropping the oldest queued update
+    DropNewest,   // reject the update being published
+    Block         // wait for room, up to blockTimeout
+  };
+
+  struct Options {
+    std::size_t               capacity     = 1024;
+    std::size_t               maxBatch     = 64;
+    Overflow                  overflow     = Overflow::DropOldest;
+    std::chrono::milliseconds blockTimeout{100};
+  };
+
+  struct Stats {
+    std::uint64_t published  = 0;   // updates accepted by publish()
+    std::uint64_t sent       = 0;   // updates of batches the writer applied
+    std::uint64_t coalesced  = 0;   // replaced by a newer value in the same batch
+    std::uint64_t dropped    = 0;   // lost to the overflow policy or close()
+    std::uint64_t failed     = 0;   // updates of batches the writer failed
+    std::uint64_t batches    = 0;
+    std::size_t   queued     = 0;   // currently waiting
+    std::size_t   maxQueued  = 0;
+    double        sentPerSecond = 0.0;  // over the last full second
+  };
+
+  struct Update {
+    SignalHandle signal;
+    int          field;
+    SignalValue  value;
+    std::function<void(KuksaClient::KuksaClient &)> write;
+  };
+
+  // Hands a batch to the writer; onDone(ok) follows once it was applied,
+  // possibly on another thread.
+  using Sink = std::function<void(std::vector<Update> batch, std::function<void(bool)> onDone)>;
+
+  SignalPublisher(std::string serverURI, Options options, Sink sink);
+  ~SignalPublisher();
+
+  SignalPublisher(const SignalPublisher&)            = delete;
+  SignalPublisher& operator=(const SignalPublisher&) = delete;
+
+  // Queue a typed update; T decides the databroker datatype as with
+  // KuksaClient::setCurrentValue<T>(). Returns false if the update was
+  // rejected (full queue with DropNewest/Block, or closed stream).
+  template<typename T>
+  bool publish(SignalHandle signal, const T &value, int field = KuksaClient::FT_VALUE) {
+    if (signal == INVALID_SIGNAL) return false;
+    return enqueue(Update{signal, field, SignalCache::from(value), writer<T>(signal, value, field)});
+  }
+
+  template<typename T>
+  bool publish(const std::string &path, const T &value, int field = KuksaClient::FT_VALUE) {
+    return publish<T>(SIGNAL_REGISTRY.intern(path), value, field);
+  }
+
+  // Wait until everything queued so far has been sent; false on timeout.
+  bool flush(std::chrono::milliseconds timeout);
+
+  // Stop publishing; queued updates are dropped, a batch already with the
+  // writer still completes.
+  void close();
+  bool closed() const;
+
+  const std::string& serverURI() const { return mServerURI_; }
+  Stats stats() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+  using Write = std::function<void(KuksaClient::KuksaClient &)>;
+
+  template<typename T>
+  static Write writer(SignalHandle signal, const T &value, int field) {
+    return [signal, value, field](KuksaClient::KuksaClient &c) {
+      const std::string &path = SIGNAL_REGISTRY.path(signal);
+      if (field == KuksaClient::FT_ACTUATOR_TARGET) c.setTargetValue<T>(path, value);
+      else                                          c.setCurrentValue<T>(path, value);
+    };
+  }
+
+  // shared with the completion of the batch at the writer, which may
+  // outlive the publisher
+  struct State {
+    Options                 options;
+    Sink                    sink;
+    std::mutex              mtx;
+    std::condition_variable spaceCv;   // publishers: room in the queue, flushed
+    std::deque<Update>      queue;
+    bool                    closed = false;
+    std::size_t             inFlight = 0;
+    Stats                   stats;
+    Clock::time_point       rateStart;
+    std::uint64_t           rateSent = 0;
+  };
+  using StatePtr = std::shared_ptr<State>;
+
+  bool enqueue(Update update);
+  // Hand the next batch to the writer unless one is still there; called
+  // with the lock held, which is released on return.
+  static void submit(const StatePtr &state, std::unique_lock<std::mutex> &lock);
+  static void complete(const StatePtr &state, std::size_t count, bool ok);
+
+  const std::string mServerURI_;
+  StatePtr          mState_;
+};
+
+#endif // SIGNAL_PUBLISHER_HPP
@@ -0,0 +1,336 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "signalrecorder.hpp"
+#include "vapiclient.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  constexpr char          MAGIC[4] = {'D', 'K', 'S', 'R'};
+  constexpr std::uint32_t VERSION  = 1;
+
+  struct FileHeader {
+    char          magic[4];
+    std::uint32_t version;
+    std::int64_t  startNs;
+  };
+
+  struct RecordHeader {
+    std::uint64_t timeNs;
+    std::uint32_t signal;
+    std::uint8_t  type;
+    std::uint8_t  field;
+    std::uint8_t  kind;
+    std::uint8_t  reserved;
+    std::uint64_t payload;
+  };
+
+  static_assert(sizeof(FileHeader) == 16, "signal log header layout");
+  static_assert(sizeof(RecordHeader) == 24, "signal log record layout");
+
+  constexpr std::uint8_t KIND_STRING = 6; // variant index of std::string
+
+  std::size_t padded(std::size_t size) {
+    return (size + 7) & ~std::size_t(7);
+  }
+}
+
+//----------------------------------------------------------------------
+// SignalRecorder
+//----------------------------------------------------------------------
+SignalRecorder::~SignalRecorder() {
+  stop();
+}
+
+bool SignalRecorder::start(const std::string &file) {
+  std::lock_guard lock(mMtx_);
+  if (mFd_ >= 0) closeLocked();
+
+  mFd_ = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (mFd_ < 0) {
+    std::cerr << "[SignalRecorder] Cannot open " << file << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  mUsed_ = 0;
+  mCapacity_ = 0;
+  mDefined_.clear();
+  mRecords_ = 0;
+  mStart_ = std::chrono::steady_clock::now();
+
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::system_clock::now().time_since_epoch()).count();
+  if (!appendLocked(&header, sizeof(header))) {
+    closeLocked();
+    return false;
+  }
+
+  mActive_.store(true);
+  std::cout << "[SignalRecorder] Recording to " << file << std::endl;
+  return true;
+}
+
+void SignalRecorder::stop() {
+  std::lock_guard lock(mMtx_);
+  if (mFd_ < 0) return;
+  std::cout << "[SignalRecorder] Recorded " << mRecords_.load() << " records" << std::endl;
+  closeLocked();
+}
+
+void SignalRecorder::closeLocked() {
+  mActive_.store(false);
+  if (mMap_) {
+    ::munmap(mMap_, mCapacity_);
+    mMap_ = nullptr;
+  }
+  if (mFd_ >= 0) {
+    // drop the unused tail of the last chunk
+    if (::ftruncate(mFd_, static_cast<off_t>(mUsed_)) != 0) {
+      std::cerr << "[SignalRecorder] Cannot truncate log: " << std::strerror(errno) << std::endl;
+    }
+    ::close(mFd_);
+    mFd_ = -1;
+  }
+  mCapacity_ = 0;
+}
+
+bool SignalRecorder::reserveLocked(std::size_t size) {
+  if (mUsed_ + size <= mCapacity_) return true;
+
+  std::size_t capacity = std::max(mCapacity_ * 2, mUsed_ + size);
+  capacity = (capacity + CHUNK - 1) / CHUNK * CHUNK;
+
+  if (mMap_) {
+    ::munmap(mMap_, mCapacity_);
+    mMap_ = nullptr;
+  }
+  if (::ftruncate(mFd_, static_cast<off_t>(capacity)) != 0) {
+    std::cerr << "[SignalRecorder] Cannot grow log: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  void *map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, mFd_, 0);
+  if (map == MAP_FAILED) {
+    std::cerr << "[SignalRecorder] Cannot map log: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  mMap_ = static_cast<char *>(map);
+  mCapacity_ = capacity;
+  return true;
+}
+
+bool SignalRecorder::appendLocked(const void *data, std::size_t size) {
+  if (!reserveLocked(padded(size))) return false;
+  std::memcpy(mMap_ + mUsed_, data, size);
+  std::memset(mMap_ + mUsed_ + size, 0, padded(size) - size);
+  mUsed_ += padded(size);
+  return true;
+}
+
+bool SignalRecorder::appendRecordLocked(SignalLog::RecordType type, SignalHandle signal, int field,
+                                        std::uint8_t kind, std::uint64_t payload,
+                                        const std::string *text) {
+  RecordHeader header;
+  header.timeNs   = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - mStart_).count();
+  header.signal   = signal;
+  header.type     = type;
+  header.field    = static_cast<std::uint8_t>(field);
+  header.kind     = kind;
+  header.reserved = 0;
+  header.payload  = text ? text->size() : payload;
+
+  if (!appendLocked(&header, sizeof(header))) return false;
+  if (text && !text->empty() && !appendLocked(text->data(), text->size())) return false;
+  return true;
+}
+
+void SignalRecorder::record(SignalLog::RecordType type, SignalHandle signal, int field,
+                            const SignalValue &value) {
+  if (!active() || signal == INVALID_SIGNAL) return;
+
+  std::uint64_t bits = 0;
+  std::visit([&bits](const auto &v) {
+    using V = std::decay_t<decltype(v)>;
+    if constexpr (std::is_arithmetic_v<V>) {
+      std::memcpy(&bits, &v, sizeof(V));
+    }
+  }, value);
+  const auto *text = std::get_if<std::string>(&value);
+
+  std::lock_guard lock(mMtx_);
+  if (mFd_ < 0) return;
+
+  bool ok = true;
+  if (mDefined_.size() <= signal) mDefined_.resize(signal + 1, false);
+  if (!mDefined_[signal]) {
+    const std::string &path = SIGNAL_REGISTRY.path(signal);
+    ok = appendRecordLocked(SignalLog::RT_PATH, signal, 0, KIND_STRING, 0, &path);
+    mDefined_[signal] = ok;
+  }
+  ok = ok && appendRecordLocked(type, signal, field, static_cast<std::uint8_t>(value.index()),
+                                bits, text);
+  if (!ok) {
+    // a full disk ends the recording, the log stays readable up to here
+    closeLocked();
+    return;
+  }
+  mRecords_.fetch_add(1, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------
+// SignalReplayer
+//----------------------------------------------------------------------
+SignalReplayer::~SignalReplayer() {
+  close();
+}
+
+bool SignalReplayer::open(const std::string &file) {
+  close();
+
+  mFd_ = ::open(file.c_str(), O_RDONLY);
+  if (mFd_ < 0) {
+    std::cerr << "[SignalReplayer] Cannot open " << file << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  struct stat st;
+  if (::fstat(mFd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+    std::cerr << "[SignalReplayer] Not a signal log: " << file << std::endl;
+    close();
+    return false;
+  }
+  void *map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, mFd_, 0);
+  if (map == MAP_FAILED) {
+    std::cerr << "[SignalReplayer] Cannot map " << file << ": " << std::strerror(errno) << std::endl;
+    close();
+    return false;
+  }
+  mMap_  = static_cast<const char *>(map);
+  mSize_ = st.st_size;
+
+  FileHeader header;
+  std::memcpy(&header, mMap_, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+    std::cerr << "[SignalReplayer] Unsupported signal log: " << file << std::endl;
+    close();
+    return false;
+  }
+  return true;
+}
+
+void SignalReplayer::close() {
+  stop();
+  if (mMap_) {
+    ::munmap(const_cast<char *>(mMap_), mSize_);
+    mMap_ = nullptr;
+    mSize_ = 0;
+  }
+  if (mFd_ >= 0) {
+    ::close(mFd_);
+    mFd_ = -1;
+  }
+}
+
+void SignalReplayer::forEach(const std::function<void(const SignalLog::Record &)> &visit) const {
+  if (!mMap_) return;
+
+  // handle in the log -> handle in this process
+  std::vector<SignalHandle> local;
+  std::size_t pos = sizeof(FileHeader);
+  while (pos + sizeof(RecordHeader) <= mSize_) {
+    RecordHeader rh;
+    std::memcpy(&rh, mMap_ + pos, sizeof(rh));
+    pos += sizeof(rh);
+
+    std::string_view text;
+    if (rh.kind == KIND_STRING) {
+      if (rh.payload > mSize_ - pos) break; // truncated log
+      text = std::string_view(mMap_ + pos, rh.payload);
+      pos += padded(rh.payload);
+    }
+
+    if (rh.type == SignalLog::RT_PATH) {
+      if (local.size() <= rh.signal) local.resize(rh.signal + 1, INVALID_SIGNAL);
+      local[rh.signal] = SIGNAL_REGISTRY.intern(std::string(text));
+      continue;
+    }
+    if (rh.signal >= local.size() || local[rh.signal] == INVALID_SIGNAL) continue;
+
+    SignalLog::Record record;
+    record.time   = std::chrono::nanoseconds(rh.timeNs);
+    record.type   = static_cast<SignalLog::RecordType>(rh.type);
+    record.signal = local[rh.signal];
+    record.field  = rh.field;
+    switch (rh.kind) {
+      case 1: { bool          v; std::memcpy(&v, &rh.payload, sizeof(v)); record.value = v; break; }
+      case 2: { std::int64_t  v; std::memcpy(&v, &rh.payload, sizeof(v)); record.value = v; break; }
+      case 3: { std::uint64_t v; std::memcpy(&v, &rh.payload, sizeof(v)); record.value = v; break; }
+      case 4: { float         v; std::memcpy(&v, &rh.payload, sizeof(v)); record.value = v; break; }
+      case 5: { double        v; std::memcpy(&v, &rh.payload, sizeof(v)); record.value = v; break; }
+      case KIND_STRING: record.value = std::string(text); break;
+      default: break;
+    }
+    visit(record);
+  }
+}
+
+bool SignalReplayer::start(const std::string &serverURI, double speed,
+                           std::function<void(std::uint64_t)> onDone) {
+  if (!mMap_ || mRunning_.load()) return false;
+  if (mThread_.joinable()) mThread_.join();
+
+  mStop_.store(false);
+  mRunning_.store(true);
+  mThread_ = std::thread(&SignalReplayer::replay, this, serverURI, speed, std::move(onDone));
+  return true;
+}
+
+void SignalReplayer::stop() {
+  mStop_.store(true);
+  if (mThread_.joinable()) mThread_.join();
+}
+
+void SignalReplayer::replay(std::string serverURI, double speed,
+                            std::function<void(std::uint64_t)> onDone) {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  std::uint64_t delivered = 0;
+
+  std::cout << "[SignalReplayer] Replaying to " << serverURI << " at "
+            << (speed > 0.0 ? std::to_string(speed) + "x" : std::string("full speed")) << std::endl;
+
+  forEach([&](const SignalLog::Record &record) {
+    if (mStop_.load() || record.type != SignalLog::RT_UPDATE) return;
+
+    if (speed > 0.0) {
+      const auto due = start + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double, std::nano>(record.time.count() / speed));
+      // sleep in slices so stop() does not wait for a long gap in the log
+      for (auto now = Clock::now(); now < due && !mStop_.load(); now = Clock::now()) {
+        std::this_thread::sleep_for(std::min<Clock::duration>(due - now, std::chrono::milliseconds(50)));
+      }
+      if (mStop_.load()) return;
+    }
+
+    VAPI_CLIENT.injectUpdate(serverURI, record.signal, record.field, SignalCache::format(record.value));
+    delivered++;
+  });
+
+  const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::cout << "[SignalReplayer] Delivered " << delivered << " updates in " << ms << " ms" << std::endl;
+  mRunning_.store(false);
+  if (onDone) onDone(delivered);
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef SIGNAL_RECORDER_HPP
+#define SIGNAL_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "signalcache.hpp"
+
+//----------------------------------------------------------------------
+// Signal log: binary file of timestamped, typed signal records.
+//
+//   header : "DKSR", uint32 version, int64 wall clock of the start (ns)
+//   record : uint64 time since start (ns), uint32 signal, uint8 type,
+//            uint8 field, uint8 value kind (SignalValue index), uint8 0,
+//            uint64 payload
+//
+// The payload holds bool/integer/float values; for strings and path
+// definitions it is the byte length of the text that follows, padded to
+// 8 bytes. A signal is written by handle, defined once by an RT_PATH
+// record before its first use, so the log is independent of the interning
+// order of the process reading it.
+//----------------------------------------------------------------------
+namespace SignalLog {
+  enum RecordType : std::uint8_t {
+    RT_UPDATE = 1,  // subscription update delivered by the databroker
+    RT_WRITE  = 2,  // value written through VAPIClient
+    RT_PATH   = 3   // definition of a signal handle
+  };
+
+  struct Record {
+    std::chrono::nanoseconds time;
+    RecordType               type;
+    SignalHandle             signal;  // interned in the reading process
+    int                      field;
+    SignalValue              value;
+  };
+}
+
+//----------------------------------------------------------------------
+// SignalRecorder: appends records to a memory-mapped signal log. Appending
+// is a copy into the mapping under a short lock; the file grows in chunks
+// and is cut to its used size when recording stops.
+//----------------------------------------------------------------------
+class SignalRecorder {
+public:
+  SignalRecorder() = default;
+  ~SignalRecorder();
+
+  SignalRecorder(const SignalRecorder&)            = delete;
+  SignalRecorder& operator=(const SignalRecorder&) = delete;
+
+  bool start(const std::string &file);
+  void stop();
+  bool active() const { return mActive_.load(std::memory_order_relaxed); }
+
+  void record(SignalLog::RecordType type, SignalHandle signal, int field,
+              const SignalValue &value);
+  // parses the text only while recording
+  void recordText(SignalLog::RecordType type, SignalHandle signal, int field,
+                  const std::string &text) {
+    if (active()) record(type, signal, field, SignalCache::parse(text));
+  }
+
+  std::uint64_t records() const { return mRecords_.load(std::memory_order_relaxed); }
+
+private:
+  bool appendLocked(const void *data, std::size_t size);
+  bool appendRecordLocked(SignalLog::RecordType type, SignalHandle signal, int field,
+                          std::uint8_t kind, std::uint64_t payload,
+                          const std::string *text);
+  bool reserveLocked(std::size_t size);
+  void closeLocked();
+
+  std::mutex                          mMtx_;
+  std::atomic<bool>                   mActive_{false};
+  std::atomic<std::uint64_t>          mRecords_{0};
+  int                                 mFd_ = -1;
+  char                               *mMap_ = nullptr;
+  std::size_t                         mCapacity_ = 0;
+  std::size_t                         mUsed_ = 0;
+  std::chrono::steady_clock::time_point mStart_;
+  std::vector<bool>                   mDefined_;   // by signal handle
+
+  static constexpr std::size_t CHUNK = 1 << 20;
+};
+
+//----------------------------------------------------------------------
+// SignalReplayer: feeds the updates of a signal log back into the
+// VAPIClient subscription pipeline (cache and subscribers), so pages can
+// be driven deterministically without a vehicle. Writes in the log are
+// not replayed.
+//----------------------------------------------------------------------
+class SignalReplayer {
+public:
+  SignalReplayer() = default;
+  ~SignalReplayer();
+
+  SignalReplayer(const SignalReplayer&)            = delete;
+  SignalReplayer& operator=(const SignalReplayer&) = delete;
+
+  // Map a log and check it; records are decoded while replaying.
+  bool open(const std::string &file);
+  void close();
+
+  // Visit every record of the open log in order.
+  void forEach(const std::function<void(const SignalLog::Record &)> &visit) const;
+
+  // Replay on a thread of its own. speed 1.0 is real time, N is N times
+  // faster and 0 as fast as possible. onDone gets the number of updates
+  // delivered, also when stopped early.
+  bool start(const std::string &serverURI, double speed = 1.0,
+             std::function<void(std::uint64_t)> onDone = nullptr);
+  void stop();
+  bool running() const { return mRunning_.load(); }
+
+private:
+  void replay(std::string serverURI, double speed,
+              std::function<void(std::uint64_t)> onDone);
+
+  int               mFd_ = -1;
+  const char       *mMap_ = nullptr;
+  std::size_t       mSize_ = 0;
+  std::thread       mThread_;
+  std::atomic<bool> mStop_{false};
+  std::atomic<bool> mRunning_{false};
+};
+
+#endif // SIGNAL_RECORDER_HPP
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "signalregistry.hpp"
+#include <iostream>
+
+SignalRegistry& SignalRegistry::instance() {
+  static SignalRegistry inst;
+  return inst;
+}
+
+SignalRegistry::SignalRegistry()
+  : mPaths_(new std::string[MAX_SIGNALS])
+  , mCurrent_(std::make_unique<const Index>()) {
+  mIndex_.store(mCurrent_.get(), std::memory_order_release);
+}
+
+// Same scheme as SignalCache: the reader counts itself in before it loads
+// the snapshot (both seq_cst), so a writer that swapped the index and then
+// sees no reader knows that every later reader loads the new one.
+SignalRegistry::ReadGuard::ReadGuard(const SignalRegistry &registry)
+  : mRegistry(registry) {
+  mRegistry.mReaders_.fetch_add(1);
+  mIndex = mRegistry.mIndex_.load();
+}
+
+SignalRegistry::ReadGuard::~ReadGuard() {
+  mRegistry.mReaders_.fetch_sub(1);
+}
+
+SignalHandle SignalRegistry::intern(const std::string &path) {
+  SignalHandle handle = find(path);
+  if (handle != INVALID_SIGNAL) return handle;
+
+  std::lock_guard lock(mInternMtx_);
+  // re-check, another thread may have interned it meanwhile
+  handle = find(path);
+  if (handle != INVALID_SIGNAL) return handle;
+
+  const std::size_t size = mSize_.load(std::memory_order_relaxed);
+  if (size >= MAX_SIGNALS) {
+    std::cerr << "[SignalRegistry] Too many signals, cannot intern " << path << std::endl;
+    return INVALID_SIGNAL;
+  }
+
+  handle = static_cast<SignalHandle>(size);
+  mPaths_[size] = path;
+  mSize_.store(size + 1, std::memory_order_release);
+
+  auto next = std::make_unique<Index>(*mCurrent_);
+  next->emplace(path, handle);
+  mIndex_.store(next.get());
+  mRetired_.push_back(std::move(mCurrent_));
+  mCurrent_ = std::move(next);
+  if (mReaders_.load() == 0) {
+    mRetired_.clear();
+  }
+  return handle;
+}
+
+SignalHandle SignalRegistry::find(const std::string &path) const {
+  ReadGuard guard(*this);
+  const Index &index = guard.index();
+  auto it = index.find(path);
+  return it == index.end() ? INVALID_SIGNAL : it->second;
+}
+
+const std::string& SignalRegistry::path(SignalHandle handle) const {
+  static const std::string empty;
+  if (handle >= mSize_.load(std::memory_order_acquire)) return empty;
+  return mPaths_[handle];
+}
+
+std::size_t SignalRegistry::size() const {
+  return mSize_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef SIGNAL_REGISTRY_HPP
+#define SIGNAL_REGISTRY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Small integer standing for an interned VSS path.
+using SignalHandle = std::uint32_t;
+constexpr SignalHandle INVALID_SIGNAL = 0xFFFFFFFFu;
+
+//----------------------------------------------------------------------
+// SignalRegistry: interns VSS paths into dense handles (0, 1, 2, ...)
+// so that the update path can carry and index by an integer instead of
+// copying and comparing strings.
+//
+// intern() takes a lock and is meant for subscription time; path() and
+// find() never lock. Handles are never recycled. Replaced lookup index
+// snapshots are freed as soon as no find() is inside the index.
+//----------------------------------------------------------------------
+class SignalRegistry {
+public:
+  static SignalRegistry& instance();
+
+  // Handle of path, registering it on first use.
+  // Returns INVALID_SIGNAL only when the registry is full.
+  SignalHandle intern(const std::string &path);
+
+  // Handle of an already interned path, INVALID_SIGNAL otherwise.
+  SignalHandle find(const std::string &path) const;
+
+  // Path of a valid handle.
+  const std::string& path(SignalHandle handle) const;
+
+  // Number of interned paths; every handle is below this value.
+  std::size_t size() const;
+
+  static constexpr std::size_t MAX_SIGNALS = 4096;
+
+private:
+  SignalRegistry();
+
+  SignalRegistry(const SignalRegistry&)            = delete;
+  SignalRegistry& operator=(const SignalRegistry&) = delete;
+
+  using Index = std::unordered_map<std::string, SignalHandle>;
+
+  // counts a reader in for as long as it uses the index snapshot
+  class ReadGuard {
+  public:
+    explicit ReadGuard(const SignalRegistry &registry);
+    ~ReadGuard();
+    const Index &index() const { return *mIndex; }
+  private:
+    const SignalRegistry &mRegistry;
+    const Index          *mIndex;
+  };
+
+  // preallocated, so a published entry never moves
+  std::unique_ptr<std::string[]>            mPaths_;
+  std::atomic<std::size_t>                  mSize_{0};
+  // copy-on-write lookup index for lock-free readers
+  std::atomic<const Index*>                 mIndex_;
+  mutable std::atomic<int>                  mReaders_{0};
+  std::unique_ptr<const Index>              mCurrent_;
+  // replaced snapshots, freed by intern() once no reader is counted in
+  std::vector<std::unique_ptr<const Index>> mRetired_;
+  std::mutex                                mInternMtx_;
+};
+
+// convenience macro
+#define SIGNAL_REGISTRY  (SignalRegistry::instance())
+
+#endif // SIGNAL_REGISTRY_HPP
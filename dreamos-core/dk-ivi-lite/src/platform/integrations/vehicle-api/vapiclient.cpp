@@ -8,6 +8,8 @@
 #include "vapiclient.hpp"
 #include <future>
 #include <chrono>
+#include <algorithm>
+#include <random>
 
 
 VAPIClient& VAPIClient::instance() {
@@ -42,7 +44,7 @@ bool VAPIClient::connectToServer(const std::string &serverURI,
 
     ClientEntry entry;
     entry.client = std::move(client);
-    mClients_.try_emplace(serverURI, std::move(entry));
+    startWatcherLocked(serverURI, mClients_.try_emplace(serverURI, std::move(entry)).first->second);
 
     std::cout << "[VAPIClient] Connected to " << serverURI << "\n";
     return true;
@@ -56,7 +58,7 @@ bool VAPIClient::connectToServer(const std::string &serverURI,
       auto client = std::make_unique<KuksaClient::KuksaClient>(cfg);
       ClientEntry entry;
       entry.client = std::move(client);
-      mClients_.try_emplace(serverURI, std::move(entry));
+      startWatcherLocked(serverURI, mClients_.try_emplace(serverURI, std::move(entry)).first->second);
       std::cout << "[VAPIClient] Created client entry for future reconnection to " << serverURI << "\n";
     } catch (const std::exception &e2) {
       std::cerr << "[VAPIClient] Failed to create client entry: " << e2.what() << "\n";
@@ -88,6 +90,13 @@ VAPIClient::findClient(const std::string &serverURI) const {
   return it->second.client.get();
 }
 
+std::shared_ptr<KuksaClient::KuksaClient>
+VAPIClient::clientRef(const std::string &serverURI) {
+  std::lock_guard lock(mClientsMtx_);
+  auto it = mClients_.find(serverURI);
+  return it == mClients_.end() ? nullptr : it->second.client;
+}
+
 bool VAPIClient::getCurrentValue(const std::string &serverURI,
                                  const std::string &path,
                                  std::string       &outValue) {
@@ -106,180 +115,918 @@ bool VAPIClient::getTargetValue(const std::string &serverURI,
   return !outValue.empty();
 }
 
-bool VAPIClient::subscribeCurrent(const std::string               &serverURI,
-                                  const std::vector<std::string> &paths,
-                                  SubscribeCallback               callback) {
-  auto *c = findClient(serverURI);
-  if (!c) return false;
+std::size_t VAPIClient::fieldIndex(int field) {
+  return field == KuksaClient::FT_ACTUATOR_TARGET ? 1 : 0;
+}
+
+std::vector<SignalHandle> VAPIClient::internPaths(const std::vector<std::string> &paths) {
+  std::vector<SignalHandle> handles;
+  handles.reserve(paths.size());
+  for (const auto &p : paths) {
+    SignalHandle h = SIGNAL_REGISTRY.intern(p);
+    if (h != INVALID_SIGNAL) handles.push_back(h);
+  }
+  return handles;
+}
 
-  // Sequential subscription to prevent race conditions during gRPC setup
+SubscriptionId VAPIClient::subscribe(const std::string               &serverURI,
+                                     const std::vector<SignalHandle> &handles,
+                                     int                              field,
+                                     SignalCallback                   callback) {
+  if (!callback || !findClient(serverURI)) return 0;
+
+  SubscriptionId id = 0;
+  ServerRoutes *routes = nullptr;
+  std::vector<SignalHandle> newStreams;
   {
-    std::lock_guard lock(mClientsMtx_);
-    auto &entry = mClients_.at(serverURI);
+    std::unique_lock lock(mRoutesMtx_);
+    id = mNextSubscriptionId_++;
 
-    // Create single thread that handles all current value subscriptions sequentially
-    std::thread subThread([c, paths, callback]() {
-      for (const auto &p : paths) {
-        try {
-          c->subscribeWithReconnect(p, callback, KuksaClient::FT_VALUE);
-          // Small delay between subscriptions to prevent gRPC resource conflicts
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        } catch (const std::exception& e) {
-          std::cerr << "[VAPIClient] Failed to subscribe to current value for " << p << ": " << e.what() << std::endl;
-        }
-      }
+    Subscription sub;
+    sub.serverURI = serverURI;
+    sub.field     = field;
+    sub.callback  = std::make_shared<const SignalCallback>(std::move(callback));
+
+    routes = &mRoutes_[serverURI];
+    addRoutesLocked(*routes, sub, handles, newStreams);
+    mSubscriptions_.emplace(id, std::move(sub));
+  }
+
+  openStreams(serverURI, routes, std::move(newStreams), field);
+  return id;
+}
+
+SubscriptionId VAPIClient::subscribe(const std::string               &serverURI,
+                                     const std::vector<std::string> &paths,
+                                     int                             field,
+                                     SubscribeCallback               callback) {
+  if (!callback) return 0;
+  return subscribe(serverURI, internPaths(paths), field,
+    [callback = std::move(callback)](SignalHandle signal, const std::string &value, int field) {
+      callback(SIGNAL_REGISTRY.path(signal), value, field);
     });
-    entry.subThreads.emplace_back(std::move(subThread));
+}
+
+bool VAPIClient::addSignals(SubscriptionId id, const std::vector<SignalHandle> &handles) {
+  std::string serverURI;
+  ServerRoutes *routes = nullptr;
+  int field = KuksaClient::FT_VALUE;
+  std::vector<SignalHandle> newStreams;
+  {
+    std::unique_lock lock(mRoutesMtx_);
+    auto it = mSubscriptions_.find(id);
+    if (it == mSubscriptions_.end()) return false;
+
+    serverURI = it->second.serverURI;
+    field     = it->second.field;
+    routes    = &mRoutes_[serverURI];
+    addRoutesLocked(*routes, it->second, handles, newStreams);
   }
+
+  openStreams(serverURI, routes, std::move(newStreams), field);
   return true;
 }
 
-bool VAPIClient::subscribeTarget(const std::string               &serverURI,
-                                 const std::vector<std::string> &paths,
-                                 SubscribeCallback               callback) {
-  auto *c = findClient(serverURI);
-  if (!c) return false;
+bool VAPIClient::removeSignals(SubscriptionId id, const std::vector<SignalHandle> &handles) {
+  std::unique_lock lock(mRoutesMtx_);
+  auto it = mSubscriptions_.find(id);
+  if (it == mSubscriptions_.end()) return false;
+
+  removeRoutesLocked(mRoutes_[it->second.serverURI], it->second, handles);
+  return true;
+}
+
+bool VAPIClient::addPaths(SubscriptionId id, const std::vector<std::string> &paths) {
+  return addSignals(id, internPaths(paths));
+}
+
+bool VAPIClient::removePaths(SubscriptionId id, const std::vector<std::string> &paths) {
+  return removeSignals(id, internPaths(paths));
+}
+
+void VAPIClient::unsubscribe(SubscriptionId id) {
+  std::unique_lock lock(mRoutesMtx_);
+  auto it = mSubscriptions_.find(id);
+  if (it == mSubscriptions_.end()) return;
+
+  std::vector<SignalHandle> handles(it->second.handles.begin(), it->second.handles.end());
+  removeRoutesLocked(mRoutes_[it->second.serverURI], it->second, handles);
+  mSubscriptions_.erase(it);
+}
+
+void VAPIClient::addRoutesLocked(ServerRoutes &routes, Subscription &sub,
+                                 const std::vector<SignalHandle> &handles,
+                                 std::vector<SignalHandle> &newStreams) {
+  const std::size_t idx = fieldIndex(sub.field);
+  for (SignalHandle h : handles) {
+    if (!sub.handles.insert(h).second) continue;
+
+    auto &byHandle = routes.routes[idx];
+    if (byHandle.size() <= h) byHandle.resize(h + 1);
+    RouteList &list = byHandle[h];
+    auto updated = list ? std::make_shared<std::vector<CallbackPtr>>(*list)
+                        : std::make_shared<std::vector<CallbackPtr>>();
+    updated->push_back(sub.callback);
+    list = std::move(updated);
+
+    if (routes.openStreams[idx].insert(h).second) {
+      newStreams.push_back(h);
+    }
+  }
+}
+
+void VAPIClient::removeRoutesLocked(ServerRoutes &routes, Subscription &sub,
+                                    const std::vector<SignalHandle> &handles) {
+  const std::size_t idx = fieldIndex(sub.field);
+  auto &byHandle = routes.routes[idx];
+  for (SignalHandle h : handles) {
+    if (sub.handles.erase(h) == 0) continue;
+    if (h >= byHandle.size() || !byHandle[h]) continue;
+
+    auto updated = std::make_shared<std::vector<CallbackPtr>>();
+    for (const auto &cb : *byHandle[h]) {
+      if (cb != sub.callback) updated->push_back(cb);
+    }
+    // KuksaClient has no per-path unsubscribe: the stream stays open and its
+    // updates are dropped in dispatch() until the signal is subscribed again.
+    if (updated->empty()) {
+      byHandle[h].reset();
+    } else {
+      byHandle[h] = std::move(updated);
+    }
+  }
+}
+
+void VAPIClient::openStreams(const std::string &serverURI, ServerRoutes *routes,
+                             std::vector<SignalHandle> handles, int field) {
+  if (handles.empty()) return;
+
+  std::unique_lock lock(mClientsMtx_);
+  auto it = mClients_.find(serverURI);
+  if (it == mClients_.end()) {
+    lock.unlock();
+    // opened by the watcher of the server once it has a client
+    markStreamsFailed(serverURI, handles, field);
+    return;
+  }
+  auto c      = it->second.client;
+  auto cancel = it->second.cancel;
+
+  // cache slots are resolved once here, the stream only stores into them
+  std::vector<SignalCache::Slot*> slots;
+  slots.reserve(handles.size());
+  for (SignalHandle h : handles) {
+    slots.push_back(mCache_.track(serverURI, h, field));
+  }
+
+  // All streams of the batch are opened in one short-lived thread. Opens are
+  // still paced STREAM_OPEN_PACING apart to avoid gRPC resource conflicts
+  // (the client used to sleep 100 ms per stream for this); the shorter pause
+  // has not been measured against a live databroker, but it keeps both
+  // startup and shutdown bounded.
+  startWorkerLocked(it->second, [this, serverURI, c, cancel, routes, handles = std::move(handles),
+                                  slots = std::move(slots), field]() {
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+      if (i > 0) std::this_thread::sleep_for(STREAM_OPEN_PACING);
+      if (cancel->load()) return;
+      const SignalHandle h = handles[i];
+      SignalCache::Slot *slot = slots[i];
+      try {
+        c->subscribeWithReconnect(SIGNAL_REGISTRY.path(h),
+          [this, cancel, routes, slot, h, field](const std::string &, const std::string &value, const int &) {
+            if (cancel->load(std::memory_order_relaxed)) return;
+            SignalCache::store(slot, value);
+            mRecorder_.recordText(SignalLog::RT_UPDATE, h, field, value);
+            dispatch(routes, cancel, h, value, field);
+          },
+          field);
+      } catch (const std::exception &e) {
+        std::cerr << "[VAPIClient] Failed to open stream for " << SIGNAL_REGISTRY.path(h)
+                  << ": " << e.what() << std::endl;
+        if (!cancel->load()) markStreamsFailed(serverURI, {h}, field);
+      }
+    }
+  });
+}
+
+void VAPIClient::markStreamsFailed(const std::string &serverURI,
+                                   const std::vector<SignalHandle> &handles, int field) {
+  std::unique_lock lock(mRoutesMtx_);
+  auto it = mRoutes_.find(serverURI);
+  if (it == mRoutes_.end()) return;
+  auto &failed = it->second.failedStreams[fieldIndex(field)];
+  failed.insert(handles.begin(), handles.end());
+}
 
-  // Sequential subscription to prevent race conditions during gRPC setup
+bool VAPIClient::reopenFailedStreams(const std::string &serverURI) {
+  std::array<std::vector<SignalHandle>, 2> retry;
+  ServerRoutes *routes = nullptr;
   {
-    std::lock_guard lock(mClientsMtx_);
-    auto &entry = mClients_.at(serverURI);
+    std::unique_lock lock(mRoutesMtx_);
+    auto it = mRoutes_.find(serverURI);
+    if (it == mRoutes_.end()) return false;
+    routes = &it->second;
+    for (std::size_t idx = 0; idx < retry.size(); ++idx) {
+      const auto &byHandle = routes->routes[idx];
+      for (SignalHandle h : routes->failedStreams[idx]) {
+        // a signal nobody subscribes any more is opened by its next subscriber
+        if (h < byHandle.size() && byHandle[h]) retry[idx].push_back(h);
+        else                                    routes->openStreams[idx].erase(h);
+      }
+      routes->failedStreams[idx].clear();
+    }
+  }
+  if (retry[0].empty() && retry[1].empty()) return false;
+
+  std::cout << "[VAPIClient] Reopening " << retry[0].size() + retry[1].size()
+            << " stream(s) to " << serverURI << std::endl;
+  openStreams(serverURI, routes, std::move(retry[0]), KuksaClient::FT_VALUE);
+  openStreams(serverURI, routes, std::move(retry[1]), KuksaClient::FT_ACTUATOR_TARGET);
+  return true;
+}
+
+void VAPIClient::dispatch(ServerRoutes *routes, const CancelToken &cancel, SignalHandle signal,
+                          const std::string &value, int field) {
+  RouteList list;
+  {
+    std::shared_lock lock(mRoutesMtx_);
+    // the tables are cleared right after the cancellation, under this lock
+    if (cancel->load(std::memory_order_relaxed)) return;
+    const auto &byHandle = routes->routes[fieldIndex(field)];
+    if (signal >= byHandle.size() || !byHandle[signal]) return;
+    list = byHandle[signal];
+  }
+  for (const auto &cb : *list) {
+    (*cb)(signal, value, field);
+  }
+}
+
+void VAPIClient::injectUpdate(const std::string &serverURI, SignalHandle signal,
+                              int field, const std::string &value) {
+  SignalCache::store(mCache_.track(serverURI, signal, field), value);
+
+  RouteList list;
+  {
+    std::shared_lock lock(mRoutesMtx_);
+    auto it = mRoutes_.find(serverURI);
+    if (it == mRoutes_.end()) return;
+    const auto &byHandle = it->second.routes[fieldIndex(field)];
+    if (signal >= byHandle.size() || !byHandle[signal]) return;
+    list = byHandle[signal];
+  }
+  for (const auto &cb : *list) {
+    (*cb)(signal, value, field);
+  }
+}
+
+bool VAPIClient::startRecording(const std::string &file) {
+  return mRecorder_.start(file);
+}
+
+void VAPIClient::stopRecording() {
+  mRecorder_.stop();
+}
+
+SignalValue VAPIClient::fetchValue(KuksaClient::KuksaClient *c, const std::string &serverURI,
+                                   SignalHandle signal, int field) {
+  SignalValue value;
+  if (mCache_.get(serverURI, signal, field, value)) return value;
+
+  try {
+    const std::string &path = SIGNAL_REGISTRY.path(signal);
+    return SignalCache::parse(field == KuksaClient::FT_ACTUATOR_TARGET
+                                ? c->getTargetValue(path)
+                                : c->getCurrentValue(path));
+  } catch (const std::exception &e) {
+    std::cerr << "[VAPIClient] Failed to read " << SIGNAL_REGISTRY.path(signal)
+              << ": " << e.what() << std::endl;
+    return std::monostate{};
+  }
+}
+
+std::future<VAPIClient::Snapshot>
+VAPIClient::snapshotAsync(const std::string                     &serverURI,
+                          const std::vector<SignalHandle>       &handles,
+                          std::function<void(const Snapshot &)> onDone) {
+  auto done = std::make_shared<std::promise<Snapshot>>();
+  std::future<Snapshot> result = done->get_future();
+
+  std::unique_lock lock(mClientsMtx_);
+  auto it = mClients_.find(serverURI);
+  if (it == mClients_.end()) {
+    lock.unlock();
+    std::cerr << "[VAPIClient] No client for server " << serverURI << "\n";
+    Snapshot empty;
+    for (SignalHandle h : handles) empty.push_back({h, std::monostate{}, std::monostate{}});
+    done->set_value(empty);
+    if (onDone) onDone(empty);
+    return result;
+  }
+  auto c      = it->second.client;
+  auto cancel = it->second.cancel;
 
-    // Create single thread that handles all target value subscriptions sequentially
-    std::thread subThread([c, paths, callback]() {
-      // Larger delay to ensure current subscriptions complete first
-      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  startWorkerLocked(it->second, [this, c, cancel, serverURI, handles, done, onDone = std::move(onDone)]() {
+    Snapshot snapshot(handles.size());
+    for (std::size_t i = 0; i < handles.size(); ++i) snapshot[i].signal = handles[i];
 
-      for (const auto &p : paths) {
+    // a few readers take the signals in turn; they are joined before the
+    // locals they share go out of scope
+    std::atomic<std::size_t> next{0};
+    auto read = [&]() {
+      for (std::size_t i; (i = next.fetch_add(1)) < handles.size();) {
+        SnapshotEntry &entry = snapshot[i];
+        // a cancelled snapshot completes with the signals left empty
+        if (cancel->load()) return;
+        entry.current = fetchValue(c.get(), serverURI, handles[i], KuksaClient::FT_VALUE);
+        if (cancel->load()) return;
+        entry.target  = fetchValue(c.get(), serverURI, handles[i], KuksaClient::FT_ACTUATOR_TARGET);
+      }
+    };
+    const std::size_t readers = std::min(SNAPSHOT_READERS, handles.size());
+    std::vector<std::thread> helpers;
+    for (std::size_t r = 1; r < readers; ++r) helpers.emplace_back(read);
+    read();
+    for (auto &t : helpers) t.join();
+
+    done->set_value(snapshot);
+    if (onDone) onDone(snapshot);
+  });
+  return result;
+}
+
+std::future<VAPIClient::Snapshot>
+VAPIClient::snapshotAsync(const std::string                     &serverURI,
+                          const std::vector<std::string>        &paths,
+                          std::function<void(const Snapshot &)> onDone) {
+  return snapshotAsync(serverURI, internPaths(paths), std::move(onDone));
+}
+
+std::future<bool> VAPIClient::setValuesAsync(const std::string        &serverURI,
+                                             WriteBatch                 batch,
+                                             std::function<void(bool)> onDone) {
+  auto state = std::make_shared<BatchState>();
+  state->onDone    = std::move(onDone);
+  state->remaining = batch.mEntries_.size();
+  std::future<bool> result = state->done.get_future();
+
+  // the cached values are outdated until the streams confirm the writes
+  for (const auto &e : batch.mEntries_) {
+    mCache_.invalidate(serverURI, e.signal, e.field);
+    mRecorder_.record(SignalLog::RT_WRITE, e.signal, e.field, e.value);
+  }
+
+  std::vector<BatchStatePtr> rejected;
+  bool rejectedOk = false;
+  {
+    std::lock_guard lock(mWriteMtx_);
+    if (mWriterStop_ || batch.empty()) {
+      // nothing to write succeeds right away, a stopped writer fails
+      rejected.push_back(state);
+      rejectedOk = !mWriterStop_;
+    } else {
+      const auto now = WriteClock::now();
+      for (auto &e : batch.mEntries_) {
+        auto &stats = mWriteState_[e.signal].stats;
+        stats.requested++;
+
+        PendingWrite &pending = mPendingWrites_[WriteKey{serverURI, e.signal, e.field}];
+        if (pending.write) {
+          // latest wins: the older value is never sent
+          stats.coalesced++;
+        }
+        pending.write  = std::move(e.write);
+        pending.queued = now;
+        pending.waiters.push_back(state);
+      }
+      if (!mWriter_.thread.joinable()) {
+        mWriter_ = startWorker([this]() { writerLoop(); });
+      }
+    }
+  }
+
+  if (!rejected.empty()) {
+    state->remaining = 1;
+    finishWaiters(rejected, rejectedOk);
+    return result;
+  }
+  mWriteCv_.notify_one();
+  return result;
+}
+
+void VAPIClient::setMaxWriteRate(const std::string &path, double writesPerSecond) {
+  SignalHandle signal = SIGNAL_REGISTRY.intern(path);
+  if (signal == INVALID_SIGNAL) return;
+
+  std::lock_guard lock(mWriteMtx_);
+  mWriteState_[signal].minInterval = writesPerSecond > 0.0
+    ? std::chrono::duration_cast<WriteClock::duration>(std::chrono::duration<double>(1.0 / writesPerSecond))
+    : WriteClock::duration::zero();
+  mWriteCv_.notify_one();
+}
+
+VAPIClient::WriteStats VAPIClient::writeStats(const std::string &path) const {
+  SignalHandle signal = SIGNAL_REGISTRY.find(path);
+
+  std::lock_guard lock(mWriteMtx_);
+  auto it = mWriteState_.find(signal);
+  if (it == mWriteState_.end()) return WriteStats();
+
+  WriteStats stats = it->second.stats;
+  if (stats.applied) stats.avgLatencyMs = it->second.totalLatencyMs / stats.applied;
+  return stats;
+}
+
+VAPIClient::WriteStats VAPIClient::writeStats() const {
+  WriteStats total;
+  double totalLatencyMs = 0.0;
+
+  std::lock_guard lock(mWriteMtx_);
+  for (const auto &kv : mWriteState_) {
+    const WriteStats &s = kv.second.stats;
+    total.requested += s.requested;
+    total.applied   += s.applied;
+    total.coalesced += s.coalesced;
+    total.failed    += s.failed;
+    total.maxLatencyMs = std::max(total.maxLatencyMs, s.maxLatencyMs);
+    totalLatencyMs += kv.second.totalLatencyMs;
+  }
+  if (total.applied) total.avgLatencyMs = totalLatencyMs / total.applied;
+  return total;
+}
+
+void VAPIClient::finishWaiters(std::vector<BatchStatePtr> &waiters, bool ok) {
+  for (auto &state : waiters) {
+    if (!ok) state->ok = false;
+    if (state->remaining.fetch_sub(1) == 1) {
+      state->done.set_value(state->ok);
+      if (state->onDone) state->onDone(state->ok);
+    }
+  }
+  waiters.clear();
+}
+
+void VAPIClient::writerLoop() {
+  for (;;) {
+    std::vector<std::pair<WriteKey, PendingWrite>> due;
+    {
+      std::unique_lock lock(mWriteMtx_);
+      for (;;) {
+        if (mWriterStop_) return;
+
+        // take every pending write whose signal may be written again, and
+        // find out when the next one becomes due
+        const auto now = WriteClock::now();
+        auto next = WriteClock::time_point::max();
+        for (auto it = mPendingWrites_.begin(); it != mPendingWrites_.end();) {
+          const auto &st = mWriteState_[it->first.signal];
+          const auto dueAt = st.lastApplied + st.minInterval;
+          if (dueAt <= now) {
+            due.emplace_back(it->first, std::move(it->second));
+            it = mPendingWrites_.erase(it);
+          } else {
+            next = std::min(next, dueAt);
+            ++it;
+          }
+        }
+        if (!due.empty()) {
+          for (const auto &d : due) mWriteState_[d.first.signal].lastApplied = now;
+          break;
+        }
+
+        if (next == WriteClock::time_point::max()) mWriteCv_.wait(lock);
+        else                                       mWriteCv_.wait_until(lock, next);
+      }
+    }
+
+    // the due writes are applied in order here, never on the caller
+    for (auto &d : due) {
+      bool ok = false;
+      bool stop = false;
+      {
+        std::lock_guard lock(mWriteMtx_);
+        stop = mWriterStop_;
+      }
+      // a stopping writer fails what is left instead of sending it
+      auto c = stop ? nullptr : clientRef(d.first.serverURI);
+      if (c) {
         try {
-          c->subscribeWithReconnect(p, callback, KuksaClient::FT_ACTUATOR_TARGET);
-          // Small delay between subscriptions to prevent gRPC resource conflicts
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        } catch (const std::exception& e) {
-          std::cerr << "[VAPIClient] Failed to subscribe to target value for " << p << ": " << e.what() << std::endl;
+          d.second.write(*c);
+          ok = true;
+        } catch (const std::exception &ex) {
+          std::cerr << "[VAPIClient] Failed to set " << SIGNAL_REGISTRY.path(d.first.signal)
+                    << ": " << ex.what() << std::endl;
+        }
+      }
+      const double latencyMs =
+        std::chrono::duration<double, std::milli>(WriteClock::now() - d.second.queued).count();
+
+      {
+        std::lock_guard lock(mWriteMtx_);
+        auto &st = mWriteState_[d.first.signal];
+        if (ok) {
+          st.stats.applied++;
+          st.totalLatencyMs += latencyMs;
+          st.stats.maxLatencyMs = std::max(st.stats.maxLatencyMs, latencyMs);
+        } else {
+          st.stats.failed++;
         }
       }
+      finishWaiters(d.second.waiters, ok);
+    }
+  }
+}
+
+void VAPIClient::stopWriter(std::chrono::steady_clock::time_point deadline) {
+  std::map<WriteKey, PendingWrite> dropped;
+  {
+    std::lock_guard lock(mWriteMtx_);
+    mWriterStop_ = true;
+    dropped.swap(mPendingWrites_);
+  }
+  mWriteCv_.notify_all();
+
+  for (auto &kv : dropped) {
+    finishWaiters(kv.second.waiters, false);
+  }
+  // a writer blocked in a set gives up its client reference when it returns
+  if (!mWriter_.thread.joinable()) return;
+  joinOrDetach(mWriter_, deadline);
+
+  WriteStats stats = writeStats();
+  if (stats.requested) {
+    std::cout << "[VAPIClient] Writes: requested " << stats.requested
+              << ", applied " << stats.applied
+              << ", coalesced " << stats.coalesced
+              << ", failed " << stats.failed
+              << ", latency avg " << stats.avgLatencyMs << " ms"
+              << ", max " << stats.maxLatencyMs << " ms" << std::endl;
+  }
+}
+
+std::shared_ptr<SignalPublisher> VAPIClient::openPublisher(const std::string        &serverURI,
+                                                           SignalPublisher::Options  options) {
+  // the batches go through the writer like any setValuesAsync()
+  auto publisher = std::make_shared<SignalPublisher>(serverURI, options,
+    [this, serverURI](std::vector<SignalPublisher::Update> updates, std::function<void(bool)> onDone) {
+      WriteBatch batch;
+      batch.mEntries_.reserve(updates.size());
+      for (auto &u : updates) {
+        batch.mEntries_.push_back({u.signal, u.field, std::move(u.value), std::move(u.write)});
+      }
+      setValuesAsync(serverURI, std::move(batch), std::move(onDone));
     });
-    entry.subThreads.emplace_back(std::move(subThread));
+
+  std::lock_guard lock(mPublishersMtx_);
+  mPublishers_.erase(std::remove_if(mPublishers_.begin(), mPublishers_.end(),
+                                    [](const std::weak_ptr<SignalPublisher> &p) { return p.expired(); }),
+                     mPublishers_.end());
+  mPublishers_.push_back(publisher);
+  return publisher;
+}
+
+void VAPIClient::closePublishers() {
+  std::vector<std::weak_ptr<SignalPublisher>> publishers;
+  {
+    std::lock_guard lock(mPublishersMtx_);
+    publishers.swap(mPublishers_);
   }
-  return true;
+  for (auto &weak : publishers) {
+    if (auto p = weak.lock()) p->close();
+  }
+}
+
+bool VAPIClient::subscribeCurrent(const std::string               &serverURI,
+                                  const std::vector<std::string> &paths,
+                                  SubscribeCallback               callback) {
+  return subscribe(serverURI, paths, KuksaClient::FT_VALUE, std::move(callback)) != 0;
+}
+
+bool VAPIClient::subscribeTarget(const std::string               &serverURI,
+                                 const std::vector<std::string> &paths,
+                                 SubscribeCallback               callback) {
+  return subscribe(serverURI, paths, KuksaClient::FT_ACTUATOR_TARGET, std::move(callback)) != 0;
 }
 
 bool VAPIClient::isConnected(const std::string &serverURI) const {
+  // the connection watcher drops the cached values when the link goes down
   auto *c = findClient(serverURI);
   return c ? c->isConnected() : false;
 }
 
 void VAPIClient::setAutoReconnect(const std::string &serverURI, bool enabled) {
-  auto *c = findClient(serverURI);
-  if (c) {
-    c->setAutoReconnect(enabled);
-    std::cout << "[VAPIClient] Auto-reconnect "
-              << (enabled ? "enabled" : "disabled")
-              << " for " << serverURI << std::endl;
+  std::shared_ptr<ConnectionWatch> watch;
+  {
+    std::lock_guard lock(mClientsMtx_);
+    auto it = mClients_.find(serverURI);
+    if (it == mClients_.end()) return;
+    watch = it->second.watch;
   }
+  {
+    std::lock_guard lock(watch->mtx);
+    watch->autoReconnect = enabled;
+  }
+  watch->cv.notify_all();
+  std::cout << "[VAPIClient] Auto-reconnect "
+            << (enabled ? "enabled" : "disabled")
+            << " for " << serverURI << std::endl;
 }
 
 bool VAPIClient::forceReconnect(const std::string &serverURI) {
   auto *c = findClient(serverURI);
   if (c) {
     std::cout << "[VAPIClient] Forcing reconnection to " << serverURI << std::endl;
+    mCache_.invalidateAll(serverURI);
     return c->reconnect();
   }
   return false;
 }
 
-void VAPIClient::shutdown() {
-  std::cout << "[VAPIClient] Shutting down all clients and threads..." << std::endl;
+void VAPIClient::requestReconnect(const std::string &serverURI) {
+  std::shared_ptr<ConnectionWatch> watch;
+  {
+    std::lock_guard lock(mClientsMtx_);
+    auto it = mClients_.find(serverURI);
+    if (it == mClients_.end()) return;
+    watch = it->second.watch;
+  }
+  {
+    std::lock_guard lock(watch->mtx);
+    watch->reconnectNow = true;
+  }
+  watch->cv.notify_all();
+}
 
-  std::lock_guard lock(mClientsMtx_);
+VAPIClient::ListenerId
+VAPIClient::addConnectionListener(const std::string &serverURI, ConnectionCallback callback) {
+  if (!callback) return 0;
+  std::lock_guard lock(mConnMtx_);
+  ListenerId id = mNextListenerId_++;
+  mConnListeners_.emplace(id, std::make_pair(serverURI, std::move(callback)));
+  return id;
+}
 
-  for (auto &kv : mClients_) {
-    auto &entry = kv.second;
+void VAPIClient::removeConnectionListener(ListenerId id) {
+  std::lock_guard lock(mConnMtx_);
+  mConnListeners_.erase(id);
+}
 
-    // Signal KuksaClient to stop first
-    if (entry.client) {
-      std::cout << "[VAPIClient] Shutting down client for " << kv.first << std::endl;
+VAPIClient::ConnectionStats VAPIClient::connectionStats(const std::string &serverURI) const {
+  std::shared_ptr<ConnectionWatch> watch;
+  {
+    std::lock_guard lock(mClientsMtx_);
+    auto it = mClients_.find(serverURI);
+    if (it == mClients_.end()) return ConnectionStats();
+    watch = it->second.watch;
+  }
+  std::lock_guard lock(watch->mtx);
+  return watch->stats;
+}
+
+void VAPIClient::notifyConnection(const std::string &serverURI, bool connected) {
+  std::vector<ConnectionCallback> callbacks;
+  {
+    std::lock_guard lock(mConnMtx_);
+    for (const auto &kv : mConnListeners_) {
+      if (kv.second.first == serverURI) callbacks.push_back(kv.second.second);
     }
+  }
+  for (const auto &cb : callbacks) {
+    cb(connected);
+  }
+}
 
-    // Join subscription threads with timeout
-    std::cout << "[VAPIClient] Joining " << entry.subThreads.size()
-              << " subscription threads..." << std::endl;
+std::chrono::milliseconds VAPIClient::reconnectDelay(std::uint64_t attempt) {
+  // exponential backoff with equal jitter: clients losing the databroker at
+  // the same moment do not all come back at the same moment
+  thread_local std::mt19937 rng{std::random_device{}()};
+  const auto cap = RECONNECT_BASE_DELAY.count() << std::min<std::uint64_t>(attempt, 16);
+  const auto delay = std::min<std::chrono::milliseconds::rep>(cap, RECONNECT_MAX_DELAY.count());
+  std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter(0, delay / 2);
+  return std::chrono::milliseconds(delay - delay / 2 + jitter(rng));
+}
 
-    size_t joinedCount = 0;
-    size_t detachedCount = 0;
+void VAPIClient::startWatcherLocked(const std::string &serverURI, ClientEntry &entry) {
+  // the watcher is the only reconnect policy, KuksaClient's own thread
+  // would race it for the channel
+  entry.client->setAutoReconnect(false);
+  startWorkerLocked(entry, [this, serverURI, c = entry.client, cancel = entry.cancel,
+                            watch = entry.watch]() {
+    watchConnection(serverURI, c, cancel, watch);
+  });
+}
 
-    for (auto &t : entry.subThreads) {
-      try {
-        if (t.joinable()) {
-          // Try to join with timeout using async approach
-          auto future = std::async(std::launch::async, [&t]() {
-            t.join();
-          });
-
-          if (future.wait_for(std::chrono::seconds(3)) == std::future_status::ready) {
-            joinedCount++;
-          } else {
-            std::cerr << "[VAPIClient] Thread join timeout, detaching thread" << std::endl;
-            t.detach();
-            detachedCount++;
-          }
-        }
-      } catch (const std::exception& e) {
-        std::cerr << "[VAPIClient] Exception while joining thread: " << e.what() << std::endl;
-        try {
-          if (t.joinable()) {
-            t.detach();
-            detachedCount++;
-          }
-        } catch (...) {
-          std::cerr << "[VAPIClient] Failed to detach thread after join exception" << std::endl;
+void VAPIClient::watchConnection(const std::string &serverURI,
+                                 std::shared_ptr<KuksaClient::KuksaClient> c,
+                                 CancelToken cancel,
+                                 std::shared_ptr<ConnectionWatch> watch) {
+  // KuksaClient does not expose its channel state, so its connection flag is
+  // sampled here and transitions are pushed to the listeners.
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point lostAt;
+  Clock::time_point nextAttempt;
+  // failed stream opens are retried while connected, with the same backoff
+  Clock::time_point nextStreamRetry;
+  std::uint64_t     streamAttempts = 0;
+  {
+    std::lock_guard lock(watch->mtx);
+    watch->connected = c->isConnected();
+    // a failed first connect is recovered like a lost connection
+    if (!watch->connected) lostAt = Clock::now();
+  }
+
+  for (;;) {
+    bool attempt = false;
+    bool retryStreams = false;
+    {
+      std::unique_lock lock(watch->mtx);
+      watch->cv.wait_for(lock, WATCH_INTERVAL, [&] { return cancel->load() || watch->reconnectNow; });
+      if (cancel->load()) return;
+
+      const bool connected = c->isConnected();
+      const auto now = Clock::now();
+      if (connected != watch->connected) {
+        watch->connected = connected;
+        ConnectionStats &stats = watch->stats;
+        if (!connected) {
+          lostAt      = now;
+          nextAttempt = now + reconnectDelay(0);
+          stats.disconnects++;
+          stats.pendingAttempts = 0;
+        } else {
+          const double ms = std::chrono::duration<double, std::milli>(now - lostAt).count();
+          watch->totalRecoveryMs += ms;
+          watch->recoveries++;
+          stats.lastRecoveryMs = ms;
+          stats.maxRecoveryMs  = std::max(stats.maxRecoveryMs, ms);
+          stats.avgRecoveryMs  = watch->totalRecoveryMs / watch->recoveries;
+          std::cout << "[VAPIClient] Connection to " << serverURI << " restored after "
+                    << ms << " ms and " << stats.pendingAttempts << " attempt(s)" << std::endl;
+          stats.pendingAttempts = 0;
+          nextStreamRetry = now;
+          streamAttempts  = 0;
         }
+        lock.unlock();
+
+        // nothing keeps the cache up to date while disconnected; the streams
+        // refill it once KuksaClient has re-subscribed. Streams that never
+        // opened, e.g. after a failed first connect, are opened before the
+        // listeners hear that the server is back.
+        if (!connected) mCache_.invalidateAll(serverURI);
+        else if (reopenFailedStreams(serverURI)) nextStreamRetry = now + reconnectDelay(streamAttempts++);
+        notifyConnection(serverURI, connected);
+        continue;
+      }
+
+      if (!connected && (watch->reconnectNow || (watch->autoReconnect && now >= nextAttempt))) {
+        watch->reconnectNow = false;
+        watch->stats.reconnectAttempts++;
+        nextAttempt = now + reconnectDelay(++watch->stats.pendingAttempts);
+        attempt = true;
       }
+      watch->reconnectNow = false;
+      retryStreams = connected && now >= nextStreamRetry;
     }
 
-    std::cout << "[VAPIClient] Thread cleanup completed for " << kv.first
-              << " - joined: " << joinedCount << ", detached: " << detachedCount << std::endl;
+    if (attempt) {
+      try {
+        c->reconnect();
+      } catch (const std::exception &e) {
+        std::cerr << "[VAPIClient] Reconnect to " << serverURI << " failed: " << e.what() << std::endl;
+      }
+    }
 
-    entry.subThreads.clear();
-    // unique_ptr<KuksaClient> will be destroyed here
+    if (retryStreams) {
+      if (reopenFailedStreams(serverURI)) {
+        nextStreamRetry = Clock::now() + reconnectDelay(streamAttempts++);
+      } else {
+        streamAttempts = 0;
+      }
+    }
   }
+}
 
-  mClients_.clear();
-  std::cout << "[VAPIClient] Shutdown completed" << std::endl;
+void VAPIClient::startWorkerLocked(ClientEntry &entry, std::function<void()> body) {
+  // forget the workers that are done, e.g. the stream openers of earlier
+  // subscriptions, so the list does not grow with every call
+  auto &workers = entry.workers;
+  workers.erase(std::remove_if(workers.begin(), workers.end(), [](Worker &w) {
+    {
+      std::lock_guard lock(w.state->mtx);
+      if (!w.state->finished) return false;
+    }
+    w.thread.join();
+    return true;
+  }), workers.end());
+
+  workers.push_back(startWorker(std::move(body)));
 }
 
-void VAPIClient::shutdownAsync() {
-  std::cout << "[VAPIClient] Starting async shutdown..." << std::endl;
+VAPIClient::Worker VAPIClient::startWorker(std::function<void()> body) {
+  Worker worker;
+  worker.state  = std::make_shared<Worker::State>();
+  worker.thread = std::thread([state = worker.state, body = std::move(body)]() {
+    try {
+      body();
+    } catch (const std::exception &e) {
+      std::cerr << "[VAPIClient] Worker failed: " << e.what() << std::endl;
+    }
+    {
+      std::lock_guard lock(state->mtx);
+      state->finished = true;
+    }
+    state->cv.notify_all();
+  });
+  return worker;
+}
 
-  // Signal all clients to stop without blocking
+bool VAPIClient::joinOrDetach(Worker &worker, std::chrono::steady_clock::time_point deadline) {
+  bool finished;
   {
-    std::lock_guard lock(mClientsMtx_);
-    for (auto &kv : mClients_) {
-      auto &entry = kv.second;
+    std::unique_lock lock(worker.state->mtx);
+    finished = worker.state->cv.wait_until(lock, deadline, [&worker] { return worker.state->finished; });
+  }
+  if (finished) {
+    worker.thread.join();
+  } else {
+    // it only holds its own references and ends with its current request
+    worker.thread.detach();
+  }
+  return finished;
+}
 
-      // Just signal shutdown to KuksaClient instances
-      // They will handle their own thread cleanup in their destructors
-      if (entry.client) {
-        std::cout << "[VAPIClient] Signaling async shutdown for " << kv.first << std::endl;
-      }
+void VAPIClient::stopClients(std::chrono::steady_clock::time_point deadline) {
+  std::unordered_map<std::string, ClientEntry> clients;
+  {
+    std::lock_guard lock(mClientsMtx_);
+    clients.swap(mClients_);
+  }
 
-      // Detach all subscription threads immediately - don't wait
-      std::cout << "[VAPIClient] Detaching " << entry.subThreads.size()
-                << " subscription threads for " << kv.first << std::endl;
+  // cancel everything at once: workers stop at their next request and the
+  // streams stop dispatching
+  for (auto &kv : clients) {
+    kv.second.cancel->store(true);
+    {
+      // the watcher checks the token under this lock
+      std::lock_guard lock(kv.second.watch->mtx);
+    }
+    kv.second.watch->cv.notify_all();
+  }
+  {
+    std::unique_lock routesLock(mRoutesMtx_);
+    mSubscriptions_.clear();
+    mRoutes_.clear();
+  }
+  mCache_.invalidateAll();
 
-      for (auto &t : entry.subThreads) {
-        try {
-          if (t.joinable()) {
-            t.detach();
-          }
-        } catch (const std::exception& e) {
-          std::cerr << "[VAPIClient] Exception while detaching thread: " << e.what() << std::endl;
-        }
-      }
-      entry.subThreads.clear();
+  // Destroying a KuksaClient stops its streams and its reconnect thread;
+  // the clients are released in parallel, each one by a worker of its own,
+  // and destroyed by whichever worker drops the last reference.
+  std::vector<Worker> workers;
+  for (auto &kv : clients) {
+    auto &entry = kv.second;
+    if (entry.client) {
+      entry.client->setAutoReconnect(false);
+      startWorkerLocked(entry, [client = std::move(entry.client)]() mutable {
+        client.reset();
+      });
     }
+    for (auto &w : entry.workers) workers.push_back(std::move(w));
+  }
+
+  // one deadline for all of them
+  std::size_t joinedCount = 0;
+  std::size_t detachedCount = 0;
+  for (auto &w : workers) {
+    if (joinOrDetach(w, deadline)) joinedCount++;
+    else                           detachedCount++;
   }
 
+  std::cout << "[VAPIClient] Stopped " << clients.size() << " client(s)"
+            << " - joined: " << joinedCount << ", detached: " << detachedCount << std::endl;
+}
+
+void VAPIClient::shutdown() {
+  std::cout << "[VAPIClient] Shutting down all clients and threads..." << std::endl;
+
+  // the writer and the publishers use the clients, stop them before they go
+  // away; all of them share one deadline
+  const auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_GRACE;
+  closePublishers();
+  stopWriter(deadline);
+  stopClients(deadline);
+  mRecorder_.stop();
+
+  std::cout << "[VAPIClient] Shutdown completed" << std::endl;
+}
+
+void VAPIClient::shutdownAsync() {
+  std::cout << "[VAPIClient] Starting async shutdown..." << std::endl;
+
+  closePublishers();
+  const auto now = std::chrono::steady_clock::now();
+  stopWriter(now);
+  stopClients(now);
+  mRecorder_.stop();
+
   std::cout << "[VAPIClient] Async shutdown completed" << std::endl;
 }
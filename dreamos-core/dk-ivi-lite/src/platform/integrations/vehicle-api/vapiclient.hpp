@@ -9,14 +9,26 @@
 #define VAPI_CLIENT_HPP
 
 #include "KuksaClient.hpp"
+#include "signalcache.hpp"
+#include "signalpublisher.hpp"
+#include "signalrecorder.hpp"
 #include <memory>
 #include <string>
 #include <vector>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
+#include <array>
+#include <set>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <map>
+#include <atomic>
+#include <future>
 #include <optional>
+#include <chrono>
 #include <iostream>
 
 // Define VAPI server names for consistency across your project.
@@ -33,6 +45,16 @@ using SubscribeCallback =
                      const std::string &value,
                      const int &field)>;
 
+// Callback of the handle based subscribe(): the path is identified by its
+// interned SignalHandle, see SignalRegistry.
+using SignalCallback =
+  std::function<void(SignalHandle signal,
+                     const std::string &value,
+                     int field)>;
+
+// Handle returned by VAPIClient::subscribe(), 0 means "no subscription".
+using SubscriptionId = std::uint64_t;
+
 //----------------------------------------------------------------------
 // VAPIClient: singleton  
 //----------------------------------------------------------------------  
@@ -56,11 +78,13 @@ public:
                       const std::string &path,
                       std::string       &outValue);
 
-  // Templated conversions
+  // Templated conversions. Subscribed paths are served from the local
+  // shadow cache; the databroker is only asked when no fresh value is cached.
   template<typename T>
   bool getCurrentValueAs(const std::string &serverURI,
                          const std::string &path,
                          T                  &out) {
+    if (mCache_.getAs(serverURI, path, KuksaClient::FT_VALUE, out)) return true;
     auto *c = findClient(serverURI);
     return c ? c->getCurrentValueAs<T>(path, out) : false;
   }
@@ -69,16 +93,40 @@ public:
   bool getTargetValueAs(const std::string &serverURI,
                         const std::string &path,
                         T                  &out) {
+    if (mCache_.getAs(serverURI, path, KuksaClient::FT_ACTUATOR_TARGET, out)) return true;
     auto *c = findClient(serverURI);
     return c ? c->getTargetValueAs<T>(path, out) : false;
   }
 
+  // Cache-only read, never blocks on the network.
+  bool getCachedValue(const std::string &serverURI,
+                      const std::string &path,
+                      int                field,
+                      SignalValue       &out,
+                      SignalCache::Clock::duration maxAge = SignalCache::Clock::duration::zero()) const {
+    return mCache_.get(serverURI, path, field, out, maxAge);
+  }
+
+  bool getCachedValue(const std::string &serverURI,
+                      SignalHandle       signal,
+                      int                field,
+                      SignalValue       &out,
+                      SignalCache::Clock::duration maxAge = SignalCache::Clock::duration::zero()) const {
+    return mCache_.get(serverURI, signal, field, out, maxAge);
+  }
+
   template<typename T>
   bool setCurrentValue(const std::string &serverURI,
                        const std::string &path,
                        const T           &newValue) {
     auto *c = findClient(serverURI);
     if (!c) return false;
+    // the cached value is outdated until the stream confirms the write
+    mCache_.invalidate(serverURI, path, KuksaClient::FT_VALUE);
+    if (mRecorder_.active()) {
+      mRecorder_.record(SignalLog::RT_WRITE, SIGNAL_REGISTRY.intern(path),
+                        KuksaClient::FT_VALUE, SignalCache::from(newValue));
+    }
     c->setCurrentValue<T>(path, newValue);
     return true;
   }
@@ -89,12 +137,148 @@ public:
                       const T           &newValue) {
     auto *c = findClient(serverURI);
     if (!c) return false;
+    mCache_.invalidate(serverURI, path, KuksaClient::FT_ACTUATOR_TARGET);
+    if (mRecorder_.active()) {
+      mRecorder_.record(SignalLog::RT_WRITE, SIGNAL_REGISTRY.intern(path),
+                        KuksaClient::FT_ACTUATOR_TARGET, SignalCache::from(newValue));
+    }
     c->setTargetValue<T>(path, newValue);
     return true;
   }
 
+  // Current and target value of a set of signals, see snapshotAsync().
+  // A value the databroker does not have is std::monostate.
+  struct SnapshotEntry {
+    SignalHandle signal;
+    SignalValue  current;
+    SignalValue  target;
+  };
+  using Snapshot = std::vector<SnapshotEntry>;
+
+  // Fetch current and target values of all signals off the caller's thread.
+  // Values already in the shadow cache are taken from there, the rest is
+  // read from the databroker by up to SNAPSHOT_READERS threads. onDone is
+  // called on the fetching thread once the snapshot is complete.
+  static constexpr std::size_t SNAPSHOT_READERS = 4;
+  std::future<Snapshot> snapshotAsync(const std::string               &serverURI,
+                                      const std::vector<SignalHandle> &handles,
+                                      std::function<void(const Snapshot &)> onDone = nullptr);
+  std::future<Snapshot> snapshotAsync(const std::string               &serverURI,
+                                      const std::vector<std::string>  &paths,
+                                      std::function<void(const Snapshot &)> onDone = nullptr);
+
+  // A set of writes applied together by setValuesAsync(). Values keep their
+  // C++ type, which decides the databroker datatype exactly as with
+  // setCurrentValue<T>()/setTargetValue<T>().
+  class WriteBatch {
+  public:
+    template<typename T>
+    WriteBatch& setCurrent(const std::string &path, const T &value) {
+      return add(path, value, KuksaClient::FT_VALUE);
+    }
+
+    template<typename T>
+    WriteBatch& setTarget(const std::string &path, const T &value) {
+      return add(path, value, KuksaClient::FT_ACTUATOR_TARGET);
+    }
+
+    // current and target value at once, the usual actuator write
+    template<typename T>
+    WriteBatch& set(const std::string &path, const T &value) {
+      setCurrent(path, value);
+      return setTarget(path, value);
+    }
+
+    bool empty() const { return mEntries_.empty(); }
+    std::size_t size() const { return mEntries_.size(); }
+
+  private:
+    friend class VAPIClient;
+
+    struct Entry {
+      SignalHandle signal;
+      int          field;
+      SignalValue  value;   // for the recorder
+      std::function<void(KuksaClient::KuksaClient &)> write;
+    };
+
+    template<typename T>
+    WriteBatch& add(const std::string &path, const T &value, int field) {
+      mEntries_.push_back({SIGNAL_REGISTRY.intern(path), field, SignalCache::from(value),
+        [path, value, field](KuksaClient::KuksaClient &c) {
+          if (field == KuksaClient::FT_ACTUATOR_TARGET) c.setTargetValue<T>(path, value);
+          else                                          c.setCurrentValue<T>(path, value);
+        }});
+      return *this;
+    }
+
+    std::vector<Entry> mEntries_;
+  };
+
+  // Apply all writes of the batch on the VAPIClient writer thread, never
+  // blocking the caller. The future (and onDone) reports whether every
+  // write was handed to the databroker; the written values themselves come
+  // back through the subscriptions. onDone normally runs on the writer
+  // thread, but an empty batch or a batch arriving after shutdown completes
+  // inline: onDone then runs on the caller's thread before setValuesAsync()
+  // returns, so it must not take locks the caller holds.
+  //
+  // Writes are latest-wins per (signal, field): a value still pending when
+  // a newer one arrives is dropped and its batch completes with the newer
+  // write. See setMaxWriteRate().
+  std::future<bool> setValuesAsync(const std::string          &serverURI,
+                                   WriteBatch                  batch,
+                                   std::function<void(bool)>   onDone = nullptr);
+
+  // Limit how often a signal is written to the databroker; writes arriving
+  // faster are coalesced. 0 (the default) means no limit.
+  void setMaxWriteRate(const std::string &path, double writesPerSecond);
+
+  struct WriteStats {
+    std::uint64_t requested = 0;   // writes queued by setValuesAsync()
+    std::uint64_t applied   = 0;   // writes handed to the databroker
+    std::uint64_t coalesced = 0;   // writes dropped in favour of a newer value
+    std::uint64_t failed    = 0;   // writes that threw or had no client
+    double        avgLatencyMs = 0.0; // queued -> databroker call returned
+    double        maxLatencyMs = 0.0;
+  };
+
+  // Write metrics of one signal, or of all signals.
+  WriteStats writeStats(const std::string &path) const;
+  WriteStats writeStats() const;
+
+  // Open a persistent publish stream to a server for signals written at a
+  // high rate, see SignalPublisher. Publishers still open are closed on
+  // shutdown.
+  std::shared_ptr<SignalPublisher> openPublisher(const std::string        &serverURI,
+                                                 SignalPublisher::Options  options = SignalPublisher::Options());
+
+  // Batched subscription for a whole signal set and one field type
+  // (KuksaClient::FT_VALUE or KuksaClient::FT_ACTUATOR_TARGET).
+  // Every (signal, field) is streamed from the databroker only once, no matter
+  // how many subscribers share it; updates are demultiplexed to the callbacks
+  // registered for that signal. A stream that fails to open is opened again
+  // by the connection watcher, with the reconnect backoff, while the server
+  // is connected. Returns 0 on failure.
+  SubscriptionId subscribe(const std::string               &serverURI,
+                           const std::vector<SignalHandle> &handles,
+                           int                              field,
+                           SignalCallback                   callback);
+
+  // Same for paths, interned on the way in.
+  SubscriptionId subscribe(const std::string               &serverURI,
+                           const std::vector<std::string> &paths,
+                           int                             field,
+                           SubscribeCallback               callback);
+
+  // Add/remove signals of an existing subscription without tearing it down.
+  bool addSignals(SubscriptionId id, const std::vector<SignalHandle> &handles);
+  bool removeSignals(SubscriptionId id, const std::vector<SignalHandle> &handles);
+  bool addPaths(SubscriptionId id, const std::vector<std::string> &paths);
+  bool removePaths(SubscriptionId id, const std::vector<std::string> &paths);
+  void unsubscribe(SubscriptionId id);
+
   // Subscribe to *current* value updates for a list of paths.
-  // Each subscription runs in its own thread.
   bool subscribeCurrent(const std::string               &serverURI,
                         const std::vector<std::string> &paths,
                         SubscribeCallback               callback);
@@ -104,16 +288,57 @@ public:
                        const std::vector<std::string> &paths,
                        SubscribeCallback               callback);
 
-  // Blocks/destroys all subscription threads and clients.
+  // Cancels every stream, worker and the writer at once and destroys the
+  // clients, waiting at most SHUTDOWN_GRACE for all of them together.
   void shutdown();
 
-  // Non-blocking shutdown suitable for Qt application termination
+  // Same, but does not wait: suitable for Qt application termination
   void shutdownAsync();
 
+  static constexpr std::chrono::milliseconds SHUTDOWN_GRACE{100};
+
+  // Capture every subscription update and every write into a signal log,
+  // see SignalRecorder. Recording stops on shutdown.
+  bool startRecording(const std::string &file);
+  void stopRecording();
+
+  // Deliver a value to the cache and the subscribers of a signal as if the
+  // databroker had sent it, see SignalReplayer.
+  void injectUpdate(const std::string &serverURI, SignalHandle signal,
+                    int field, const std::string &value);
+
   // Connection status and control
   bool isConnected(const std::string &serverURI) const;
+  // With auto-reconnect the watcher of the server retries a lost connection
+  // with exponential backoff and jitter. KuksaClient's own reconnect stays
+  // off either way.
   void setAutoReconnect(const std::string &serverURI, bool enabled);
+  // Blocking reconnect on the caller's thread.
   bool forceReconnect(const std::string &serverURI);
+  // Let the watcher retry now instead of at its next backoff step.
+  void requestReconnect(const std::string &serverURI);
+
+  // Connection state transitions of a server, pushed by its watcher within
+  // WATCH_INTERVAL of the change. Callbacks run on the watcher thread.
+  using ConnectionCallback = std::function<void(bool connected)>;
+  using ListenerId         = std::uint64_t;
+  ListenerId addConnectionListener(const std::string &serverURI, ConnectionCallback callback);
+  void removeConnectionListener(ListenerId id);
+
+  struct ConnectionStats {
+    std::uint64_t disconnects       = 0;
+    std::uint64_t reconnectAttempts = 0;   // all attempts of the watcher
+    std::uint64_t pendingAttempts   = 0;   // attempts of the current outage
+    double        lastRecoveryMs    = 0.0; // connection lost -> restored
+    double        avgRecoveryMs     = 0.0;
+    double        maxRecoveryMs     = 0.0;
+  };
+  ConnectionStats connectionStats(const std::string &serverURI) const;
+
+  static constexpr std::chrono::milliseconds WATCH_INTERVAL{50};
+  static constexpr std::chrono::milliseconds STREAM_OPEN_PACING{20};
+  static constexpr std::chrono::milliseconds RECONNECT_BASE_DELAY{500};
+  static constexpr std::chrono::milliseconds RECONNECT_MAX_DELAY{30000};
 
 private:
   VAPIClient();
@@ -125,15 +350,162 @@ private:
   // internal helper
   KuksaClient::KuksaClient* findClient(const std::string &serverURI);
   KuksaClient::KuksaClient* findClient(const std::string &serverURI) const;
+  std::shared_ptr<KuksaClient::KuksaClient> clientRef(const std::string &serverURI);
+
+  // Set once when the client of a server is stopped; checked by its stream
+  // callbacks and by its workers between two requests.
+  using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
+  // Thread working for one server (stream opening, snapshots). It holds its
+  // own reference to the client and reports its end, so shutdown can wait
+  // for all workers with a single deadline instead of joining one by one.
+  struct Worker {
+    struct State {
+      std::mutex              mtx;
+      std::condition_variable cv;
+      bool                    finished = false;
+    };
+    std::thread            thread;
+    std::shared_ptr<State> state;
+  };
+
+  // state of one server shared with its connection watcher
+  struct ConnectionWatch {
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    autoReconnect  = false;
+    bool                    reconnectNow   = false;
+    bool                    connected      = false;
+    ConnectionStats         stats;
+    double                  totalRecoveryMs = 0.0;
+    std::uint64_t           recoveries      = 0;
+  };
 
   // one entry per connected server
   struct ClientEntry {
-    std::unique_ptr<KuksaClient::KuksaClient> client;
-    std::vector<std::thread>                  subThreads;
+    std::shared_ptr<KuksaClient::KuksaClient> client;
+    CancelToken                               cancel = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<ConnectionWatch>          watch  = std::make_shared<ConnectionWatch>();
+    std::vector<Worker>                       workers;
+  };
+
+  // Demultiplexing tables of one server. A route list is replaced, never
+  // modified in place, so dispatch() only holds the lock to copy a pointer.
+  using CallbackPtr = std::shared_ptr<const SignalCallback>;
+  using RouteList   = std::shared_ptr<const std::vector<CallbackPtr>>;
+  struct ServerRoutes {
+    // index 0: FT_VALUE, index 1: FT_ACTUATOR_TARGET; routes are indexed by handle
+    std::array<std::vector<RouteList>, 2>             routes;
+    std::array<std::unordered_set<SignalHandle>, 2> openStreams;
+    // streams whose opening failed; they stay in openStreams and are opened
+    // again by the connection watcher, see reopenFailedStreams()
+    std::array<std::unordered_set<SignalHandle>, 2> failedStreams;
   };
 
+  struct Subscription {
+    std::string            serverURI;
+    int                    field;
+    CallbackPtr            callback;
+    std::set<SignalHandle> handles;
+  };
+
+  static std::size_t fieldIndex(int field);
+  static std::vector<SignalHandle> internPaths(const std::vector<std::string> &paths);
+  SignalValue fetchValue(KuksaClient::KuksaClient *c, const std::string &serverURI,
+                         SignalHandle signal, int field);
+  void addRoutesLocked(ServerRoutes &routes, Subscription &sub,
+                       const std::vector<SignalHandle> &handles,
+                       std::vector<SignalHandle> &newStreams);
+  void removeRoutesLocked(ServerRoutes &routes, Subscription &sub,
+                          const std::vector<SignalHandle> &handles);
+  void openStreams(const std::string &serverURI, ServerRoutes *routes,
+                   std::vector<SignalHandle> handles, int field);
+  void dispatch(ServerRoutes *routes, const CancelToken &cancel, SignalHandle signal,
+                const std::string &value, int field);
+  void markStreamsFailed(const std::string &serverURI, const std::vector<SignalHandle> &handles,
+                         int field);
+  bool reopenFailedStreams(const std::string &serverURI);
+
+  static Worker startWorker(std::function<void()> body);
+  static void startWorkerLocked(ClientEntry &entry, std::function<void()> body);
+  // joins the worker if it ends before the deadline, detaches it otherwise
+  static bool joinOrDetach(Worker &worker, std::chrono::steady_clock::time_point deadline);
+  void startWatcherLocked(const std::string &serverURI, ClientEntry &entry);
+  void watchConnection(const std::string &serverURI,
+                       std::shared_ptr<KuksaClient::KuksaClient> c,
+                       CancelToken cancel,
+                       std::shared_ptr<ConnectionWatch> watch);
+  void notifyConnection(const std::string &serverURI, bool connected);
+  static std::chrono::milliseconds reconnectDelay(std::uint64_t attempt);
+  void stopClients(std::chrono::steady_clock::time_point deadline);
+
+  // Writer thread of setValuesAsync(), started on first use.
+  using WriteClock = std::chrono::steady_clock;
+
+  // completion of one setValuesAsync() call
+  struct BatchState {
+    std::promise<bool>        done;
+    std::function<void(bool)> onDone;
+    // the writer and stopWriter() may finish entries of the same batch
+    std::atomic<std::size_t>  remaining{0};
+    std::atomic<bool>         ok{true};
+  };
+  using BatchStatePtr = std::shared_ptr<BatchState>;
+
+  struct WriteKey {
+    std::string  serverURI;
+    SignalHandle signal;
+    int          field;
+    bool operator<(const WriteKey &o) const {
+      if (signal != o.signal) return signal < o.signal;
+      if (field != o.field) return field < o.field;
+      return serverURI < o.serverURI;
+    }
+  };
+
+  // newest value of a key, waiting for its signal's rate limit
+  struct PendingWrite {
+    std::function<void(KuksaClient::KuksaClient &)> write;
+    WriteClock::time_point                          queued;
+    std::vector<BatchStatePtr>                      waiters;
+  };
+
+  struct SignalWriteState {
+    WriteClock::duration   minInterval = WriteClock::duration::zero();
+    WriteClock::time_point lastApplied;
+    WriteStats             stats;
+    double                 totalLatencyMs = 0.0;
+  };
+
+  void writerLoop();
+  void stopWriter(std::chrono::steady_clock::time_point deadline);
+  void closePublishers();
+  static void finishWaiters(std::vector<BatchStatePtr> &waiters, bool ok);
+
   std::unordered_map<std::string, ClientEntry> mClients_;
   std::mutex                                  mClientsMtx_;
+
+  std::unordered_map<std::string, ServerRoutes>   mRoutes_;
+  std::unordered_map<SubscriptionId, Subscription> mSubscriptions_;
+  SubscriptionId                                  mNextSubscriptionId_{1};
+  mutable std::shared_mutex                       mRoutesMtx_;
+
+  mutable SignalCache                             mCache_;
+  SignalRecorder                                  mRecorder_;
+
+  std::unordered_map<ListenerId, std::pair<std::string, ConnectionCallback>> mConnListeners_;
+  ListenerId                                      mNextListenerId_{1};
+  std::mutex                                      mConnMtx_;
+
+  std::vector<std::weak_ptr<SignalPublisher>>          mPublishers_;
+  std::mutex                                           mPublishersMtx_;
+
+  Worker                                               mWriter_;
+  std::map<WriteKey, PendingWrite>                     mPendingWrites_;
+  std::unordered_map<SignalHandle, SignalWriteState>  mWriteState_;
+  mutable std::mutex                                   mWriteMtx_;
+  std::condition_variable                              mWriteCv_;
+  bool                                                 mWriterStop_{false};
 };
 
 // convenience macro
@@ -0,0 +1,308 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#include "vsssignalmodel.hpp"
+#include "signaldispatcher.hpp"
+#include <QDebug>
+#include <QMetaObject>
+#include <QPointer>
+#include <limits>
+#include <type_traits>
+
+namespace {
+  template<typename T>
+  bool toNumber(const QVariant &value, T &out) {
+    bool ok = false;
+    if constexpr (std::is_same_v<T, bool>) {
+      out = value.toBool();
+      return true;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      out = static_cast<T>(value.toDouble(&ok));
+      return ok;
+    } else if constexpr (std::is_signed_v<T>) {
+      const qlonglong v = value.toLongLong(&ok);
+      if (!ok || v < std::numeric_limits<T>::min() || v > std::numeric_limits<T>::max()) return false;
+      out = static_cast<T>(v);
+      return true;
+    } else {
+      if (value.toDouble() < 0) return false;
+      const qulonglong v = value.toULongLong(&ok);
+      if (!ok || v > std::numeric_limits<T>::max()) return false;
+      out = static_cast<T>(v);
+      return true;
+    }
+  }
+
+  template<typename T>
+  bool addTyped(VAPIClient::WriteBatch &batch, const std::string &path,
+                const QVariant &value, bool target) {
+    T typed{};
+    if (!toNumber(value, typed)) return false;
+    if (target) batch.setTarget<T>(path, typed);
+    else        batch.setCurrent<T>(path, typed);
+    return true;
+  }
+}
+
+VssSignalModel::VssSignalModel(QObject *parent)
+  : QAbstractListModel(parent)
+  , m_serverURI(DK_VAPI_DATABROKER)
+  , m_active(true)
+  , m_syncPending(false)
+  , m_dispatcher(nullptr)
+  , m_currentId(0)
+  , m_targetId(0) {
+}
+
+VssSignalModel::~VssSignalModel() {
+  unsubscribe();
+}
+
+int VssSignalModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+QVariant VssSignalModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() < 0 || index.row() >= count()) return {};
+  const Row &row = m_rows[index.row()];
+  switch (role) {
+    case PathRole:      return row.path;
+    case ValueRole:     return row.value;
+    case TargetRole:    return row.target;
+    case AvailableRole: return row.value.isValid();
+    default:            return {};
+  }
+}
+
+bool VssSignalModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+  if (!index.isValid() || index.row() < 0 || index.row() >= count()) return false;
+  if (role != ValueRole && role != TargetRole) return false;
+  // the row itself changes once the databroker confirms the write
+  return writeRow(m_rows[index.row()], value, role == TargetRole);
+}
+
+Qt::ItemFlags VssSignalModel::flags(const QModelIndex &index) const {
+  return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QHash<int, QByteArray> VssSignalModel::roleNames() const {
+  return {
+    {PathRole,      "path"},
+    {ValueRole,     "value"},
+    {TargetRole,    "target"},
+    {AvailableRole, "available"}
+  };
+}
+
+QStringList VssSignalModel::paths() const {
+  QStringList list;
+  for (const Row &row : m_rows) list << row.path;
+  return list;
+}
+
+void VssSignalModel::setPaths(const QStringList &paths) {
+  if (paths == this->paths()) return;
+
+  // the dispatcher's signal set is fixed, a new one is created on sync
+  unsubscribe();
+
+  beginResetModel();
+  m_rows.clear();
+  m_rowOf.clear();
+  for (const QString &path : paths) {
+    SignalHandle signal = SIGNAL_REGISTRY.intern(path.toStdString());
+    if (signal == INVALID_SIGNAL) {
+      qWarning() << "VssSignalModel: cannot register signal" << path;
+      continue;
+    }
+    if (signal < m_rowOf.size() && m_rowOf[signal] >= 0) continue;
+
+    if (m_rowOf.size() <= signal) m_rowOf.resize(signal + 1, -1);
+    m_rowOf[signal] = static_cast<int>(m_rows.size());
+    Row row;
+    row.path   = path;
+    row.signal = signal;
+    m_rows.push_back(row);
+  }
+  endResetModel();
+
+  emit pathsChanged();
+  scheduleSync();
+}
+
+QVariantMap VssSignalModel::types() const {
+  return m_types;
+}
+
+void VssSignalModel::setTypes(const QVariantMap &types) {
+  if (types == m_types) return;
+  m_types = types;
+  emit typesChanged();
+}
+
+bool VssSignalModel::active() const {
+  return m_active;
+}
+
+void VssSignalModel::setActive(bool active) {
+  if (active == m_active) return;
+  m_active = active;
+  emit activeChanged();
+  scheduleSync();
+}
+
+int VssSignalModel::count() const {
+  return static_cast<int>(m_rows.size());
+}
+
+void VssSignalModel::scheduleSync() {
+  // QML assigns the properties one by one while creating the model; the
+  // subscription follows their final values only
+  if (m_syncPending) return;
+  m_syncPending = true;
+  QMetaObject::invokeMethod(this, &VssSignalModel::sync, Qt::QueuedConnection);
+}
+
+void VssSignalModel::sync() {
+  m_syncPending = false;
+  if (m_active && !m_rows.empty()) subscribe();
+  else                             unsubscribe();
+}
+
+void VssSignalModel::subscribe() {
+  if (m_dispatcher) return;
+
+  std::vector<SignalHandle> handles;
+  handles.reserve(m_rows.size());
+  for (const Row &row : m_rows) handles.push_back(row.signal);
+
+  m_dispatcher = new SignalDispatcher(m_serverURI, handles, this);
+  connect(m_dispatcher, &SignalDispatcher::valueChanged,
+          this, &VssSignalModel::onValueChanged);
+
+  m_currentId = VAPI_CLIENT.subscribe(m_serverURI, handles, KuksaClient::FT_VALUE,
+                                      m_dispatcher->callback());
+  m_targetId  = VAPI_CLIENT.subscribe(m_serverURI, handles, KuksaClient::FT_ACTUATOR_TARGET,
+                                      m_dispatcher->callback());
+  if (!m_currentId || !m_targetId) {
+    qWarning() << "VssSignalModel: cannot subscribe to" << QString::fromStdString(m_serverURI);
+  }
+
+  // rows hidden so far may be outdated
+  m_dispatcher->requestSnapshot();
+}
+
+void VssSignalModel::unsubscribe() {
+  if (!m_dispatcher) return;
+
+  VAPI_CLIENT.unsubscribe(m_targetId);
+  VAPI_CLIENT.unsubscribe(m_currentId);
+  m_targetId  = 0;
+  m_currentId = 0;
+
+  // A stream still inside the callback only touches the state the callback
+  // shares, so the dispatcher may go at once; deleteLater() only protects a
+  // valueChanged() emission that led here.
+  m_dispatcher->disconnect(this);
+  m_dispatcher->deleteLater();
+  m_dispatcher = nullptr;
+}
+
+void VssSignalModel::onValueChanged(SignalHandle signal, int field, const SignalValue &value) {
+  if (signal >= m_rowOf.size() || m_rowOf[signal] < 0) return;
+  const int idx = m_rowOf[signal];
+  Row &row = m_rows[idx];
+
+  const QVariant v = toVariant(value);
+  QList<int> roles;
+  if (field == KuksaClient::FT_ACTUATOR_TARGET) {
+    if (row.target == v) return;
+    row.target = v;
+    roles << TargetRole;
+  } else {
+    if (row.value == v) return;
+    if (row.value.isValid() != v.isValid()) roles << AvailableRole;
+    row.value = v;
+    roles << ValueRole;
+  }
+
+  const QModelIndex i = index(idx);
+  emit dataChanged(i, i, roles);
+}
+
+bool VssSignalModel::write(const QString &path, const QVariant &value, bool target) {
+  SignalHandle signal = SIGNAL_REGISTRY.find(path.toStdString());
+  if (signal < m_rowOf.size() && m_rowOf[signal] >= 0) {
+    return writeRow(m_rows[m_rowOf[signal]], value, target);
+  }
+
+  Row row;
+  row.path   = path;
+  row.signal = signal;
+  return writeRow(row, value, target);
+}
+
+bool VssSignalModel::writeRow(const Row &row, const QVariant &value, bool target) {
+  VAPIClient::WriteBatch batch;
+  if (!addWrite(batch, row, value, target)) {
+    qWarning() << "VssSignalModel: cannot write" << value << "to" << row.path;
+    emit writeFailed(row.path);
+    return false;
+  }
+
+  // called on the VAPIClient writer thread
+  QPointer<VssSignalModel> self(this);
+  const QString path = row.path;
+  VAPI_CLIENT.setValuesAsync(m_serverURI, std::move(batch), [self, path](bool ok) {
+    if (ok) return;
+    QMetaObject::invokeMethod(self, [self, path]() {
+      if (self) emit self->writeFailed(path);
+    }, Qt::QueuedConnection);
+  });
+  return true;
+}
+
+bool VssSignalModel::addWrite(VAPIClient::WriteBatch &batch, const Row &row,
+                              const QVariant &value, bool target) const {
+  const std::string path = row.path.toStdString();
+  const QString type = m_types.value(row.path).toString();
+
+  if (type == "bool")   return addTyped<bool>(batch, path, value, target);
+  if (type == "int8")   return addTyped<std::int8_t>(batch, path, value, target);
+  if (type == "uint8")  return addTyped<std::uint8_t>(batch, path, value, target);
+  if (type == "int16")  return addTyped<std::int16_t>(batch, path, value, target);
+  if (type == "uint16") return addTyped<std::uint16_t>(batch, path, value, target);
+  if (type == "int32")  return addTyped<std::int32_t>(batch, path, value, target);
+  if (type == "uint32") return addTyped<std::uint32_t>(batch, path, value, target);
+  if (type == "int64")  return addTyped<std::int64_t>(batch, path, value, target);
+  if (type == "uint64") return addTyped<std::uint64_t>(batch, path, value, target);
+  if (type == "float")  return addTyped<float>(batch, path, value, target);
+  if (type == "double") return addTyped<double>(batch, path, value, target);
+  if (!type.isEmpty())  return false; // KuksaClient cannot write strings
+
+  switch (value.metaType().id()) {
+    case QMetaType::Bool:      return addTyped<bool>(batch, path, value, target);
+    case QMetaType::Int:       return addTyped<std::int32_t>(batch, path, value, target);
+    case QMetaType::UInt:      return addTyped<std::uint32_t>(batch, path, value, target);
+    case QMetaType::LongLong:  return addTyped<std::int64_t>(batch, path, value, target);
+    case QMetaType::ULongLong: return addTyped<std::uint64_t>(batch, path, value, target);
+    case QMetaType::Float:     return addTyped<float>(batch, path, value, target);
+    case QMetaType::Double:    return addTyped<double>(batch, path, value, target);
+    default:                   return false;
+  }
+}
+
+QVariant VssSignalModel::toVariant(const SignalValue &value) {
+  return std::visit([](const auto &v) -> QVariant {
+    using V = std::decay_t<decltype(v)>;
+    if constexpr (std::is_same_v<V, std::monostate>)     return QVariant();
+    else if constexpr (std::is_same_v<V, std::string>)   return QString::fromStdString(v);
+    else if constexpr (std::is_same_v<V, std::int64_t>)  return QVariant::fromValue<qlonglong>(v);
+    else if constexpr (std::is_same_v<V, std::uint64_t>) return QVariant::fromValue<qulonglong>(v);
+    else                                                 return QVariant::fromValue(v);
+  }, value);
+}
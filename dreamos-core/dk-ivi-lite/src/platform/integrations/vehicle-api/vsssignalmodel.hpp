@@ -0,0 +1,119 @@
+// Copyright (c) 2025 Eclipse Foundation.
+//
+// This program and the accompanying materials are made available under the
+// terms of the MIT License which is available at
+// https://opensource.org/licenses/MIT.
+//
+// SPDX-License-Identifier: MIT
+#ifndef VSS_SIGNAL_MODEL_HPP
+#define VSS_SIGNAL_MODEL_HPP
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+#include <string>
+#include <vector>
+#include "vapiclient.hpp"
+
+class SignalDispatcher;
+
+//----------------------------------------------------------------------
+// VssSignalModel: QML list model over any set of VSS paths, one row per
+// path, so a page can show and write vehicle signals without C++ code:
+//
+//   VssSignalModel {
+//     id: lights
+//     active: page.visible
+//     paths: ["Vehicle.Body.Lights.Beam.Low.IsOn"]
+//   }
+//   Repeater { model: lights; delegate: Switch {
+//     checked: model.target === true
+//     onToggled: model.target = checked
+//   } }
+//
+// Rows are subscribed only while the model is active: each active model
+// holds one route per signal in the VAPIClient subscription hub, which
+// drops the updates of a signal nobody shows. Updates are coalesced once
+// per frame by a SignalDispatcher and only the roles whose value changed
+// are emitted. Writes go through VAPIClient::setValuesAsync(); a row
+// changes once the databroker confirms the write.
+//----------------------------------------------------------------------
+class VssSignalModel : public QAbstractListModel {
+  Q_OBJECT
+  Q_PROPERTY(QStringList paths READ paths WRITE setPaths NOTIFY pathsChanged)
+  Q_PROPERTY(QVariantMap types READ types WRITE setTypes NOTIFY typesChanged)
+  Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+  Q_PROPERTY(int count READ count NOTIFY pathsChanged)
+public:
+  enum Roles {
+    PathRole = Qt::UserRole + 1,
+    ValueRole,      // current value, writable
+    TargetRole,     // actuator target, writable
+    AvailableRole   // a current value is known
+  };
+
+  explicit VssSignalModel(QObject *parent = nullptr);
+  ~VssSignalModel() override;
+
+  // QAbstractListModel overrides
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+  Qt::ItemFlags flags(const QModelIndex &index) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  QStringList paths() const;
+  void setPaths(const QStringList &paths);
+
+  // VSS data type per path ("bool", "int8" ... "uint64", "float",
+  // "double"). The databroker only accepts values of the signal's type;
+  // paths without an entry are written with the type of the QML value.
+  QVariantMap types() const;
+  void setTypes(const QVariantMap &types);
+
+  bool active() const;
+  void setActive(bool active);
+
+  int count() const;
+
+  // Write a path from outside a delegate; target selects the field.
+  Q_INVOKABLE bool write(const QString &path, const QVariant &value, bool target = true);
+
+signals:
+  void pathsChanged();
+  void typesChanged();
+  void activeChanged();
+  void writeFailed(const QString &path);
+
+private:
+  struct Row {
+    QString      path;
+    SignalHandle signal = INVALID_SIGNAL;
+    QVariant     value;
+    QVariant     target;
+  };
+
+  void scheduleSync();
+  void sync();
+  void subscribe();
+  void unsubscribe();
+  void onValueChanged(SignalHandle signal, int field, const SignalValue &value);
+  bool writeRow(const Row &row, const QVariant &value, bool target);
+  bool addWrite(VAPIClient::WriteBatch &batch, const Row &row,
+                const QVariant &value, bool target) const;
+  static QVariant toVariant(const SignalValue &value);
+
+  std::string       m_serverURI;
+  std::vector<Row>  m_rows;
+  // signal handle -> row, -1 for signals of no interest
+  std::vector<int>  m_rowOf;
+  QVariantMap       m_types;
+  bool              m_active;
+  bool              m_syncPending;
+  SignalDispatcher *m_dispatcher;
+  SubscriptionId    m_currentId;
+  SubscriptionId    m_targetId;
+};
+
+#endif // VSS_SIGNAL_MODEL_HPP
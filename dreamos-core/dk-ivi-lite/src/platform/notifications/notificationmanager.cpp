@@ -113,10 +113,11 @@ QString NotificationManager::showNotification(const QString &title,
 QString NotificationManager::showProgress(const QString &title,
                                         const QString &message,
                                         int progress,
-                                        const QString &category)
+                                        const QString &category,
+                                        const QString &id)
 {
     NotificationData data;
-    data.id = generateId();
+    data.id = id.isEmpty() ? generateId() : id;
     data.title = title;
     data.message = message;
     data.level = NotificationLevel::Progress;
@@ -86,7 +86,8 @@ public:
     Q_INVOKABLE QString showProgress(const QString &title,
                                     const QString &message,
                                     int progress = 0,
-                                    const QString &category = "progress");
+                                    const QString &category = "progress",
+                                    const QString &id = QString());   // empty = generated
 
     Q_INVOKABLE void updateProgress(const QString &id, int progress, const QString &message = "");
     
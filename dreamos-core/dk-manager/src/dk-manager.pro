@@ -28,11 +28,18 @@ SOURCES += \
         dkmanager.cpp \
         fileutils.cpp \
         message_to_kit_handler.cpp \
+        payload_codec.cpp \
         prototype_utils.cpp \
         vcuorchestrator.cpp \
+        vssmapping_diff.cpp \
         main.cpp
 
-LIBS += -lsioclient_tls -lssl -lcrypto
+LIBS += -lsioclient_tls -lssl -lcrypto -lz
+# optional zstd support for reply compression
+packagesExist(libzstd) {
+    DEFINES += DK_HAVE_ZSTD
+    LIBS += -lzstd
+}
 #-lboost_random -lboost_system -lboost_date_time
 
 # Default rules for deployment.
@@ -46,4 +53,6 @@ HEADERS += \
     dkmanager.h \
     fileutils.h \
     message_to_kit_handler.h \
-    prototype_utils.h
+    payload_codec.h \
+    prototype_utils.h \
+    vssmapping_diff.h
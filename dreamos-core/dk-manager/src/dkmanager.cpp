@@ -1,6 +1,7 @@
 #include "dkmanager.h"
 #include "fileutils.h"
 #include "common_utils.h"
+#include "payload_codec.h"
 #include <QFile>
 #include <QDebug>
 #include <QThread>
@@ -134,6 +135,8 @@ void DkManger::OnReconnectingListener()
 {
     qDebug() << __func__ << __LINE__;
     isSocketConnected = false;
+    // the new session has to negotiate compression again
+    PayloadCodec::ResetNegotiation();
 }
 
 void DkManger::OnSocketCloseListener(std::string const &nsp)
@@ -303,7 +306,8 @@ void DkManger::OnConnected(std::string const &nsp)
     obj->get_map()["kit_id"] = string_message::create(serialNo.toStdString());
     obj->get_map()["name"] = string_message::create(serialNo.toStdString());
     obj->get_map()["support_apis"] = string_message::create(supportAPIs.toStdString());
-    _io->socket()->emit("register_kit", obj);
+    obj->get_map()["support_compression"] = PayloadCodec::SupportedCodecs();
+    _io->socket()->emit("register_kit", obj, &PayloadCodec::OnRegisterAck);
 
     isSocketConnected = true;
 }
@@ -2,11 +2,25 @@
 #include <QThread>
 #include <QDebug>
 #include "dkmanager.h"
+#include "payload_codec.h"
 
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
 
+    // dk_manager --bench-compression <file>... : measure reply compression on this target
+    QStringList args = a.arguments();
+    if (args.size() > 1 && args[1] == "--bench-compression")
+    {
+        if (args.size() < 3)
+        {
+            qWarning() << "usage:" << args[0] << "--bench-compression <file>...";
+            return 1;
+        }
+        PayloadCodec::RunBenchmark(args.mid(2));
+        return 0;
+    }
+
     qDebug() << "dk-manager verion 1.0.0 !!!";
 
     DkManger dkManager;
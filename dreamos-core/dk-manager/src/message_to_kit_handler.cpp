@@ -1,12 +1,15 @@
 #include "message_to_kit_handler.h"
 #include "fileutils.h"
 #include "common_utils.h"
+#include "payload_codec.h"
+#include "vssmapping_diff.h"
 #include <QFile>
 #include <QDebug>
 #include <QThread>
 #include <QCryptographicHash>
 #include <QMutex>
 #include <QFileInfo>
+#include <QElapsedTimer>
 #include <QtNetwork>
 
 #include <QJsonDocument>
@@ -43,6 +46,10 @@ extern QMutex digitalAutoPrototypeMutex;
 extern QMutex vssMappingMutex;
 extern QMutex vssMappingFactoryResetMutex;
 
+// duration of the last full runtime restart caused by a vss mapping, guarded by vssMappingMutex.
+// It starts with a typical value and is used to report the time saved by a smaller action.
+static qint64 lastFullVssMappingApplyMs = 30000;
+
 MessageToKitHandler::MessageToKitHandler(client *_io, message::ptr const &data, DkOrchestrator *orchestrator)
 {
     m_data = data;
@@ -253,8 +260,8 @@ void MessageToKitHandler::HandleListPrototype(message::ptr const &data)
 
     Obj->get_map()["request_from"] = string_message::create(request_from);
     Obj->get_map()["cmd"] = string_message::create(command);
-    Obj->get_map()["result"] = string_message::create(s_prototypes.toStdString());
-    Obj->get_map()["dapr_status"] = string_message::create(rawDaprRunStatus.toStdString());
+    PayloadCodec::SetField(Obj, "result", s_prototypes.toStdString());
+    PayloadCodec::SetField(Obj, "dapr_status", rawDaprRunStatus.toStdString());
     m_io->socket()->emit("messageToKit-kitReply", Obj);
 }
 
@@ -269,7 +276,7 @@ void MessageToKitHandler::GetSupportAPIs(message::ptr const &data)
 
     Obj->get_map()["request_from"] = string_message::create(request_from);
     Obj->get_map()["cmd"] = string_message::create(command);
-    Obj->get_map()["result"] = string_message::create(supportAPIs.toStdString());
+    PayloadCodec::SetField(Obj, "result", supportAPIs.toStdString());
     m_io->socket()->emit("messageToKit-kitReply", Obj);
 }
 
@@ -355,7 +362,7 @@ void MessageToKitHandler::HandleActionOnPrototype(message::ptr const &data)
     Obj->get_map()["request_from"] = string_message::create(request_from);
     Obj->get_map()["cmd"] = string_message::create(command);
     Obj->get_map()["action"] = string_message::create(action);
-    Obj->get_map()["result"] = string_message::create(s_result.toStdString());
+    PayloadCodec::SetField(Obj, "result", s_result.toStdString());
     m_io->socket()->emit("messageToKit-kitReply", Obj);
 }
 
@@ -377,6 +384,32 @@ typedef struct
     QStringList canChannels;
 } Vssmapping_Dbc_CanChannels_Struct;
 
+static QStringList dbcCanChannelKeys(const QList<Vssmapping_Dbc_CanChannels_Struct> &dbcCanList)
+{
+    QStringList keys;
+    for (const Vssmapping_Dbc_CanChannels_Struct &item : dbcCanList)
+    {
+        for (const QString &channel : item.canChannels)
+        {
+            keys.append(item.dbcName + ":" + channel);
+        }
+    }
+    keys.sort();
+    return keys;
+}
+
+// common end of every successful vss mapping deployment, whatever action it took
+static void finishVssMappingDeployment(QString &vssMappingInfo2Client)
+{
+    vssMappingInfo2Client += "Vss Mapping is deployed successfully !!!\n";
+
+    qDebug() << "Vss Mapping is deployed successfully !!!";
+
+    // make sure data is written to files.
+    system("sync");
+    QThread::msleep(50);
+}
+
 bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &vssMappingInfo2Client)
 {
     vssMappingMutex.lock();
@@ -416,6 +449,7 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
                 }
             }
         }
+        const QStringList prevDbcCanChannels = dbcCanChannelKeys(dbcCanList);
 
         {
             // save vss mapping configuration
@@ -504,8 +538,13 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
             vssmappingFile.close();
         }
 
-        // save dbc file
+        // keep the previous feeder inputs and overlay to compute the mapping diff later
         std::string dbcFile = DK_VSSMAPPING_FOLDER + dbcFileName;
+        const QString prevDbcContent = FileUtils::ReadFile(QString::fromStdString(dbcFile));
+        const QString prevDbcDefaultValues = FileUtils::ReadFile(QString::fromStdString(DK_DBCDEFAULT_VALUES));
+        const QString prevOverlayContent = FileUtils::ReadFile(QString::fromStdString(DK_VSSOVERLAY_VSPECS));
+
+        // save dbc file
         {
             QFile file(QString::fromStdString(dbcFile));
             if (!file.open(QIODevice::ReadWrite | QIODevice::Text))
@@ -839,6 +878,29 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
             QThread::msleep(50);
         }
 
+        // compare the previous and the new mapping to pick the minimal runtime action
+        bool feederInputsChanged = (prevDbcContent != QString::fromStdString(payload)) ||
+                                   (prevDbcDefaultValues != FileUtils::ReadFile(QString::fromStdString(DK_DBCDEFAULT_VALUES))) ||
+                                   (prevDbcCanChannels != dbcCanChannelKeys(dbcCanList));
+        VssMappingDiff mappingDiff;
+        mappingDiff.Compute(prevOverlayContent, FileUtils::ReadFile(QString::fromStdString(DK_VSSOVERLAY_VSPECS)),
+                            feederInputsChanged, IsVehicleDatabrokerRunning());
+        VssMappingDiff::Action action = mappingDiff.GetAction();
+        qDebug() << mappingDiff.Summary();
+        QElapsedTimer applyTimer;
+        applyTimer.start();
+
+        if (action == VssMappingDiff::ActionNone)
+        {
+            vssMappingInfo2Client += "Vss Mapping is unchanged, runtime environment is kept running.\n";
+            qDebug() << "vss mapping action: no-op, time saved ~" << lastFullVssMappingApplyMs << "ms";
+
+            updateSupportedVssFile(addedVssMappingList, deleteVssMappingList);
+            finishVssMappingDeployment(vssMappingInfo2Client);
+            vssMappingMutex.unlock();
+            return true;
+        }
+
         // Create vss.json based on the overlay
         if (!GenerateVssJson(vssMappingInfo2Client))
         {
@@ -846,8 +908,8 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
             return false;
         }
 
-        // Create vehicle model
-        if (!GenerateVehicleModel(vssMappingInfo2Client))
+        // Create vehicle model. The model only depends on the vss api set and its metadata.
+        if ((action == VssMappingDiff::ActionRestartDatabroker) && !GenerateVehicleModel(vssMappingInfo2Client))
         {
             vssMappingMutex.unlock();
             return false;
@@ -935,7 +997,15 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
         // s1: stop all dapr digital.auto apps and the apps based on velocitas
         // s2: stop vehicledatabroker on vcu
         // s3: Send cmd to stop kuksa-feeder on zonecontroller
-        StopRuntimeEnv();
+        // a feeder reload keeps the apps and vehicledatabroker running and only does s3.
+        if (action == VssMappingDiff::ActionRestartDatabroker)
+        {
+            StopRuntimeEnv();
+        }
+        else
+        {
+            StopKuksaFeeder();
+        }
 
         // s4: update EcuList.json
         {
@@ -985,64 +1055,72 @@ bool MessageToKitHandler::VssMappingHandler(message::ptr const &data, QString &v
         // start vehicle runtime
         // s5: start vehicledatabroker on vcu
         // s6: Send cmd to start kuksa-feeder startup script on zonecontroller
-        StartRunTimeEnv();
+        if (action == VssMappingDiff::ActionRestartDatabroker)
+        {
+            StartRunTimeEnv();
+            lastFullVssMappingApplyMs = applyTimer.elapsed();
+            qDebug() << "vss mapping action: databroker restart took" << lastFullVssMappingApplyMs << "ms";
+        }
+        else
+        {
+            StartKuksaFeeder();
+            qint64 elapsedMs = applyTimer.elapsed();
+            qDebug() << "vss mapping action: feeder reload took" << elapsedMs << "ms, time saved ~"
+                     << qMax<qint64>(0, lastFullVssMappingApplyMs - elapsedMs) << "ms";
+            vssMappingInfo2Client += "Only kuksa feeder is reloaded, vehicledatabroker is kept running.\n";
+        }
 
         // s7: update std::string DK_SUPPORTED_VSS_FILE = (DK_PROTOTYPES_FOLDER + "supportedvssapi.json");
+        updateSupportedVssFile(addedVssMappingList, deleteVssMappingList);
+
+        // note: during the deployment of new mapping, if there is any error at any step, the system shall report to web client -> done
+    }
+
+    finishVssMappingDeployment(vssMappingInfo2Client);
+
+    vssMappingMutex.unlock();
+    return true;
+}
+
+void MessageToKitHandler::updateSupportedVssFile(const QStringList &addedVssMappingList, const QStringList &deleteVssMappingList)
+{
+    QFile file1(QString::fromStdString(DK_SUPPORTED_VSS_FILE));
+    file1.open(QIODevice::ReadWrite | QIODevice::Text);
+    if (file1.isOpen())
+    {
+        QString data = QString(file1.readAll());
+        QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
+        QJsonArray jsonArray = doc.array();
+
+        // add new vss mapping to supported list
+        for (int i = 0; i < addedVssMappingList.size(); i++)
         {
-            QFile file1(QString::fromStdString(DK_SUPPORTED_VSS_FILE));
-            file1.open(QIODevice::ReadWrite | QIODevice::Text);
-            if (file1.isOpen())
+            if (!data.contains(addedVssMappingList[i]))
             {
-                QString data = QString(file1.readAll());
-                QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
-                QJsonArray jsonArray = doc.array();
-                //                qDebug() << __func__ << __LINE__ <<  " - jsonArray DK_SUPPORTED_VSS_FILE : " << jsonArray;
-
-                // add new vss mapping to supported list
-                for (int i = 0; i < addedVssMappingList.size(); i++)
-                {
-                    if (!data.contains(addedVssMappingList[i]))
-                    {
-                        jsonArray.append(addedVssMappingList[i]);
-                        qDebug() << __func__ << __LINE__ << " - append DK_SUPPORTED_VSS_FILE : " << addedVssMappingList[i];
-                    }
-                }
+                jsonArray.append(addedVssMappingList[i]);
+                qDebug() << __func__ << __LINE__ << " - append DK_SUPPORTED_VSS_FILE : " << addedVssMappingList[i];
+            }
+        }
 
-                // remove deleted vss mapping from supported list
-                for (int i = 0; i < deleteVssMappingList.size(); i++)
+        // remove deleted vss mapping from supported list
+        for (int i = 0; i < deleteVssMappingList.size(); i++)
+        {
+            for (int j = 0; j < jsonArray.count(); j++)
+            {
+                if (jsonArray[j].toString() == deleteVssMappingList[i])
                 {
-                    for (int j = 0; j < jsonArray.count(); j++)
-                    {
-                        if (jsonArray[j].toString() == deleteVssMappingList[i])
-                        {
-                            jsonArray.removeAt(j);
-                            qDebug() << __func__ << __LINE__ << " - remove DK_SUPPORTED_VSS_FILE : " << deleteVssMappingList[i];
-                            break;
-                        }
-                    }
+                    jsonArray.removeAt(j);
+                    qDebug() << __func__ << __LINE__ << " - remove DK_SUPPORTED_VSS_FILE : " << deleteVssMappingList[i];
+                    break;
                 }
-                //                qDebug() << __func__ << __LINE__ <<  " - after append DK_SUPPORTED_VSS_FILE : " << jsonArray;
-                QJsonDocument newDoc(jsonArray);
-                file1.resize(0);
-                file1.write(newDoc.toJson());
             }
-            file1.flush();
-            file1.close();
         }
-
-        // note: during the deployment of new mapping, if there is any error at any step, the system shall report to web client -> done
+        QJsonDocument newDoc(jsonArray);
+        file1.resize(0);
+        file1.write(newDoc.toJson());
     }
-
-    vssMappingInfo2Client += "Vss Mapping is deployed successfully !!!\n";
-
-    qDebug() << "Vss Mapping is deployed successfully !!!";
-
-    // make sure data is written to files.
-    system("sync");
-    QThread::msleep(50);
-
-    vssMappingMutex.unlock();
-    return true;
+    file1.flush();
+    file1.close();
 }
 
 bool MessageToKitHandler::GenerateVehicleModel(QString &vssMappingInfo2Client)
@@ -1155,19 +1233,24 @@ void MessageToKitHandler::StartVehicleDatabroker()
     QThread::sleep(3);
 }
 
+bool MessageToKitHandler::IsVehicleDatabrokerRunning()
+{
+    std::string cmd = "docker inspect --format '{{json .State.Running}}' vehicledatabroker";
+    std::string ret = CommonUtils::runLinuxCommand(cmd.c_str());
+    QString databrokerStatus = QString::fromStdString(ret);
+    databrokerStatus.remove(QChar::Null);
+    databrokerStatus.replace("\n", "");
+    qDebug() << "------ vehicledatabroker status : " << databrokerStatus;
+    return databrokerStatus == "true";
+}
+
 void MessageToKitHandler::StartKuksaFeeder()
 {
 #if 1
     if (m_orchestrator)
     {
         // check vehicledatabroker status before start kuksa feeder
-        std::string cmd = "docker inspect --format '{{json .State.Running}}' vehicledatabroker";
-        std::string ret = CommonUtils::runLinuxCommand(cmd.c_str());
-        QString databrokerStatus = QString::fromStdString(ret);
-        databrokerStatus.remove(QChar::Null);
-        databrokerStatus.replace("\n", "");
-        qDebug() << "------ vehicledatabroker status : " << databrokerStatus;
-        if (databrokerStatus == "true")
+        if (IsVehicleDatabrokerRunning())
         {
             qDebug() << "------ Send cmd to start kuksa-feeder startup script on zonecontroller";
             m_orchestrator->SendCmd("zonecontroller", "start_kuksa_feeder_script");
@@ -1292,7 +1375,7 @@ void MessageToKitHandler::ExecuteCmd(message::ptr const &data)
         message::ptr Obj = object_message::create();
         Obj->get_map()["request_from"] = string_message::create(request_from);
         Obj->get_map()["cmd"] = string_message::create(command);
-        Obj->get_map()["result"] = string_message::create(output.toStdString());
+        PayloadCodec::SetField(Obj, "result", output.toStdString());
         m_io->socket()->emit("messageToKit-kitReply", Obj);
     }
 }
@@ -1401,7 +1484,8 @@ void MessageToKitHandler::updateSupportedApiList2Server()
     obj->get_map()["kit_id"] = string_message::create(serialNo.toStdString());
     obj->get_map()["name"] = string_message::create(serialNo.toStdString());
     obj->get_map()["support_apis"] = string_message::create(supportAPIs.toStdString());
-    m_io->socket()->emit("register_kit", obj);
+    obj->get_map()["support_compression"] = PayloadCodec::SupportedCodecs();
+    m_io->socket()->emit("register_kit", obj, &PayloadCodec::OnRegisterAck);
 }
 
 void MessageToKitHandler::run()
@@ -1457,7 +1541,7 @@ void MessageToKitHandler::run()
             Obj->get_map()["request_from"] = string_message::create(request_from);
             Obj->get_map()["cmd"] = string_message::create("vss_mapping_factory_reset_result");
             Obj->get_map()["result"] = bool_message::create(ret);
-            Obj->get_map()["log"] = string_message::create(vssMappingInfo2Client.toStdString());
+            PayloadCodec::SetField(Obj, "log", vssMappingInfo2Client.toStdString());
             m_io->socket()->emit("messageToKit-kitReply", Obj);
 
             updateSupportedApiList2Server();
@@ -1475,7 +1559,7 @@ void MessageToKitHandler::run()
             Obj->get_map()["request_from"] = string_message::create(request_from);
             Obj->get_map()["cmd"] = string_message::create("vss_mapping_result");
             Obj->get_map()["result"] = bool_message::create(ret);
-            Obj->get_map()["log"] = string_message::create(vssMappingInfo2Client.toStdString());
+            PayloadCodec::SetField(Obj, "log", vssMappingInfo2Client.toStdString());
             m_io->socket()->emit("messageToKit-kitReply", Obj);
 
             updateSupportedApiList2Server();
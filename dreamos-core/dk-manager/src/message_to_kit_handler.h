@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QThread>
 #include <QTimer>
+#include <QStringList>
 #include <sio_client.h>
 #include "vcuorchestrator.hpp"
 #include "prototype_utils.h"
@@ -43,6 +44,7 @@ private:
     void StartRunTimeEnv();
     void StartVehicleDatabroker();
     void StartKuksaFeeder();
+    bool IsVehicleDatabrokerRunning();
 
     bool GenerateVssJson(QString &vssMappingInfo2Client);
     bool GenerateVehicleModel(QString &vssMappingInfo2Client);
@@ -50,6 +52,7 @@ private:
     void SetSupportAPIs(message::ptr const &data);
 
     void updateSupportedApiList2Server();
+    void updateSupportedVssFile(const QStringList &addedVssMappingList, const QStringList &deleteVssMappingList);
 
     message::ptr m_data;
     client *m_io;
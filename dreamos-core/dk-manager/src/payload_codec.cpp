@@ -0,0 +1,231 @@
+#include "payload_codec.h"
+#include <QFile>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <atomic>
+#include <ctime>
+#include <zlib.h>
+#ifdef DK_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+    std::atomic<int> negotiatedCodec(PayloadCodec::CodecNone);
+
+    // below this size the CPU cost is not worth the few bytes saved
+    size_t minCompressSize()
+    {
+        // read once; the sio threads call this concurrently
+        static const size_t minSize = []
+        {
+            bool ok = false;
+            int envSize = qEnvironmentVariableIntValue("DK_COMPRESSION_MIN_SIZE", &ok);
+            return (ok && envSize > 0) ? static_cast<size_t>(envSize) : size_t(4096);
+        }();
+        return minSize;
+    }
+
+    PayloadCodec::Codec codecFromName(std::string const &name)
+    {
+        if (name == "deflate")
+        {
+            return PayloadCodec::CodecDeflate;
+        }
+#ifdef DK_HAVE_ZSTD
+        if (name == "zstd")
+        {
+            return PayloadCodec::CodecZstd;
+        }
+#endif
+        return PayloadCodec::CodecNone;
+    }
+}
+
+message::ptr PayloadCodec::SupportedCodecs()
+{
+    // preferred codec first
+    message::ptr list = array_message::create();
+#ifdef DK_HAVE_ZSTD
+    list->get_vector().push_back(string_message::create("zstd"));
+#endif
+    list->get_vector().push_back(string_message::create("deflate"));
+    return list;
+}
+
+void PayloadCodec::OnRegisterAck(message::list const &ack)
+{
+    Codec codec = CodecNone;
+    if (ack.size() > 0 && ack[0] && ack[0]->get_flag() == message::flag_object)
+    {
+        message::ptr selected = ack[0]->get_map()["compression"];
+        if (selected && selected->get_flag() == message::flag_string)
+        {
+            codec = codecFromName(selected->get_string());
+        }
+    }
+    negotiatedCodec.store(codec);
+    qDebug() << __func__ << __LINE__ << " : negotiated compression = " << QString::fromStdString(CodecName(codec));
+}
+
+void PayloadCodec::ResetNegotiation()
+{
+    negotiatedCodec.store(CodecNone);
+}
+
+PayloadCodec::Codec PayloadCodec::Negotiated()
+{
+    return static_cast<Codec>(negotiatedCodec.load());
+}
+
+std::string PayloadCodec::CodecName(Codec codec)
+{
+    switch (codec)
+    {
+    case CodecDeflate:
+        return "deflate";
+    case CodecZstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+void PayloadCodec::SetField(message::ptr const &obj, std::string const &key, std::string const &value)
+{
+    Codec codec = Negotiated();
+    if (codec != CodecNone && value.size() >= minCompressSize())
+    {
+        std::shared_ptr<std::string> encoded = std::make_shared<std::string>();
+        // only send compressed when it saves at least 10%
+        if (Encode(codec, value, *encoded) && encoded->size() < value.size() - value.size() / 10)
+        {
+            obj->get_map()[key] = binary_message::create(encoded);
+            obj->get_map()[key + "_encoding"] = string_message::create(CodecName(codec));
+            obj->get_map()[key + "_size"] = int_message::create(static_cast<int64_t>(value.size()));
+            return;
+        }
+    }
+    obj->get_map()[key] = string_message::create(value);
+}
+
+bool PayloadCodec::Encode(Codec codec, std::string const &in, std::string &out)
+{
+    if (codec == CodecDeflate)
+    {
+        uLongf outSize = compressBound(static_cast<uLong>(in.size()));
+        out.resize(outSize);
+        int ret = compress2(reinterpret_cast<Bytef *>(&out[0]), &outSize,
+                            reinterpret_cast<const Bytef *>(in.data()), static_cast<uLong>(in.size()), 6);
+        if (ret != Z_OK)
+        {
+            qDebug() << __func__ << __LINE__ << " : deflate failed: " << ret;
+            return false;
+        }
+        out.resize(outSize);
+        return true;
+    }
+#ifdef DK_HAVE_ZSTD
+    if (codec == CodecZstd)
+    {
+        out.resize(ZSTD_compressBound(in.size()));
+        size_t ret = ZSTD_compress(&out[0], out.size(), in.data(), in.size(), 3);
+        if (ZSTD_isError(ret))
+        {
+            qDebug() << __func__ << __LINE__ << " : zstd failed: " << ZSTD_getErrorName(ret);
+            return false;
+        }
+        out.resize(ret);
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool PayloadCodec::Decode(Codec codec, std::string const &in, size_t rawSize, std::string &out)
+{
+    out.resize(rawSize);
+    if (codec == CodecDeflate)
+    {
+        uLongf outSize = static_cast<uLongf>(rawSize);
+        int ret = uncompress(reinterpret_cast<Bytef *>(&out[0]), &outSize,
+                             reinterpret_cast<const Bytef *>(in.data()), static_cast<uLong>(in.size()));
+        return (ret == Z_OK) && (outSize == rawSize);
+    }
+#ifdef DK_HAVE_ZSTD
+    if (codec == CodecZstd)
+    {
+        size_t ret = ZSTD_decompress(&out[0], out.size(), in.data(), in.size());
+        return !ZSTD_isError(ret) && (ret == rawSize);
+    }
+#endif
+    return false;
+}
+
+void PayloadCodec::RunBenchmark(QStringList const &files)
+{
+    QList<Codec> codecs;
+    codecs.append(CodecDeflate);
+#ifdef DK_HAVE_ZSTD
+    codecs.append(CodecZstd);
+#endif
+
+    for (const QString &path : files)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qDebug() << __func__ << __LINE__ << path << file.errorString();
+            continue;
+        }
+        QByteArray content = file.readAll();
+        file.close();
+        std::string raw(content.constData(), content.size());
+        if (raw.empty())
+        {
+            continue;
+        }
+
+        // run each codec over ~32 MB of input so the timer resolution does not matter
+        int iterations = static_cast<int>(qMax<size_t>(1, (32u * 1024 * 1024) / raw.size()));
+        for (Codec codec : codecs)
+        {
+            std::string encoded;
+            std::string decoded;
+
+            std::clock_t cpuStart = std::clock();
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < iterations; i++)
+            {
+                Encode(codec, raw, encoded);
+            }
+            qint64 encodeNs = timer.nsecsElapsed();
+            double encodeCpuUs = 1e6 * (std::clock() - cpuStart) / CLOCKS_PER_SEC / iterations;
+
+            cpuStart = std::clock();
+            timer.restart();
+            bool roundTripOk = true;
+            for (int i = 0; i < iterations; i++)
+            {
+                roundTripOk &= Decode(codec, encoded, raw.size(), decoded);
+            }
+            qint64 decodeNs = timer.nsecsElapsed();
+            double decodeCpuUs = 1e6 * (std::clock() - cpuStart) / CLOCKS_PER_SEC / iterations;
+            roundTripOk &= (decoded == raw);
+
+            qDebug().noquote() << QString("%1 [%2] raw=%3 B encoded=%4 B saved=%5% encode=%6 us (cpu %7 us, %8 MB/s) decode=%9 us (cpu %10 us) roundtrip=%11")
+                                      .arg(path)
+                                      .arg(QString::fromStdString(CodecName(codec)))
+                                      .arg(raw.size())
+                                      .arg(encoded.size())
+                                      .arg(100.0 * (1.0 - double(encoded.size()) / raw.size()), 0, 'f', 1)
+                                      .arg(encodeNs / 1000.0 / iterations, 0, 'f', 1)
+                                      .arg(encodeCpuUs, 0, 'f', 1)
+                                      .arg((double(raw.size()) * iterations / (1024.0 * 1024.0)) / (encodeNs / 1e9), 0, 'f', 1)
+                                      .arg(decodeNs / 1000.0 / iterations, 0, 'f', 1)
+                                      .arg(decodeCpuUs, 0, 'f', 1)
+                                      .arg(roundTripOk ? "ok" : "FAILED");
+        }
+    }
+}
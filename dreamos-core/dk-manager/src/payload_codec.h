@@ -0,0 +1,41 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <QObject>
+#include <QStringList>
+#include <sio_client.h>
+
+using namespace sio;
+
+// Optional compression of large reply fields (prototype list, logs, ExecuteCmd output,
+// supported api list). The kit advertises its codecs in "register_kit", the server
+// picks one in the ack. Until then, or for small payloads, fields stay plain strings.
+// "register_kit" itself is always plain, since it is what (re)negotiates the codec.
+class PayloadCodec
+{
+public:
+    enum Codec
+    {
+        CodecNone = 0,
+        CodecDeflate = 1,
+        CodecZstd = 2
+    };
+
+    static message::ptr SupportedCodecs();
+    static void OnRegisterAck(message::list const &ack);
+    static void ResetNegotiation();
+    static Codec Negotiated();
+    static std::string CodecName(Codec codec);
+
+    // Put value into obj[key], as binary attachment when it is worth compressing.
+    // A compressed field is described by "<key>_encoding" and "<key>_size".
+    static void SetField(message::ptr const &obj, std::string const &key, std::string const &value);
+
+    static bool Encode(Codec codec, std::string const &in, std::string &out);
+    static bool Decode(Codec codec, std::string const &in, size_t rawSize, std::string &out);
+
+    // Print CPU cost vs. bytes saved for every codec over the given files.
+    static void RunBenchmark(QStringList const &files);
+};
+
+#endif // PAYLOAD_CODEC_H
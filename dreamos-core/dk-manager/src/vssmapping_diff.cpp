@@ -0,0 +1,149 @@
+#include "vssmapping_diff.h"
+#include <QDebug>
+
+VssMappingDiff::VssMappingDiff()
+    : m_action(ActionRestartDatabroker), m_feederInputsChanged(false), m_databrokerRunning(false)
+{
+}
+
+QMap<QString, Vss_Overlay_Entry> VssMappingDiff::ParseOverlay(const QString &overlayContent)
+{
+    // overlay entries are written by VssMappingHandler as:
+    // Vehicle.A.B:
+    //   datatype: <dataType>
+    //   type: <vssType>
+    //   description: T.B.D
+    //   <mappingType>:
+    //     signal: <canSignal>
+    QMap<QString, Vss_Overlay_Entry> entries;
+    QString currentVss;
+    Vss_Overlay_Entry current;
+
+    const QStringList lines = overlayContent.split('\n');
+    for (const QString &line : lines)
+    {
+        if (line.trimmed().isEmpty())
+        {
+            continue;
+        }
+        if (!line.startsWith(' '))
+        {
+            if (!currentVss.isEmpty() && current.vssType != "branch")
+            {
+                entries.insert(currentVss, current);
+            }
+            currentVss = line.trimmed();
+            currentVss.chop(1); // remove ':'
+            current = Vss_Overlay_Entry();
+            continue;
+        }
+
+        QString attr = line.trimmed();
+        if (line.startsWith("    signal:"))
+        {
+            current.canSignal = attr.mid(QString("signal:").length()).trimmed();
+        }
+        else if (attr.startsWith("datatype:"))
+        {
+            current.dataType = attr.mid(QString("datatype:").length()).trimmed();
+        }
+        else if (attr.startsWith("type:"))
+        {
+            current.vssType = attr.mid(QString("type:").length()).trimmed();
+        }
+        else if (attr.endsWith(':'))
+        {
+            current.mappingType = attr.left(attr.length() - 1);
+        }
+    }
+    if (!currentVss.isEmpty() && current.vssType != "branch")
+    {
+        entries.insert(currentVss, current);
+    }
+
+    return entries;
+}
+
+QString VssMappingDiff::ActionName(Action action)
+{
+    switch (action)
+    {
+    case ActionNone:
+        return "no-op";
+    case ActionReloadFeeder:
+        return "feeder reload";
+    default:
+        return "databroker restart";
+    }
+}
+
+void VssMappingDiff::Compute(const QString &prevOverlay, const QString &newOverlay, bool feederInputsChanged, bool databrokerRunning)
+{
+    added.clear();
+    removed.clear();
+    metadataChanged.clear();
+    mappingChanged.clear();
+    m_feederInputsChanged = feederInputsChanged;
+    m_databrokerRunning = databrokerRunning;
+
+    QMap<QString, Vss_Overlay_Entry> prevEntries = ParseOverlay(prevOverlay);
+    QMap<QString, Vss_Overlay_Entry> newEntries = ParseOverlay(newOverlay);
+
+    for (auto it = newEntries.constBegin(); it != newEntries.constEnd(); ++it)
+    {
+        auto prev = prevEntries.constFind(it.key());
+        if (prev == prevEntries.constEnd())
+        {
+            added.append(it.key());
+            continue;
+        }
+        if ((prev->dataType != it->dataType) || (prev->vssType != it->vssType))
+        {
+            metadataChanged.append(it.key());
+        }
+        else if ((prev->mappingType != it->mappingType) || (prev->canSignal != it->canSignal))
+        {
+            mappingChanged.append(it.key());
+        }
+    }
+    for (auto it = prevEntries.constBegin(); it != prevEntries.constEnd(); ++it)
+    {
+        if (!newEntries.contains(it.key()))
+        {
+            removed.append(it.key());
+        }
+    }
+
+    if (!m_databrokerRunning || !added.isEmpty() || !removed.isEmpty() || !metadataChanged.isEmpty())
+    {
+        m_action = ActionRestartDatabroker;
+    }
+    else if (!mappingChanged.isEmpty() || m_feederInputsChanged)
+    {
+        m_action = ActionReloadFeeder;
+    }
+    else
+    {
+        m_action = ActionNone;
+    }
+}
+
+VssMappingDiff::Action VssMappingDiff::GetAction() const
+{
+    return m_action;
+}
+
+QString VssMappingDiff::Summary() const
+{
+    QString s = "vss mapping diff -> " + ActionName(m_action) + ":";
+    s += " added=" + QString::number(added.size());
+    s += " removed=" + QString::number(removed.size());
+    s += " metadata changed=" + QString::number(metadataChanged.size());
+    s += " mapping changed=" + QString::number(mappingChanged.size());
+    s += " feeder inputs changed=" + QString(m_feederInputsChanged ? "yes" : "no");
+    if (!m_databrokerRunning)
+    {
+        s += " (vehicledatabroker is not running)";
+    }
+    return s;
+}
@@ -0,0 +1,52 @@
+#ifndef VSSMAPPING_DIFF_H
+#define VSSMAPPING_DIFF_H
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+
+typedef struct
+{
+    QString dataType;
+    QString vssType;
+    QString mappingType;
+    QString canSignal;
+} Vss_Overlay_Entry;
+
+// Structured diff between the previous and the new vss mapping overlay.
+// It decides the minimal runtime action needed to apply the new mapping:
+// - ActionNone: nothing the runtime consumes has changed.
+// - ActionReloadFeeder: only CAN side changed (signal, dbc, channels, default values),
+//   the vehicle databroker keeps running and only kuksa feeder is restarted.
+// - ActionRestartDatabroker: vss api set or its metadata changed, the databroker has to
+//   load a new vss.json and everything is restarted as before.
+class VssMappingDiff
+{
+public:
+    enum Action
+    {
+        ActionNone = 0,
+        ActionReloadFeeder,
+        ActionRestartDatabroker
+    };
+
+    VssMappingDiff();
+    static QMap<QString, Vss_Overlay_Entry> ParseOverlay(const QString &overlayContent);
+    static QString ActionName(Action action);
+
+    void Compute(const QString &prevOverlay, const QString &newOverlay, bool feederInputsChanged, bool databrokerRunning);
+    Action GetAction() const;
+    QString Summary() const;
+
+    QStringList added;
+    QStringList removed;
+    QStringList metadataChanged;
+    QStringList mappingChanged;
+
+private:
+    Action m_action;
+    bool m_feederInputsChanged;
+    bool m_databrokerRunning;
+};
+
+#endif // VSSMAPPING_DIFF_H